@@ -2,6 +2,9 @@
 #define ADMIN_API_H
 
 #include "crow.h"
+#include "hospital_app.h"
+#include "db_route.h"
+#include "request_parser.h"
 // #include "user.h"
 // #include "doctor.h"
 // #include "appointment.h"
@@ -9,24 +12,65 @@
 // #include "record.h"
 // #include "report.h"
 #include "admin.h"
+#include "database_handler.h"
+#include "statistics.h"
+#include "analytics.h"
+#include "data_exporter.h"
+#include "admission_control.h"
+#include "query_budget.h"
+#include "single_flight.h"
+#include "change_feed.h"
+#include "entity_ref.h"
+#include "response_compression.h"
+#include "backup_manager.h"
+#include "archive_manager.h"
+#include "coalesced_response.h"
 
-void registerAdminRoutes(crow::SimpleApp& app){
+inline crow::json::wvalue backupStatusJson(const BackupStatus& status) {
+    crow::json::wvalue result;
+    result["in_progress"] = status.inProgress;
+    result["path"] = status.path;
+    result["pages_total"] = status.pagesTotal;
+    result["pages_remaining"] = status.pagesRemaining;
+    result["steps"] = status.steps;
+    result["started_at"] = static_cast<int64_t>(status.startedAt);
+    result["finished_at"] = static_cast<int64_t>(status.finishedAt);
+    result["last_error"] = status.lastError;
+    result["completed"] = status.completed;
+    result["failed"] = status.failed;
+    return result;
+}
+
+inline crow::json::wvalue archiveStatusJson(const ArchiveStatus& status) {
+    crow::json::wvalue result;
+    result["in_progress"] = status.inProgress;
+    result["archived_before"] = status.archivedBefore;
+    result["years"] = crow::json::wvalue::list();
+    for (size_t i = 0; i < status.years.size(); i++) {
+        result["years"][i] = status.years[i];
+    }
+    result["appointments_moved"] = status.appointmentsMoved;
+    result["records_moved"] = status.recordsMoved;
+    result["runs"] = status.runs;
+    result["last_run_at"] = static_cast<int64_t>(status.lastRunAt);
+    result["last_error"] = status.lastError;
+    return result;
+}
+
+void registerAdminRoutes(HospitalApp& app){
 
 
 CROW_ROUTE(app, "/admin/generate-report")
-        .methods("POST"_method)([](const crow::request& req){
-            auto json = crow::json::load(req.body);
-            if (!json) {
-                return crow::response(400, "Invalid JSON");
+        .methods("POST"_method)(onDbExecutor([](const crow::request& req){
+            ReportGenerationRequest body;
+            std::string error;
+            if (!parseRequest(req.body, body, error)) {
+                return crow::response(400, error);
             }
 
             try {
-                std::string reportType = json["report_type"].s();
-                std::string startDate = json["start_date"].s();
-                std::string endDate = json["end_date"].s();
-
                 Admin admin(0, "", "", 0); // Dummy admin for demonstration
-                auto reports = admin.generateReports(reportType, startDate, endDate);
+                auto reports = admin.generateReports(body.reportType, body.startDate, body.endDate);
                 
                 crow::json::wvalue result;
                 for (size_t i = 0; i < reports.size(); i++) {
@@ -37,6 +81,248 @@ CROW_ROUTE(app, "/admin/generate-report")
             } catch (const std::exception& e) {
                 return crow::response(500, e.what());
             }
+        }));
+
+CROW_ROUTE(app, "/admin/statistics")
+        .methods("GET"_method)(onDbExecutor([](){
+            try {
+                crow::json::wvalue result;
+                for (const auto& [status, count] : Statistics::getAppointmentStatusCounts()) {
+                    result["appointments_by_status"][status] = count;
+                }
+                int i = 0;
+                for (const auto& [doctorID, count] : Statistics::getRecordCountsByDoctor()) {
+                    result["records_by_doctor"][i]["doctor_id"] = doctorID;
+                    result["records_by_doctor"][i]["record_count"] = count;
+                    i++;
+                }
+                auto res = crow::response{result};
+                add_cors_headers(res);
+                return res;
+            } catch (const std::exception& e) {
+                return crow::response(500, e.what());
+            }
+        }));
+
+// Served from the columnar snapshot, never from the live tables
+CROW_ROUTE(app, "/admin/analytics/<string>")
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req, const std::string& report){
+            std::string startDate = req.url_params.get("start_date") ? req.url_params.get("start_date") : "";
+            std::string endDate = req.url_params.get("end_date") ? req.url_params.get("end_date") : "";
+
+            try {
+                AnalyticsEngine& engine = AnalyticsEngine::getInstance();
+                ResponseBody result;
+
+                if (report == "utilization") {
+                    auto rows = engine.utilizationByDoctor(startDate, endDate);
+                    for (size_t i = 0; i < rows.size(); i++) {
+                        int64_t total = rows[i].scheduled + rows[i].completed + rows[i].cancelled;
+                        result["doctors"][i]["doctor_id"] = rows[i].doctorID;
+                        result["doctors"][i]["doctor_name"] = rows[i].name;
+                        result["doctors"][i]["specialization"] = rows[i].specialization;
+                        result["doctors"][i]["appointments"] = total;
+                        result["doctors"][i]["scheduled"] = rows[i].scheduled;
+                        result["doctors"][i]["completed"] = rows[i].completed;
+                        result["doctors"][i]["cancelled"] = rows[i].cancelled;
+                        result["doctors"][i]["cancellation_rate"] = total ? double(rows[i].cancelled) / total : 0.0;
+                        result["doctors"][i]["active_days"] = rows[i].activeDays;
+                        result["doctors"][i]["appointments_per_day"] =
+                            rows[i].activeDays ? double(total) / rows[i].activeDays : 0.0;
+                        result["doctors"][i]["records"] = rows[i].records;
+                    }
+                } else if (report == "monthly-volume") {
+                    auto rows = engine.monthlyVolume(startDate, endDate);
+                    for (size_t i = 0; i < rows.size(); i++) {
+                        result["months"][i]["month"] = std::to_string(rows[i].month / 100) + "-" +
+                                                       (rows[i].month % 100 < 10 ? "0" : "") +
+                                                       std::to_string(rows[i].month % 100);
+                        result["months"][i]["appointments"] = rows[i].appointments;
+                        result["months"][i]["records"] = rows[i].records;
+                        result["months"][i]["prescriptions"] = rows[i].prescriptions;
+                    }
+                } else if (report == "cancellations") {
+                    auto rows = engine.cancellationsByMonth(startDate, endDate);
+                    for (size_t i = 0; i < rows.size(); i++) {
+                        result["months"][i]["month"] = std::to_string(rows[i].month / 100) + "-" +
+                                                       (rows[i].month % 100 < 10 ? "0" : "") +
+                                                       std::to_string(rows[i].month % 100);
+                        result["months"][i]["appointments"] = rows[i].appointments;
+                        result["months"][i]["cancelled"] = rows[i].cancelled;
+                        result["months"][i]["cancellation_rate"] = double(rows[i].cancelled) / rows[i].appointments;
+                    }
+                } else {
+                    return crow::response(400, "Invalid analytics report");
+                }
+
+                result["snapshot_refreshed_at"] = static_cast<int64_t>(engine.getSnapshot()->refreshedAt);
+                auto res = encodedResponse(req, result);
+                add_cors_headers(res);
+                return res;
+            } catch (const std::invalid_argument& e) {
+                return crow::response(400, e.what());
+            } catch (const std::exception& e) {
+                return crow::response(503, e.what());
+            }
+        }));
+
+CROW_ROUTE(app, "/admin/export/<string>")
+        .methods("GET"_method)(onDbExecutor([&app](const crow::request& req, const std::string& table){
+            if (!DataExporter::isExportableTable(table)) {
+                return crow::response(404, "Unknown export table");
+            }
+
+            DataExporter::Format format;
+            if (!DataExporter::parseFormat(req.url_params.get("format") ? req.url_params.get("format") : "", format)) {
+                return crow::response(400, "Invalid export format");
+            }
+            std::string startDate = req.url_params.get("start_date") ? req.url_params.get("start_date") : "";
+            std::string endDate = req.url_params.get("end_date") ? req.url_params.get("end_date") : "";
+
+            // the export's statements run under the export budget rather
+            // than the Bulk one, which would stop most large exports
+            QueryBudget::BudgetPtr budget = QueryBudget::getInstance().exportBudget();
+            try {
+                std::shared_ptr<ExportFile> file;
+                {
+                    QueryBudget::Scope exportScope(budget);
+                    file = DataExporter::exportTable(table, format, startDate, endDate);
+                }
+
+                // Crow streams static files from disk in chunks instead of
+                // holding the body in memory; the spool is removed once the
+                // context lets go of it after the write
+                crow::response res;
+                res.set_static_file_info(file->getPath());
+                app.get_context<StaticFilesMiddleware>(req).servedFile = file;
+                res.set_header("Content-Type", DataExporter::contentType(format));
+                res.set_header("Content-Disposition", "attachment; filename=\"" + table +
+                               (format == DataExporter::Format::CSV ? ".csv" : ".ndjson") + "\"");
+                add_cors_headers(res);
+                return res;
+            } catch (const std::invalid_argument& e) {
+                return crow::response(400, e.what());
+            } catch (const std::exception& e) {
+                if (budget->interrupted) {
+                    return db_route_detail::exportBudgetExceeded();
+                }
+                return crow::response(500, e.what());
+            }
+        }));
+
+CROW_ROUTE(app, "/admin/statistics/rebuild")
+        .methods("POST"_method)(onDbExecutor([](){
+            try {
+                Statistics::rebuild();
+                return crow::response(200, "Statistics rebuilt successfully");
+            } catch (const std::exception& e) {
+                return crow::response(500, e.what());
+            }
+        }));
+
+// Starts an online backup on the backup thread and returns at once; poll
+// GET /admin/backup for progress
+CROW_ROUTE(app, "/admin/backup")
+        .methods("POST"_method)([](){
+            BackupManager& backups = BackupManager::getInstance();
+            if (!backups.requestBackup()) {
+                auto res = crow::response(409, "A backup is already in progress");
+                add_cors_headers(res);
+                return res;
+            }
+            auto res = crow::response{202, backupStatusJson(backups.getStatus())};
+            add_cors_headers(res);
+            return res;
+        });
+
+CROW_ROUTE(app, "/admin/backup")
+        .methods("GET"_method)([](){
+            auto res = crow::response{backupStatusJson(BackupManager::getInstance().getStatus())};
+            add_cors_headers(res);
+            return res;
+        });
+
+// Starts an archival run on the archive thread and returns at once; poll
+// GET /admin/archive for progress
+CROW_ROUTE(app, "/admin/archive")
+        .methods("POST"_method)([](){
+            ArchiveManager& archives = ArchiveManager::getInstance();
+            if (!archives.requestArchival()) {
+                auto res = crow::response(409, archives.getSettings().horizonDays > 0
+                                                   ? "An archival run is already in progress"
+                                                   : "Archival is disabled (HOSPX_ARCHIVE_HORIZON_DAYS)");
+                add_cors_headers(res);
+                return res;
+            }
+            auto res = crow::response{202, archiveStatusJson(archives.getStatus())};
+            add_cors_headers(res);
+            return res;
+        });
+
+CROW_ROUTE(app, "/admin/archive")
+        .methods("GET"_method)([](){
+            auto res = crow::response{archiveStatusJson(ArchiveManager::getInstance().getStatus())};
+            add_cors_headers(res);
+            return res;
+        });
+
+CROW_ROUTE(app, "/admin/metrics")
+        .methods("GET"_method)([](){
+            crow::json::wvalue result;
+            for (const auto& m : AdmissionController::getInstance().metrics()) {
+                auto& entry = result["admission"][m.name];
+                entry["max_concurrent"] = m.limits.maxConcurrent;
+                entry["max_queued"] = m.limits.maxQueued;
+                entry["in_flight"] = m.inFlight;
+                entry["queued"] = m.queued;
+                entry["peak_in_flight"] = m.peakInFlight;
+                entry["peak_queued"] = m.peakQueued;
+                entry["admitted"] = m.admitted;
+                entry["rejected_queue_full"] = m.rejectedQueueFull;
+                entry["rejected_timeout"] = m.rejectedTimeout;
+                entry["avg_wait_ms"] = m.averageWaitMillis;
+                entry["avg_service_ms"] = m.averageServiceMillis;
+            }
+            for (const auto& m : QueryBudget::getInstance().metrics()) {
+                auto& entry = result["query_budget"][m.name];
+                entry["budget_ms"] = m.budgetMillis;
+                entry["expired_in_queue"] = m.expiredInQueue;
+                entry["interrupted"] = m.interrupted;
+            }
+            result["coalescing"]["executed"] = SingleFlight::getInstance().executedCount();
+            result["coalescing"]["coalesced"] = SingleFlight::getInstance().coalescedCount();
+            result["change_feed"]["subscribers"] = ChangeFeed::getInstance().subscriberCount();
+            result["change_feed"]["dropped"] = ChangeFeed::getInstance().droppedCount();
+            result["db_executor"]["threads"] = DbExecutor::getInstance().threadCount();
+            result["db_executor"]["busy"] = DbExecutor::getInstance().busyCount();
+            result["db_executor"]["queued"] = DbExecutor::getInstance().queuedCount();
+            CompressionMetrics compression = ResponseCompressor::getInstance().metrics();
+            result["compression"]["compressed"] = compression.compressed;
+            result["compression"]["cache_hits"] = compression.cacheHits;
+            result["compression"]["bytes_in"] = compression.bytesIn;
+            result["compression"]["bytes_out"] = compression.bytesOut;
+            result["compression"]["cached_entries"] = compression.cachedEntries;
+            result["compression"]["cached_bytes"] = compression.cachedBytes;
+            result["compression"]["queued"] = compression.queued;
+            MaintenanceMetrics maintenance = DatabaseHandler::getInstance().getMaintenanceMetrics();
+            result["database"]["wal_bytes"] = maintenance.walBytes;
+            result["database"]["wal_frames"] = maintenance.walFrames;
+            result["database"]["checkpoint_lag_frames"] = maintenance.walFrames - maintenance.checkpointedFrames;
+            result["database"]["passive_checkpoints"] = maintenance.passiveCheckpoints;
+            result["database"]["truncate_checkpoints"] = maintenance.truncateCheckpoints;
+            result["database"]["busy_checkpoints"] = maintenance.busyCheckpoints;
+            result["database"]["last_checkpoint_ms"] = maintenance.lastCheckpointMillis;
+            result["database"]["last_checkpoint_at"] = maintenance.lastCheckpointAt;
+            result["database"]["optimize_runs"] = maintenance.optimizeRuns;
+            result["database"]["vacuum_runs"] = maintenance.vacuumRuns;
+            result["database"]["freelist_pages"] = maintenance.freelistPages;
+            result["entity_cache"]["patient_hits"] = EntityCache<Patient>::getInstance().hitCount();
+            result["entity_cache"]["patient_loads"] = EntityCache<Patient>::getInstance().loadCount();
+            result["entity_cache"]["doctor_hits"] = EntityCache<Doctor>::getInstance().hitCount();
+            result["entity_cache"]["doctor_loads"] = EntityCache<Doctor>::getInstance().loadCount();
+            auto res = crow::response{result};
+            add_cors_headers(res);
+            return res;
         });
 
     }
@@ -2,81 +2,85 @@
 #define APPOINTMENT_API_H
 
 #include "crow.h"
+#include "hospital_app.h"
+#include "db_route.h"
+#include "request_parser.h"
+#include "async_data.h"
+#include "coalesced_response.h"
 // #include "user.h"
 #include "doctor.h"
 // #include "appointment.h"
 #include "patient.h"
 
-void registerAppointmentRoutes(crow::SimpleApp& app){
+void registerAppointmentRoutes(HospitalApp& app){
 
 
         CROW_ROUTE(app, "/appointments")
-        .methods("GET"_method)([](){
-            auto appointments = Appointment::getAllAppointmentsFromDatabase();
-            crow::json::wvalue result;
-            for (size_t i = 0; i < appointments.size(); i++) {
-                result[i]["id"] = appointments[i]->getAppointmentID();
-                result[i]["patient_id"] = appointments[i]->getPatient()->getPatientID();
-                result[i]["patient_name"] = appointments[i]->getPatient()->getName();
-                result[i]["doctor_id"] = appointments[i]->getDoctor()->getDoctorID();
-                result[i]["doctor_name"] = appointments[i]->getDoctor()->getName();
-                result[i]["date"] = appointments[i]->getDate();
-                result[i]["time"] = appointments[i]->getTime();
-                delete appointments[i];
-            }
-            auto res = crow::response{result};
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req){
+            auto res = coalescedJsonResponse(req, []() {
+                auto appointments = Appointment::getAllAppointmentsFromDatabase();
+                ResponseBody result = ResponseBody::list();
+                for (size_t i = 0; i < appointments.size(); i++) {
+                    result[i]["id"] = appointments[i]->getAppointmentID();
+                    result[i]["patient_id"] = appointments[i]->getPatientID();
+                    result[i]["patient_name"] = appointments[i]->getPatient()->getName();
+                    result[i]["doctor_id"] = appointments[i]->getDoctorID();
+                    result[i]["doctor_name"] = appointments[i]->getDoctor()->getName();
+                    result[i]["date"] = appointments[i]->getDate();
+                    result[i]["time"] = appointments[i]->getTime();
+                    delete appointments[i];
+                }
+                return result;
+            });
             add_cors_headers(res);
             return res;
-        });
+        }));
 
         CROW_ROUTE(app, "/appointments")
-        .methods("POST"_method)([](const crow::request& req){
-            auto json = crow::json::load(req.body);
-            if (!json) {
-                return crow::response(400, "Invalid JSON");
+        .methods("POST"_method)(onCoroutine([](const crow::request& req) -> Task<crow::response> {
+            AppointmentRequest body;
+            std::string error;
+            if (!parseRequest(req.body, body, error)) {
+                co_return crow::response(400, error);
             }
 
             try {
-                int patientID = json["patient_id"].i();
-                int doctorID = json["doctor_id"].i();
-                std::string date = json["date"].s();
-                std::string time = json["time"].s();
-
-                Patient* patient = Patient::getPatientFromDatabase(patientID);
-                Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
+                // The two lookups are independent, so run them side by side
+                auto [patient, doctor] = co_await whenAll(AsyncData::loadPatient(body.patientID),
+                                                          AsyncData::loadDoctor(body.doctorID));
 
                 if (!patient || !doctor) {
-                    return crow::response(404, "Patient or Doctor not found");
+                    co_return crow::response(404, "Patient or Doctor not found");
                 }
 
-                Appointment appointment(0, patient, doctor, date, time);
-                if (appointment.saveToDatabase()) {
+                Appointment appointment(0, body.patientID, body.doctorID, body.date, body.time);
+                if (co_await AsyncData::save(appointment)) {
                     crow::json::wvalue result;
                     result["id"] = appointment.getAppointmentID();
-                    return crow::response{result};
+                    co_return crow::response{result};
                 }
                 auto res = crow::response(500, "Failed to save appointment");
                 add_cors_headers(res);
-                return res;
+                co_return res;
             } catch (const std::exception& e) {
                 auto res = crow::response(500, e.what());
                 add_cors_headers(res);
-                return res;
+                co_return res;
             }
-        });
+        }));
 
         CROW_ROUTE(app, "/appointments/<int>")
-        .methods("GET"_method)([](int id){
-            Appointment* appointment = Appointment::getAppointmentFromDatabase(id);
+        .methods("GET"_method)(onDbExecutor([](int id){
+            Appointment* appointment = Appointment::getAppointmentFromDatabase(id, true);
             if (!appointment) {
                 return crow::response(404, "Appointment not found");
             }
             
             crow::json::wvalue result;
             result["id"] = appointment->getAppointmentID();
-            result["patient_id"] = appointment->getPatient()->getPatientID();
+            result["patient_id"] = appointment->getPatientID();
             result["patient_name"] = appointment->getPatient()->getName();
-            result["doctor_id"] = appointment->getDoctor()->getDoctorID();
+            result["doctor_id"] = appointment->getDoctorID();
             result["doctor_name"] = appointment->getDoctor()->getName();
             result["date"] = appointment->getDate();
             result["time"] = appointment->getTime();
@@ -86,13 +90,14 @@ void registerAppointmentRoutes(crow::SimpleApp& app){
             auto res = crow::response{result};
             add_cors_headers(res);
             return res;
-        });
+        }));
 
         CROW_ROUTE(app, "/appointments/<int>")
-        .methods("PUT"_method)([](const crow::request& req, int id){
-            auto json = crow::json::load(req.body);
-            if (!json) {
-                return crow::response(400, "Invalid JSON");
+        .methods("PUT"_method)(onDbExecutor([](const crow::request& req, int id){
+            AppointmentUpdate body;
+            std::string error;
+            if (!parseRequest(req.body, body, error)) {
+                return crow::response(400, error);
             }
 
             try {
@@ -101,11 +106,11 @@ void registerAppointmentRoutes(crow::SimpleApp& app){
                     return crow::response(404, "Appointment not found");
                 }
 
-                if (json.has("date")) {
-                    appointment->setDate(json["date"].s());
+                if (body.date) {
+                    appointment->setDate(*body.date);
                 }
-                if (json.has("time")) {
-                    appointment->setTime(json["time"].s());
+                if (body.time) {
+                    appointment->setTime(*body.time);
                 }
 
                 if (appointment->saveToDatabase()) {
@@ -123,10 +128,10 @@ void registerAppointmentRoutes(crow::SimpleApp& app){
                 add_cors_headers(res);
                 return res;
             }
-        });
+        }));
 
         CROW_ROUTE(app, "/appointments/<int>")
-        .methods("DELETE"_method)([](int id){
+        .methods("DELETE"_method)(onDbExecutor([](int id){
             Appointment* appointment = Appointment::getAppointmentFromDatabase(id);
             if (!appointment) {
                 return crow::response(404, "Appointment not found");
@@ -142,7 +147,7 @@ void registerAppointmentRoutes(crow::SimpleApp& app){
             auto res = crow::response(500, "Failed to delete appointment");
             add_cors_headers(res);
             return res;
-        });
+        }));
 
     }
 
@@ -0,0 +1,76 @@
+#ifndef DASHBOARD_API_H
+#define DASHBOARD_API_H
+
+#include "crow.h"
+#include "hospital_app.h"
+#include "db_route.h"
+#include "dashboard.h"
+#include "coalesced_response.h"
+
+inline void writeDashboardAppointments(ResponseBody& list, const std::vector<DashboardAppointment>& appointments) {
+    for (size_t i = 0; i < appointments.size(); i++) {
+        list[i]["id"] = appointments[i].appointmentID;
+        list[i]["patient_id"] = appointments[i].patientID;
+        list[i]["patient_name"] = appointments[i].patientName;
+        list[i]["doctor_id"] = appointments[i].doctorID;
+        list[i]["doctor_name"] = appointments[i].doctorName;
+        list[i]["date"] = appointments[i].date;
+        list[i]["time"] = appointments[i].time;
+        list[i]["status"] = appointments[i].status;
+    }
+}
+
+void registerDashboardRoutes(HospitalApp& app){
+
+        CROW_ROUTE(app, "/dashboard")
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req){
+            DashboardSummary summary;
+            try {
+                summary = Dashboard::getSummary();
+            } catch (const std::exception& e) {
+                return crow::response(500, e.what());
+            }
+
+            ResponseBody result;
+            result["today"] = summary.today;
+            result["counts"]["patients"] = summary.totalPatients;
+            result["counts"]["doctors"] = summary.totalDoctors;
+            result["counts"]["appointments"] = summary.totalAppointments;
+            result["counts"]["records"] = summary.totalRecords;
+            for (const char* status : {"scheduled", "completed", "cancelled"}) {
+                result["counts"]["appointments_by_status"][status] = 0;
+            }
+            for (const auto& entry : summary.appointmentsByStatus) {
+                result["counts"]["appointments_by_status"][entry.first] = entry.second;
+            }
+
+            result["todays_appointments"] = ResponseBody::list();
+            writeDashboardAppointments(result["todays_appointments"], summary.todaysAppointments);
+            result["upcoming_appointments"] = ResponseBody::list();
+            writeDashboardAppointments(result["upcoming_appointments"], summary.upcomingAppointments);
+
+            result["doctor_load"] = ResponseBody::list();
+            for (size_t i = 0; i < summary.doctorLoad.size(); i++) {
+                result["doctor_load"][i]["doctor_id"] = summary.doctorLoad[i].doctorID;
+                result["doctor_load"][i]["doctor_name"] = summary.doctorLoad[i].doctorName;
+                result["doctor_load"][i]["today"] = summary.doctorLoad[i].today;
+                result["doctor_load"][i]["next_7_days"] = summary.doctorLoad[i].nextSevenDays;
+            }
+
+            result["recent_records"] = ResponseBody::list();
+            for (size_t i = 0; i < summary.recentRecords.size(); i++) {
+                result["recent_records"][i]["id"] = summary.recentRecords[i].recordID;
+                result["recent_records"][i]["patient_id"] = summary.recentRecords[i].patientID;
+                result["recent_records"][i]["patient_name"] = summary.recentRecords[i].patientName;
+                result["recent_records"][i]["doctor_name"] = summary.recentRecords[i].doctorName;
+                result["recent_records"][i]["diagnosis"] = summary.recentRecords[i].diagnosis;
+                result["recent_records"][i]["date"] = summary.recentRecords[i].date;
+            }
+
+            auto res = encodedResponse(req, result);
+            add_cors_headers(res);
+            return res;
+        }));
+
+    }
+#endif
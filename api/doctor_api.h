@@ -2,44 +2,49 @@
 #define DOCTOR_API_H
 
 #include "crow.h"
+#include "hospital_app.h"
+#include "db_route.h"
+#include "request_parser.h"
+#include "coalesced_response.h"
 // #include "user.h"
 #include "doctor.h"
 // #include "appointment.h"
 #include "patient.h"
+#include "prescription.h"
+#include "drug_interactions.h"
 // #include "cors_config.h"
 
-void registerDoctorRoutes(crow::SimpleApp& app){
+void registerDoctorRoutes(HospitalApp& app){
 
         CROW_ROUTE(app, "/doctors")
-        .methods("GET"_method)([](){
-            auto doctors = Doctor::getAllDoctorsFromDatabase();
-            crow::json::wvalue result;
-            for (size_t i = 0; i < doctors.size(); i++) {
-                result[i]["id"] = doctors[i]->getDoctorID();
-                result[i]["user_id"] = doctors[i]->getUserID();
-                result[i]["name"] = doctors[i]->getName();
-                result[i]["contact"] = doctors[i]->getContact();
-                result[i]["specialization"] = doctors[i]->getSpecialization();
-                delete doctors[i];
-            }
-            auto res = crow::response{result};
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req){
+            auto res = coalescedJsonResponse(req, []() {
+                auto doctors = Doctor::getAllDoctorsFromDatabase();
+                ResponseBody result = ResponseBody::list();
+                for (size_t i = 0; i < doctors.size(); i++) {
+                    result[i]["id"] = doctors[i]->getDoctorID();
+                    result[i]["user_id"] = doctors[i]->getUserID();
+                    result[i]["name"] = doctors[i]->getName();
+                    result[i]["contact"] = doctors[i]->getContact();
+                    result[i]["specialization"] = doctors[i]->getSpecialization();
+                    delete doctors[i];
+                }
+                return result;
+            });
             add_cors_headers(res);
             return res;
-        });
+        }));
 
         CROW_ROUTE(app, "/doctors")
-        .methods("POST"_method)([](const crow::request& req){
-            auto json = crow::json::load(req.body);
-            if (!json) {
-                return crow::response(400, "Invalid JSON");
+        .methods("POST"_method)(onDbExecutor([](const crow::request& req){
+            DoctorRequest body;
+            std::string error;
+            if (!parseRequest(req.body, body, error)) {
+                return crow::response(400, error);
             }
 
             try {
-                std::string name = json["name"].s();
-                std::string contact = json["contact"].s();
-                std::string specialization = json["specialization"].s();
-
-                Doctor doctor(0, name, contact, 0, specialization);
+                Doctor doctor(0, body.name, body.contact, 0, body.specialization);
                 if (doctor.saveToDatabase()) {
                     crow::json::wvalue result;
                     result["id"] = doctor.getDoctorID();
@@ -51,10 +56,10 @@ void registerDoctorRoutes(crow::SimpleApp& app){
                 add_cors_headers(res);
                 return res;
             }
-        });
+        }));
 
         CROW_ROUTE(app, "/doctors/<int>")
-        .methods("GET"_method)([](int id){
+        .methods("GET"_method)(onDbExecutor([](int id){
             Doctor* doctor = Doctor::getDoctorFromDatabase(id);
             if (!doctor) {
                 return crow::response(404, "Doctor not found");
@@ -72,40 +77,81 @@ void registerDoctorRoutes(crow::SimpleApp& app){
             auto res = crow::response{result};
             add_cors_headers(res);
             return res;    
-        });
+        }));
 
         CROW_ROUTE(app, "/doctors/<int>/appointments")
-        .methods("GET"_method)([](int id){
-            auto appointments = Appointment::getAppointmentsForDoctor(id);
-            crow::json::wvalue result;
-            for (size_t i = 0; i < appointments.size(); i++) {
-                result[i]["id"] = appointments[i]->getAppointmentID();
-                result[i]["patient_id"] = appointments[i]->getPatient()->getPatientID();
-                result[i]["patient_name"] = appointments[i]->getPatient()->getName();
-                result[i]["date"] = appointments[i]->getDate();
-                result[i]["time"] = appointments[i]->getTime();
-                delete appointments[i];
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req, int id){
+            auto res = coalescedJsonResponse(req, [id]() {
+                auto appointments = Appointment::getAppointmentsForDoctor(id);
+                ResponseBody result = ResponseBody::list();
+                for (size_t i = 0; i < appointments.size(); i++) {
+                    result[i]["id"] = appointments[i]->getAppointmentID();
+                    result[i]["patient_id"] = appointments[i]->getPatientID();
+                    result[i]["patient_name"] = appointments[i]->getPatient()->getName();
+                    result[i]["date"] = appointments[i]->getDate();
+                    result[i]["time"] = appointments[i]->getTime();
+                    delete appointments[i];
+                }
+                return result;
+            });
+            add_cors_headers(res);
+            return res;
+        }));
+
+        CROW_ROUTE(app, "/doctors/<int>/prescriptions")
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req, int id){
+            auto prescriptions = Prescription::getPrescriptionsForDoctor(id);
+            ResponseBody result = ResponseBody::list();
+            for (size_t i = 0; i < prescriptions.size(); i++) {
+                result[i]["id"] = prescriptions[i]->getPrescriptionID();
+                result[i]["patient_id"] = prescriptions[i]->getPatientID();
+                result[i]["medicine"] = prescriptions[i]->getMedicine();
+                result[i]["dosage"] = prescriptions[i]->getDosage();
+                result[i]["date"] = prescriptions[i]->getDate();
+                delete prescriptions[i];
             }
-            return crow::response{result};
-        });
+            auto res = encodedResponse(req, result);
+            add_cors_headers(res);
+            return res;
+        }));
 
         CROW_ROUTE(app, "/doctors/<int>/prescribe")
-        .methods("POST"_method)([](const crow::request& req, int id){
-            auto json = crow::json::load(req.body);
-            if (!json) {
-                return crow::response(400, "Invalid JSON");
+        .methods("POST"_method)(onDbExecutor([](const crow::request& req, int id){
+            PrescriptionRequest body;
+            std::string error;
+            if (!parseRequest(req.body, body, error)) {
+                return crow::response(400, error);
             }
 
             try {
-                int patientID = json["patient_id"].i();
-                std::string medicine = json["medicine"].s();
-                std::string dosage = json["dosage"].s();
+                int patientID = body.patientID;
+                const std::string& medicine = body.medicine;
+                const std::string& dosage = body.dosage;
+                bool overrideInteractions = body.overrideInteractions;
 
                 Doctor* doctor = Doctor::getDoctorFromDatabase(id);
                 if (!doctor) {
                     return crow::response(404, "Doctor not found");
                 }
 
+                // one indexed read for the active list, then in-memory probes
+                auto interactions = DrugInteractions::getInstance().check(
+                    medicine, Prescription::getActiveMedicinesForPatient(patientID));
+                if (!interactions.empty() && !overrideInteractions) {
+                    delete doctor;
+
+                    crow::json::wvalue result;
+                    result["error"] = "Interacts with active prescriptions";
+                    for (size_t i = 0; i < interactions.size(); i++) {
+                        result["interactions"][i]["medicine"] = interactions[i].medicine;
+                        result["interactions"][i]["severity"] = interactions[i].severity;
+                        result["interactions"][i]["description"] = interactions[i].description;
+                    }
+                    auto res = crow::response{409, result};
+                    add_cors_headers(res);
+                    return res;
+                }
+
                 doctor->prescribeMedicine(patientID, medicine, dosage);
                 delete doctor;
                 
@@ -117,7 +163,7 @@ void registerDoctorRoutes(crow::SimpleApp& app){
                 add_cors_headers(res);
                 return res;
             }
-        });
+        }));
 
     }
 #endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef EVENTS_API_H
+#define EVENTS_API_H
+
+#include "crow.h"
+#include "hospital_app.h"
+#include "change_feed.h"
+#include <cstdlib>
+
+void registerEventRoutes(HospitalApp& app){
+
+        // Long-polling event stream: each request is answered with the events
+        // published since Last-Event-ID (or a keepalive after
+        // ChangeFeed::kPollSeconds), and EventSource reconnects right away
+        // thanks to the retry field, resuming from the last id it saw.
+        CROW_ROUTE(app, "/events")
+        .methods("GET"_method)([](const crow::request& req, crow::response& res){
+            std::string lastEventID = req.get_header_value("Last-Event-ID");
+            if (lastEventID.empty() && req.url_params.get("last_event_id")) {
+                lastEventID = req.url_params.get("last_event_id");
+            }
+
+            bool resume = false;
+            uint64_t position = 0;
+            if (!lastEventID.empty()) {
+                char* end = nullptr;
+                position = std::strtoull(lastEventID.c_str(), &end, 10);
+                resume = end && *end == '\0';
+            }
+
+            crow::response* pending = &res;
+            bool accepted = ChangeFeed::getInstance().subscribe(resume, position, [pending](const std::string& body){
+                pending->code = 200;
+                pending->set_header("Content-Type", "text/event-stream");
+                pending->set_header("Cache-Control", "no-cache");
+                add_cors_headers(*pending);
+                pending->write(body);
+                pending->end();
+            });
+
+            if (!accepted) {
+                res.code = 503;
+                res.set_header("Retry-After", "5");
+                add_cors_headers(res);
+                res.end();
+            }
+        });
+
+    }
+#endif
@@ -5,7 +5,7 @@
 // #include "crow.h"
 // #include "user.h"
 
-// void registerLoginRoutes(crow::SimpleApp& app) {
+// void registerLoginRoutes(HospitalApp& app) {
 //     // Simple login endpoint
 //     CROW_ROUTE(app, "/auth")
 //     .methods("POST"_method)([](const crow::request& req) {
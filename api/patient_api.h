@@ -2,47 +2,50 @@
 #define PATIENT_API
 
 #include "crow.h"
+#include "hospital_app.h"
+#include "db_route.h"
+#include "request_parser.h"
+#include "coalesced_response.h"
 #include "patient.h"
 // #include "appointment.h"
 #include "doctor.h"
 #include "record.h"
+#include "timeline.h"
+#include "prescription.h"
 
-void registerPatientRoutes(crow::SimpleApp& app){
+void registerPatientRoutes(HospitalApp& app){
 
  // Patient endpoints
         CROW_ROUTE(app, "/patients")
-        .methods("GET"_method)([](){
-            auto patients = Patient::getAllPatientsFromDatabase();
-            crow::json::wvalue result;
-            for (size_t i = 0; i < patients.size(); i++) {
-                result[i]["id"] = patients[i]->getPatientID();
-                result[i]["user_id"] = patients[i]->getUserID();
-                result[i]["name"] = patients[i]->getName();
-                result[i]["contact"] = patients[i]->getContact();
-                result[i]["age"] = patients[i]->getAge();
-                result[i]["gender"] = patients[i]->getGender();
-                delete patients[i];
-            }
-            // return crow::response{result};
-            auto res = crow::response{result};
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req){
+            auto res = coalescedJsonResponse(req, []() {
+                auto patients = Patient::getAllPatientsFromDatabase();
+                ResponseBody result = ResponseBody::list();
+                for (size_t i = 0; i < patients.size(); i++) {
+                    result[i]["id"] = patients[i]->getPatientID();
+                    result[i]["user_id"] = patients[i]->getUserID();
+                    result[i]["name"] = patients[i]->getName();
+                    result[i]["contact"] = patients[i]->getContact();
+                    result[i]["age"] = patients[i]->getAge();
+                    result[i]["gender"] = patients[i]->getGender();
+                    delete patients[i];
+                }
+                return result;
+            });
             add_cors_headers(res);
             return res;
-        });
+        }));
 
         CROW_ROUTE(app, "/patients")
-        .methods("POST"_method)([](const crow::request& req){
-            auto json = crow::json::load(req.body);
-            if (!json) {
-                return crow::response(400, "Invalid JSON");
+        .methods("POST"_method)(onDbExecutor([](const crow::request& req){
+            PatientRequest body;
+            std::string error;
+            if (!parseRequest(req.body, body, error)) {
+                return crow::response(400, error);
             }
 
             try {
-                std::string name = json["name"].s();
-                std::string contact = json["contact"].s();
-                int age = json["age"].i();
-                std::string gender = json["gender"].s();
-
-                Patient patient(0, name, contact, 0, age, gender);
+                Patient patient(0, body.name, body.contact, 0, body.age, body.gender);
                 if (patient.saveToDatabase()) {
                     crow::json::wvalue result;
                     result["id"] = patient.getPatientID();
@@ -54,10 +57,10 @@ void registerPatientRoutes(crow::SimpleApp& app){
                 add_cors_headers(res);
                 return res;
             }
-        });
+        }));
 
         CROW_ROUTE(app, "/patients/<int>")
-        .methods("GET"_method)([](int id){
+        .methods("GET"_method)(onDbExecutor([](int id){
             Patient* patient = Patient::getPatientFromDatabase(id);
             if (!patient) {
                 return crow::response(404, "Patient not found");
@@ -76,43 +79,107 @@ void registerPatientRoutes(crow::SimpleApp& app){
             auto res = crow::response{result};
             add_cors_headers(res);
             return res;
-        });
+        }));
 
         CROW_ROUTE(app, "/patients/<int>/appointments")
-        .methods("GET"_method)([](int id){
-            auto appointments = Appointment::getAppointmentsForPatient(id);
-            crow::json::wvalue result;
-            for (size_t i = 0; i < appointments.size(); i++) {
-                result[i]["id"] = appointments[i]->getAppointmentID();
-                result[i]["patient_id"] = appointments[i]->getPatient()->getPatientID();
-                result[i]["doctor_id"] = appointments[i]->getDoctor()->getDoctorID();
-                result[i]["doctor_name"] = appointments[i]->getDoctor()->getName();
-                result[i]["date"] = appointments[i]->getDate();
-                result[i]["time"] = appointments[i]->getTime();
-                delete appointments[i];
-            }
-            auto res = crow::response{result};
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req, int id){
+            auto res = coalescedJsonResponse(req, [id]() {
+                auto appointments = Appointment::getAppointmentsForPatient(id);
+                ResponseBody result = ResponseBody::list();
+                for (size_t i = 0; i < appointments.size(); i++) {
+                    result[i]["id"] = appointments[i]->getAppointmentID();
+                    result[i]["patient_id"] = appointments[i]->getPatientID();
+                    result[i]["doctor_id"] = appointments[i]->getDoctorID();
+                    result[i]["doctor_name"] = appointments[i]->getDoctor()->getName();
+                    result[i]["date"] = appointments[i]->getDate();
+                    result[i]["time"] = appointments[i]->getTime();
+                    delete appointments[i];
+                }
+                return result;
+            });
             add_cors_headers(res);
             return res;
-        });
+        }));
 
         CROW_ROUTE(app, "/patients/<int>/records")
-        .methods("GET"_method)([](int id){
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req, int id){
             auto records = MedicalRecord::getRecordsForPatient(id);
-            crow::json::wvalue result;
+            ResponseBody result = ResponseBody::list();
             for (size_t i = 0; i < records.size(); i++) {
                 result[i]["id"] = records[i]->getRecordID();
-                result[i]["doctor_id"] = records[i]->getDoctor()->getDoctorID();
+                result[i]["doctor_id"] = records[i]->getDoctorID();
                 result[i]["doctor_name"] = records[i]->getDoctor()->getName();
                 result[i]["diagnosis"] = records[i]->getDiagnosis();
                 result[i]["treatment"] = records[i]->getTreatment();
                 result[i]["date"] = records[i]->getDate();
                 delete records[i];
             }
-            auto res = crow::response{result};
+            auto res = encodedResponse(req, result);
+            add_cors_headers(res);
+            return res;
+        }));
+
+        CROW_ROUTE(app, "/patients/<int>/prescriptions")
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req, int id){
+            auto prescriptions = Prescription::getPrescriptionsForPatient(id);
+            ResponseBody result = ResponseBody::list();
+            for (size_t i = 0; i < prescriptions.size(); i++) {
+                result[i]["id"] = prescriptions[i]->getPrescriptionID();
+                result[i]["doctor_id"] = prescriptions[i]->getDoctorID();
+                result[i]["medicine"] = prescriptions[i]->getMedicine();
+                result[i]["dosage"] = prescriptions[i]->getDosage();
+                result[i]["date"] = prescriptions[i]->getDate();
+                delete prescriptions[i];
+            }
+            auto res = encodedResponse(req, result);
             add_cors_headers(res);
             return res;
-        });
+        }));
+
+        CROW_ROUTE(app, "/patients/<int>/timeline")
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req, int id){
+            int limit = req.url_params.get("limit") ? std::atoi(req.url_params.get("limit")) : 50;
+            limit = std::min(std::max(limit, 1), 200);
+
+            TimelineCursor cursor;
+            const char* after = req.url_params.get("cursor");
+            if (after && !TimelineCursor::decode(after, cursor)) {
+                return crow::response(400, "Invalid cursor");
+            }
+
+            try {
+                std::vector<TimelineEvent> events;
+                std::string nextCursor;
+                if (!PatientTimeline::getPage(id, after ? &cursor : nullptr, limit, events, nextCursor)) {
+                    return crow::response(404, "Patient not found");
+                }
+
+                ResponseBody result;
+                result["patient_id"] = id;
+                result["events"] = ResponseBody::list();
+                for (size_t i = 0; i < events.size(); i++) {
+                    result["events"][i]["type"] = events[i].type;
+                    result["events"][i]["id"] = events[i].id;
+                    result["events"][i]["date"] = events[i].date;
+                    result["events"][i]["doctor_id"] = events[i].doctorID;
+                    result["events"][i]["doctor_name"] = events[i].doctorName;
+                    result["events"][i]["title"] = events[i].title;
+                    result["events"][i]["detail"] = events[i].detail;
+                }
+                if (nextCursor.empty()) {
+                    result["next_cursor"] = nullptr;
+                } else {
+                    result["next_cursor"] = nextCursor;
+                }
+                auto res = encodedResponse(req, result);
+                add_cors_headers(res);
+                return res;
+            } catch (const std::exception& e) {
+                auto res = crow::response(500, e.what());
+                add_cors_headers(res);
+                return res;
+            }
+        }));
     }
 
 #endif
\ No newline at end of file
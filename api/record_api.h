@@ -2,83 +2,132 @@
 #define RECORD_API_H
 
 #include "crow.h"
+#include "hospital_app.h"
+#include "db_route.h"
+#include "request_parser.h"
+#include "async_data.h"
 // #include "user.h"
 #include "doctor.h"
 // #include "appointment.h"
 #include "patient.h"
 #include "record.h"
+#include "coalesced_response.h"
 
-void registerRecordRoutes(crow::SimpleApp& app){
+void registerRecordRoutes(HospitalApp& app){
 
 
         CROW_ROUTE(app, "/records")
-        .methods("GET"_method)([](){
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req){
             auto records = MedicalRecord::getAllRecordsFromDatabase();
-            crow::json::wvalue result;
+            ResponseBody result = ResponseBody::list();
             for (size_t i = 0; i < records.size(); i++) {
                 result[i]["id"] = records[i]->getRecordID();
-                result[i]["patient_id"] = records[i]->getPatient()->getPatientID();
+                result[i]["patient_id"] = records[i]->getPatientID();
                 result[i]["patient_name"] = records[i]->getPatient()->getName();
-                result[i]["doctor_id"] = records[i]->getDoctor()->getDoctorID();
+                result[i]["doctor_id"] = records[i]->getDoctorID();
                 result[i]["doctor_name"] = records[i]->getDoctor()->getName();
                 result[i]["diagnosis"] = records[i]->getDiagnosis();
                 result[i]["treatment"] = records[i]->getTreatment();
                 result[i]["date"] = records[i]->getDate();
                 delete records[i];
             }
-            auto res = crow::response{result};
+            auto res = encodedResponse(req, result);
             add_cors_headers(res);
             return res;
-        });
+        }));
 
         CROW_ROUTE(app, "/records")
-        .methods("POST"_method)([](const crow::request& req){
-            auto json = crow::json::load(req.body);
-            if (!json) {
-                return crow::response(400, "Invalid JSON");
+        .methods("POST"_method)(onCoroutine([](const crow::request& req) -> Task<crow::response> {
+            RecordRequest body;
+            std::string error;
+            if (!parseRequest(req.body, body, error)) {
+                co_return crow::response(400, error);
             }
 
             try {
-                int patientID = json["patient_id"].i();
-                int doctorID = json["doctor_id"].i();
-                std::string diagnosis = json["diagnosis"].s();
-                std::string treatment = json["treatment"].s();
-
-                Patient* patient = Patient::getPatientFromDatabase(patientID);
-                Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
+                // The two lookups are independent, so run them side by side
+                auto [patient, doctor] = co_await whenAll(AsyncData::loadPatient(body.patientID),
+                                                          AsyncData::loadDoctor(body.doctorID));
 
                 if (!patient || !doctor) {
-                    return crow::response(404, "Patient or Doctor not found");
+                    co_return crow::response(404, "Patient or Doctor not found");
                 }
 
-                MedicalRecord record(0, patient, doctor, diagnosis, treatment);
-                if (record.saveToDatabase()) {
+                MedicalRecord record(0, body.patientID, body.doctorID, body.diagnosis, body.treatment);
+                if (co_await AsyncData::save(record)) {
                     crow::json::wvalue result;
                     result["id"] = record.getRecordID();
-                    return crow::response{result};
+                    co_return crow::response{result};
                 }
                 auto res = crow::response(500, "Failed to save medical record");
                 add_cors_headers(res);
+                co_return res;
+            } catch (const std::exception& e) {
+                auto res = crow::response(500, e.what());
+                add_cors_headers(res);
+                co_return res;
+            }
+        }));
+
+        CROW_ROUTE(app, "/records/search")
+        .methods("GET"_method)(onDbExecutor([](const crow::request& req){
+            const char* query = req.url_params.get("q");
+            if (!query || std::string(query).empty()) {
+                return crow::response(400, "Missing search query");
+            }
+
+            int patientID = req.url_params.get("patient_id") ? std::atoi(req.url_params.get("patient_id")) : 0;
+            int doctorID = req.url_params.get("doctor_id") ? std::atoi(req.url_params.get("doctor_id")) : 0;
+            int page = req.url_params.get("page") ? std::max(1, std::atoi(req.url_params.get("page"))) : 1;
+            int pageSize = req.url_params.get("page_size") ? std::atoi(req.url_params.get("page_size")) : 20;
+            pageSize = std::min(std::max(pageSize, 1), 100);
+
+            try {
+                auto hits = MedicalRecord::searchRecords(query, patientID, doctorID, pageSize, (page - 1) * pageSize);
+                bool hasMore = hits.size() > static_cast<size_t>(pageSize);
+                if (hasMore) {
+                    hits.pop_back();
+                }
+
+                ResponseBody result;
+                result["page"] = page;
+                result["page_size"] = pageSize;
+                result["has_more"] = hasMore;
+                result["results"] = ResponseBody::list();
+                for (size_t i = 0; i < hits.size(); i++) {
+                    result["results"][i]["id"] = hits[i].recordID;
+                    result["results"][i]["patient_id"] = hits[i].patientID;
+                    result["results"][i]["patient_name"] = hits[i].patientName;
+                    result["results"][i]["doctor_id"] = hits[i].doctorID;
+                    result["results"][i]["doctor_name"] = hits[i].doctorName;
+                    result["results"][i]["diagnosis"] = hits[i].diagnosis;
+                    result["results"][i]["treatment"] = hits[i].treatment;
+                    result["results"][i]["date"] = hits[i].date;
+                    result["results"][i]["snippet"] = hits[i].snippet;
+                    result["results"][i]["score"] = hits[i].score;
+                }
+                auto res = encodedResponse(req, result);
+                add_cors_headers(res);
                 return res;
             } catch (const std::exception& e) {
                 auto res = crow::response(500, e.what());
                 add_cors_headers(res);
                 return res;
             }
-        });
+        }));
 
         CROW_ROUTE(app, "/records/<int>")
-        .methods("GET"_method)([](int id){
-            MedicalRecord* record = MedicalRecord::getRecordFromDatabase(id);
+        .methods("GET"_method)(onDbExecutor([](int id){
+            MedicalRecord* record = MedicalRecord::getRecordFromDatabase(id, true);
             if (!record) {
                 return crow::response(404, "Medical record not found");
             }
             
             crow::json::wvalue result;
             result["id"] = record->getRecordID();
-            result["patient_id"] = record->getPatient()->getPatientID();
+            result["patient_id"] = record->getPatientID();
             result["patient_name"] = record->getPatient()->getName();
-            result["doctor_id"] = record->getDoctor()->getDoctorID();
+            result["doctor_id"] = record->getDoctorID();
             result["doctor_name"] = record->getDoctor()->getName();
             result["diagnosis"] = record->getDiagnosis();
             result["treatment"] = record->getTreatment();
@@ -89,7 +138,7 @@ void registerRecordRoutes(crow::SimpleApp& app){
             auto res = crow::response{result};
             add_cors_headers(res);
             return res;
-        });
+        }));
 
     }
     #endif
\ No newline at end of file
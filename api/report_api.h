@@ -2,6 +2,9 @@
 #define REPORT_API_H
 
 #include "crow.h"
+#include "hospital_app.h"
+#include "db_route.h"
+#include "request_parser.h"
 // #include "user.h"
 // #include "doctor.h"
 // #include "appointment.h"
@@ -9,7 +12,7 @@
 // #include "record.h"
 #include "report.h"
 
-void registerReportRoutes(crow::SimpleApp& app){
+void registerReportRoutes(HospitalApp& app){
 
 // CROW_ROUTE(app, "/reports")
         // .methods("GET"_method)([](){
@@ -25,17 +28,15 @@ void registerReportRoutes(crow::SimpleApp& app){
         // });
 
         CROW_ROUTE(app, "/reports")
-        .methods("POST"_method)([](const crow::request& req){
-            auto json = crow::json::load(req.body);
-            if (!json) {
-                return crow::response(400, "Invalid JSON");
+        .methods("POST"_method)(onDbExecutor([](const crow::request& req){
+            ReportRequest body;
+            std::string error;
+            if (!parseRequest(req.body, body, error)) {
+                return crow::response(400, error);
             }
 
             try {
-                int doctorID = json["doctor_id"].i();
-                std::string details = json["details"].s();
-
-                Report report(0, doctorID, details);
+                Report report(0, body.doctorID, body.details);
                 if (report.saveToDatabase()) {
                     crow::json::wvalue result;
                     result["id"] = report.getReportID();
@@ -45,10 +46,10 @@ void registerReportRoutes(crow::SimpleApp& app){
             } catch (const std::exception& e) {
                 return crow::response(500, e.what());
             }
-        });
+        }));
 
         CROW_ROUTE(app, "/reports/<int>")
-        .methods("GET"_method)([](int id){
+        .methods("GET"_method)(onDbExecutor([](int id){
             Report* report = Report::getReportFromDatabase(id);
             if (!report) {
                 return crow::response(404, "Report not found");
@@ -61,7 +62,7 @@ void registerReportRoutes(crow::SimpleApp& app){
             
             delete report;
             return crow::response{result};
-        });
+        }));
 
     }
     #endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef SEARCH_API_H
+#define SEARCH_API_H
+
+#include "crow.h"
+#include "hospital_app.h"
+#include "people_index.h"
+#include "coalesced_response.h"
+
+void registerSearchRoutes(HospitalApp& app){
+
+        CROW_ROUTE(app, "/search/people")
+        .methods("GET"_method)([](const crow::request& req){
+            const char* prefix = req.url_params.get("prefix");
+            if (!prefix) {
+                return crow::response(400, "Missing prefix");
+            }
+
+            std::string type = req.url_params.get("type") ? req.url_params.get("type") : "";
+            if (!type.empty() && !PeopleIndex::isIndexedType(type)) {
+                return crow::response(400, "Invalid type");
+            }
+            int limit = req.url_params.get("limit") ? std::atoi(req.url_params.get("limit")) : 10;
+            limit = std::min(std::max(limit, 1), 50);
+
+            auto people = PeopleIndex::getInstance().search(prefix, type, limit);
+            ResponseBody result = ResponseBody::list();
+            for (size_t i = 0; i < people.size(); i++) {
+                result[i]["id"] = people[i].roleID;
+                result[i]["user_id"] = people[i].userID;
+                result[i]["type"] = people[i].type;
+                result[i]["name"] = people[i].name;
+                result[i]["contact"] = people[i].contact;
+            }
+            auto res = encodedResponse(req, result);
+            add_cors_headers(res);
+            return res;
+        });
+
+    }
+#endif
@@ -3,13 +3,17 @@
 #define USER_API_H
 
 #include "crow.h"
+#include "hospital_app.h"
+#include "db_route.h"
+#include "request_parser.h"
 #include "user.h"
+#include "coalesced_response.h"
 
-void registerUserRoutes(crow::SimpleApp& app) {
+void registerUserRoutes(HospitalApp& app) {
     CROW_ROUTE(app, "/users")
-    .methods("GET"_method)([](){
+    .methods("GET"_method)(onDbExecutor([](const crow::request& req){
         auto users = User::getAllUsersFromDatabase();
-        crow::json::wvalue result;
+        ResponseBody result = ResponseBody::list();
         for (size_t i = 0; i < users.size(); i++) {
             result[i]["id"] = users[i]->getUserID();
             result[i]["name"] = users[i]->getName();
@@ -17,11 +21,11 @@ void registerUserRoutes(crow::SimpleApp& app) {
             result[i]["type"] = users[i]->getType();
             delete users[i];
         }
-        return crow::response{result};
-    });
+        return encodedResponse(req, result);
+    }));
 
     CROW_ROUTE(app, "/users/<int>")
-    .methods("GET"_method)([](int id){
+    .methods("GET"_method)(onDbExecutor([](int id){
         User* user = User::getUserFromDatabase(id);
         if (!user) {
             return crow::response(404, "User not found");
@@ -35,19 +39,20 @@ void registerUserRoutes(crow::SimpleApp& app) {
 
         delete user;
         return crow::response{result};
-    });
+    }));
 
     CROW_ROUTE(app, "/users")
-    .methods("POST"_method)([](const crow::request& req){
-        auto json = crow::json::load(req.body);
-        if (!json) {
-            return crow::response(400, "Invalid JSON");
+    .methods("POST"_method)(onDbExecutor([](const crow::request& req){
+        UserRequest body;
+        std::string error;
+        if (!parseRequest(req.body, body, error)) {
+            return crow::response(400, error);
         }
 
         try {
-            std::string name = json["name"].s();
-            std::string contact = json["contact"].s();
-            std::string type = json["type"].s();
+            const std::string& name = body.name;
+            const std::string& contact = body.contact;
+            const std::string& type = body.type;
 
             if (type != "patient" && type != "doctor" && type != "receptionist" && type != "admin") {
                 return crow::response(400, "Invalid user type");
@@ -68,7 +73,7 @@ void registerUserRoutes(crow::SimpleApp& app) {
         } catch (const std::exception& e) {
             return crow::response(500, e.what());
         }
-    });
+    }));
 }
 
 #endif // USER_ROUTES_H
@@ -3,6 +3,7 @@ import { Plus, Calendar, Grid, Filter, User, Clock, MapPin } from 'lucide-react'
 import PageHeader from '../components/PageHeader';
 import DataTable from '../components/DataTable';
 import Modal from '../components/Modal';
+import { API_URL } from '../services/apiUrl';
 
 const Appointments = () => {
   const [appointments, setAppointments] = useState([]);
@@ -16,7 +17,7 @@ const Appointments = () => {
   useEffect(() => {
     const fetchAppointments = async () => {
       try {
-        const response = await fetch('http://localhost:8080/appointments');
+        const response = await fetch(`${API_URL}/appointments`);
         if (!response.ok) throw new Error('Failed to fetch appointments');
         const data = await response.json();
         // Transform data to match frontend expectations
@@ -43,7 +44,7 @@ const Appointments = () => {
 
   const handleCreateAppointment = async (appointmentData) => {
     try {
-      const response = await fetch('http://localhost:8080/appointments', {
+      const response = await fetch(`${API_URL}/appointments`, {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify({
@@ -78,7 +79,7 @@ const Appointments = () => {
 
   const handleUpdateAppointment = async (appointmentData) => {
     try {
-      const response = await fetch(`http://localhost:8080/appointments/${appointmentData.id}`, {
+      const response = await fetch(`${API_URL}/appointments/${appointmentData.id}`, {
         method: 'PUT',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify({
@@ -109,7 +110,7 @@ const Appointments = () => {
   const handleDeleteAppointment = async (id) => {
     if (window.confirm('Are you sure you want to delete this appointment?')) {
       try {
-        const response = await fetch(`http://localhost:8080/appointments/${id}`, { 
+        const response = await fetch(`${API_URL}/appointments/${id}`, { 
           method: 'DELETE' 
         });
         
@@ -130,8 +131,8 @@ const Appointments = () => {
     const fetchData = async () => {
       try {
         const [patientsRes, doctorsRes] = await Promise.all([
-          fetch('http://localhost:8080/patients'),
-          fetch('http://localhost:8080/doctors')
+          fetch(`${API_URL}/patients`),
+          fetch(`${API_URL}/doctors`)
         ]);
         
         if (patientsRes.ok) {
@@ -1,6 +1,7 @@
 import { useState, useEffect } from 'react';
 import PageHeader from '../components/PageHeader';
 import { Users, UserCog, Calendar, DollarSign, Activity, TrendingUp, Clock } from 'lucide-react';
+import { API_URL } from '../services/apiUrl';
 
 const Dashboard = () => {
   const [stats, setStats] = useState({
@@ -17,36 +18,17 @@ const Dashboard = () => {
   useEffect(() => {
     const fetchData = async () => {
       try {
-        // Fetch all data in parallel
-        const [patientsRes, doctorsRes, appointmentsRes] = await Promise.all([
-          fetch('http://localhost:8080/patients'),
-          fetch('http://localhost:8080/doctors'),
-          fetch('http://localhost:8080/appointments')
-        ]);
+        // One summary call instead of downloading every patient, doctor and appointment
+        const response = await fetch(`${API_URL}/dashboard`);
 
-        if (!patientsRes.ok || !doctorsRes.ok || !appointmentsRes.ok) {
+        if (!response.ok) {
           throw new Error('Failed to fetch dashboard data');
         }
 
-        const [patients, doctors, appointments] = await Promise.all([
-          patientsRes.json(),
-          doctorsRes.json(),
-          appointmentsRes.json()
-        ]);
+        const summary = await response.json();
 
-        // Convert object to array if needed
-        const patientsArray = Array.isArray(patients) ? patients : Object.values(patients);
-        const doctorsArray = Array.isArray(doctors) ? doctors : Object.values(doctors);
-        const appointmentsArray = Array.isArray(appointments) ? appointments : Object.values(appointments);
-
-        // Calculate pending appointments
-        const pending = appointmentsArray.filter(appt => 
-          appt.status === 'scheduled' || appt.status === 'pending'
-        ).length;
-
-        // Get recent appointments (last 4)
-        const recent = appointmentsArray
-          .sort((a, b) => new Date(b.date) - new Date(a.date))
+        // Today's appointments first, then the next scheduled ones
+        const recent = [...summary.todays_appointments, ...summary.upcoming_appointments]
           .slice(0, 4)
           .map(appt => ({
             id: appt.id,
@@ -58,10 +40,10 @@ const Dashboard = () => {
           }));
 
         setStats({
-          totalPatients: patientsArray.length,
-          totalDoctors: doctorsArray.length,
-          totalAppointments: appointmentsArray.length,
-          pendingAppointments: pending
+          totalPatients: summary.counts.patients,
+          totalDoctors: summary.counts.doctors,
+          totalAppointments: summary.counts.appointments,
+          pendingAppointments: summary.counts.appointments_by_status.scheduled || 0
         });
 
         setRecentAppointments(recent);
@@ -2,6 +2,7 @@
 import { useState } from 'react';
 import { useNavigate } from 'react-router-dom';
 import { UserCircle } from 'lucide-react';
+import { API_URL } from '../services/apiUrl';
 
 const Login = ({ onLogin }) => {
   const navigate = useNavigate();
@@ -30,7 +31,7 @@ const Login = ({ onLogin }) => {
     setIsLoading(true);
     
     try {
-      const response = await fetch('http://localhost:8080/users', {
+      const response = await fetch(`${API_URL}/users`, {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify(formData)
@@ -3,6 +3,7 @@ import { Plus, FileText, Search, Filter, Download, User } from 'lucide-react';
 import PageHeader from '../components/PageHeader';
 import DataTable from '../components/DataTable';
 import Modal from '../components/Modal';
+import { API_URL } from '../services/apiUrl';
 
 const MedicalRecords = () => {
   const [records, setRecords] = useState([]);
@@ -20,7 +21,7 @@ const MedicalRecords = () => {
         setIsLoading(true);
         
         // Fetch patients
-        const patientsRes = await fetch('http://localhost:8080/patients');
+        const patientsRes = await fetch(`${API_URL}/patients`);
         if (!patientsRes.ok) throw new Error('Failed to fetch patients');
         const patientsData = await patientsRes.json();
         setPatients(patientsData.map(p => ({
@@ -29,7 +30,7 @@ const MedicalRecords = () => {
         })));
 
         // Fetch doctors
-        const doctorsRes = await fetch('http://localhost:8080/doctors');
+        const doctorsRes = await fetch(`${API_URL}/doctors`);
         if (!doctorsRes.ok) throw new Error('Failed to fetch doctors');
         const doctorsData = await doctorsRes.json();
         setDoctors(doctorsData.map(d => ({
@@ -40,8 +41,8 @@ const MedicalRecords = () => {
 
         // Fetch records
         const url = selectedPatient 
-          ? `http://localhost:8080/records/patient/${selectedPatient}`
-          : 'http://localhost:8080/records';
+          ? `${API_URL}/records/patient/${selectedPatient}`
+          : `${API_URL}/records`;
         
         const recordsRes = await fetch(url);
         if (!recordsRes.ok) throw new Error('Failed to fetch medical records');
@@ -73,7 +74,7 @@ const MedicalRecords = () => {
 
   const handleCreateRecord = async (recordData) => {
     try {
-      const response = await fetch('http://localhost:8080/records', {
+      const response = await fetch(`${API_URL}/records`, {
         method: 'POST',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify({
@@ -109,7 +110,7 @@ const MedicalRecords = () => {
 
   const handleUpdateRecord = async (recordData) => {
     try {
-      const response = await fetch(`http://localhost:8080/records/${recordData.id}`, {
+      const response = await fetch(`${API_URL}/records/${recordData.id}`, {
         method: 'PUT',
         headers: { 'Content-Type': 'application/json' },
         body: JSON.stringify({
@@ -139,7 +140,7 @@ const MedicalRecords = () => {
   const handleDeleteRecord = async (id) => {
     if (window.confirm('Are you sure you want to delete this medical record?')) {
       try {
-        const response = await fetch(`http://localhost:8080/records/${id}`, { 
+        const response = await fetch(`${API_URL}/records/${id}`, { 
           method: 'DELETE' 
         });
         
@@ -0,0 +1,4 @@
+// The production build is served by hospx itself, so API calls stay on the
+// same origin and need no CORS preflight. The Vite dev server runs on its own
+// port and still talks to the API on :8080.
+export const API_URL = import.meta.env.DEV ? 'http://localhost:8080' : '';
@@ -0,0 +1,127 @@
+#ifndef ADMISSION_CONTROL_H
+#define ADMISSION_CONTROL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class RouteClass {
+    Read,    // interactive lookups
+    Write,   // bookings, record entry and other mutations
+    Bulk,    // reports, exports and full-table pulls
+    Exempt   // health check, CORS preflight, change feed, metrics
+};
+
+struct RouteClassLimits {
+    int maxConcurrent;
+    int maxQueued;          // requests allowed to wait for a slot
+    int maxWaitMillis;      // how long a queued request may wait
+    int retryAfterSeconds;  // advertised to rejected clients
+};
+
+struct RouteClassMetrics {
+    std::string name;
+    RouteClassLimits limits;
+    int inFlight;
+    int queued;
+    int peakInFlight;
+    int peakQueued;
+    uint64_t admitted;
+    uint64_t rejectedQueueFull;
+    uint64_t rejectedTimeout;
+    double averageWaitMillis;
+    double averageServiceMillis;
+};
+
+// Per-class concurrency limits with a small bounded wait queue in front of
+// each. A request that finds its class saturated is parked in the queue while
+// there is room, and turned away at once otherwise so the caller can answer
+// 503. Parking never blocks a thread: release() hands the freed slot to the
+// oldest waiter and resumes it, and a waiter still queued after maxWaitMillis
+// is resumed as rejected by the expiry thread. Keeping bulk work in its own
+// class means a long report can no longer occupy the slots bookings depend on.
+//
+// Slots are taken by the onDbExecutor and onCoroutine adapters (db_route.h),
+// so only routes that do database work are admitted.
+class AdmissionController {
+public:
+    enum class Outcome {
+        Admitted,  // the caller holds a slot now
+        Queued,    // resume will be called exactly once, later
+        Rejected   // the queue is full
+    };
+
+    // true when a slot was handed over, false when the wait timed out. Called
+    // from release() or the expiry thread, so it must only hand work off.
+    using Resume = std::function<void(bool admitted)>;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Waiter {
+        Resume resume;
+        Clock::time_point queuedAt;
+        Clock::time_point deadline;
+    };
+
+    struct ClassState {
+        RouteClassLimits limits;
+        std::deque<Waiter> waiters;
+        int inFlight = 0;
+        int peakInFlight = 0;
+        int peakQueued = 0;
+        uint64_t admitted = 0;
+        uint64_t rejectedQueueFull = 0;
+        uint64_t rejectedTimeout = 0;
+        uint64_t completed = 0;
+        Clock::duration totalWait{0};
+        Clock::duration totalService{0};
+    };
+
+    static AdmissionController* instance;
+
+    std::mutex mutex;
+    ClassState states[3];
+
+    std::thread expiryWorker;
+    std::condition_variable expirySignal;
+    bool running = false;
+
+    AdmissionController();
+    ClassState& state(RouteClass routeClass);
+    // Moves waiters that now have a slot, or whose wait ran out, into
+    // admitted/expired; the caller resumes them after dropping the lock.
+    void dispatchWaiters(ClassState& s, Clock::time_point now, std::vector<Resume>& admitted,
+                         std::vector<Resume>& expired);
+    void expiryLoop();
+
+public:
+    ~AdmissionController();
+    static AdmissionController& getInstance();
+
+    static RouteClass classify(const std::string& method, const std::string& path);
+    static const char* className(RouteClass routeClass);
+
+    // Starts the thread that turns away waiters whose maxWaitMillis ran out
+    // while no slot was released.
+    void start();
+    void stop();
+
+    void setLimits(RouteClass routeClass, const RouteClassLimits& limits);
+    RouteClassLimits getLimits(RouteClass routeClass);
+
+    // Never blocks; resume is only kept for Queued. release must be called
+    // for every Admitted and for every resume(true).
+    Outcome admit(RouteClass routeClass, Resume resume);
+    void release(RouteClass routeClass, Clock::duration serviceTime);
+
+    std::vector<RouteClassMetrics> metrics();
+};
+
+#endif // ADMISSION_CONTROL_H
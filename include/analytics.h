@@ -0,0 +1,128 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <sqlite3.h>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// String dictionary used for the low-cardinality columns of the snapshot.
+class Dictionary {
+private:
+    std::vector<std::string> values;
+    std::unordered_map<std::string, int32_t> codes;
+
+public:
+    int32_t encode(const std::string& value);
+    int32_t find(const std::string& value) const;   // -1 when absent
+    const std::string& decode(int32_t code) const;
+    size_t size() const;
+};
+
+// Read-only, column-oriented copy of Appointments, MedicalRecords (archived
+// rows included) and Prescriptions. Doctors, specializations, statuses and medicines are
+// dictionary encoded and dates are stored as yyyymmdd integers, so the
+// report scans below are tight loops over contiguous int32 arrays.
+struct AnalyticsSnapshot {
+    // doctor dimension, indexed by doctor code
+    std::vector<int> doctorIDs;
+    std::vector<std::string> doctorNames;
+    std::vector<int32_t> doctorSpecialization;
+    Dictionary specializations;
+    Dictionary statuses;
+    Dictionary medicines;
+
+    std::vector<int32_t> appointmentDoctor;
+    std::vector<int32_t> appointmentPatient;
+    std::vector<int32_t> appointmentDate;
+    std::vector<int32_t> appointmentStatus;
+
+    std::vector<int32_t> recordDoctor;
+    std::vector<int32_t> recordPatient;
+    std::vector<int32_t> recordDate;
+
+    std::vector<int32_t> prescriptionDoctor;
+    std::vector<int32_t> prescriptionPatient;
+    std::vector<int32_t> prescriptionDate;
+    std::vector<int32_t> prescriptionMedicine;
+
+    // month span covered by any date column, as year * 12 + (month - 1)
+    int32_t firstMonth = 0;
+    int32_t lastMonth = -1;
+    std::time_t refreshedAt = 0;
+};
+
+struct DoctorUtilization {
+    int doctorID;
+    std::string name;
+    std::string specialization;
+    int64_t scheduled;
+    int64_t completed;
+    int64_t cancelled;
+    int64_t activeDays;
+    int64_t records;
+};
+
+struct MonthlyVolume {
+    int month;  // yyyymm
+    int64_t appointments;
+    int64_t records;
+    int64_t prescriptions;
+};
+
+struct MonthlyCancellations {
+    int month;  // yyyymm
+    int64_t appointments;
+    int64_t cancelled;
+};
+
+// Keeps an AnalyticsSnapshot refreshed from a private read-only connection on
+// a background thread, so admin reporting never touches the connection used
+// for bookings. Reports run over whichever snapshot is current when called.
+class AnalyticsEngine {
+private:
+    static AnalyticsEngine* instance;
+
+    std::shared_ptr<const AnalyticsSnapshot> snapshot;
+    mutable std::mutex snapshotMutex;
+
+    std::thread worker;
+    std::mutex workerMutex;
+    std::condition_variable workerSignal;
+    bool running = false;
+    int refreshIntervalSeconds = 60;
+    int64_t lastDataVersion = -1;
+
+    AnalyticsEngine() = default;
+    void refreshLoop();
+    static std::shared_ptr<AnalyticsSnapshot> loadSnapshot(sqlite3* hot);
+    // std::invalid_argument when a non-empty bound is not a date
+    static void dateBounds(const std::string& startDate, const std::string& endDate, int32_t& from, int32_t& to);
+
+public:
+    ~AnalyticsEngine();
+    static AnalyticsEngine& getInstance();
+
+    void start(int refreshIntervalSeconds = 60);
+    void stop();
+    void refresh();
+
+    std::shared_ptr<const AnalyticsSnapshot> getSnapshot() const;
+
+    // Date bounds are inclusive "YYYY-MM-DD" strings; empty means unbounded,
+    // anything else throws std::invalid_argument.
+    std::vector<DoctorUtilization> utilizationByDoctor(const std::string& startDate, const std::string& endDate) const;
+    std::vector<MonthlyVolume> monthlyVolume(const std::string& startDate, const std::string& endDate) const;
+    std::vector<MonthlyCancellations> cancellationsByMonth(const std::string& startDate, const std::string& endDate) const;
+
+    // "YYYY-MM-DD" -> yyyymmdd, 0 when the string is not a date
+    static int32_t encodeDate(const std::string& date);
+};
+
+#endif // ANALYTICS_H
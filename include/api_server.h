@@ -2,6 +2,7 @@
 #define API_SERVER_H
 
 #include "crow.h"
+#include "hospital_app.h"
 #include "database_handler.h"
 #include "patient.h"
 #include "doctor.h"
@@ -20,6 +21,9 @@
 #include "record_api.h"
 #include "report_api.h"
 #include "admin_api.h"
+#include "search_api.h"
+#include "dashboard_api.h"
+#include "events_api.h"
 // #include "login_api.h"
 
 // inline void add_cors_headers(crow::response& res) {
@@ -34,12 +38,16 @@ public:
         setupRoutes();
     }
 
-    void run(int port = 8080) {
-        app.port(port).multithreaded().run();
+    void run(int port = 8080, unsigned httpThreads = 0) {
+        if (httpThreads > 0) {
+            app.port(port).concurrency(httpThreads).run();
+        } else {
+            app.port(port).multithreaded().run();
+        }
     }
 
 private:
-    crow::SimpleApp app;
+    HospitalApp app;
 
     void setupRoutes() {
         // Health check endpoint
@@ -68,6 +76,15 @@ private:
         // Admin endpoints
         registerAdminRoutes(app);
 
+        // Typeahead search endpoints
+        registerSearchRoutes(app);
+
+        // Dashboard summary endpoint
+        registerDashboardRoutes(app);
+
+        // Change feed (server-sent events)
+        registerEventRoutes(app);
+
         // login endpoints
         // registerLoginRoutes(app);
     }
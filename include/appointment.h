@@ -3,34 +3,41 @@
 
 #include <vector>
 #include <string>
+#include "entity_ref.h"
 
 class Doctor;
 class Patient;
 
+// Holds the patient and doctor by ID; they are loaded on first use.
 class Appointment {
 private:
     int appointmentID;
-    Patient* patient;
-    Doctor* doctor;
+    EntityRef<Patient> patient;
+    EntityRef<Doctor> doctor;
     std::string date;
     std::string time;
 
 public:
-    Appointment(int appointmentID, Patient* patient, Doctor* doctor, 
+    Appointment(int appointmentID, int patientID, int doctorID,
                 const std::string& date, const std::string& time);
     
     // inherited abstrac methods 
     bool saveToDatabase();
     bool deleteFromDatabase();
-    static Appointment* getAppointmentFromDatabase(int appointmentID); 
+    // Archived appointments are read-only, so only lookups for display ask
+    // for them.
+    static Appointment* getAppointmentFromDatabase(int appointmentID, bool includeArchived = false);
+    // These include archived appointments.
     static std::vector<Appointment*> getAppointmentsForPatient(int patientID);
     static std::vector<Appointment*> getAppointmentsForDoctor(int doctorID);
     static std::vector<Appointment*> getAllAppointmentsFromDatabase();
                 
     // Getters
     int getAppointmentID() const;
-    Patient* getPatient() const;
-    Doctor* getDoctor() const;
+    int getPatientID() const;
+    int getDoctorID() const;
+    const EntityRef<Patient>& getPatient() const;
+    const EntityRef<Doctor>& getDoctor() const;
     std::string getDate() const;
     std::string getTime() const;
 
@@ -0,0 +1,137 @@
+#ifndef ARCHIVE_MANAGER_H
+#define ARCHIVE_MANAGER_H
+
+#include <sqlite3.h>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ArchiveSettings {
+    std::string directory = "archive";
+    int horizonDays = 0;        // rows dated further back than this are archived; 0 disables the job
+    int intervalMinutes = 1440; // between archival runs
+    int batchRows = 500;        // rows moved per transaction, while the write lock is held
+};
+
+struct ArchiveStatus {
+    bool inProgress = false;
+    std::string archivedBefore; // rows dated before this may live in an archive file
+    std::vector<int> years;     // archive files present, oldest first
+    uint64_t appointmentsMoved = 0;
+    uint64_t recordsMoved = 0;
+    uint64_t runs = 0;
+    std::time_t lastRunAt = 0;
+    std::string lastError;      // empty when the most recent run succeeded
+};
+
+// Moves Appointments and MedicalRecords rows dated before the horizon into
+// one archive database per year, <directory>/hospital-archive-YYYY.db, on a
+// background thread with its own connection. Each batch is first copied into
+// the year's file and then deleted from the hot table, so a row is always
+// readable from at least one side; readers skip archive rows still present
+// in the hot table. The deletes leave the aggregate tables alone (see the
+// ArchiveInProgress guard in initializeDatabaseSchema), so counts keep
+// covering archived history. Archived records drop out of full-text search.
+// The deletes are reported to DatabaseHandler::recordExternalChanges, so
+// getDataVersion moves with them.
+//
+// archivedBefore only moves forward and is advanced before a run moves any
+// rows, so a date range entirely on or after it never needs the archive.
+class ArchiveManager {
+private:
+    static ArchiveManager* instance;
+
+    ArchiveSettings settings;
+    ArchiveStatus status;
+    std::set<int> years;
+    mutable std::mutex mutex;
+    std::condition_variable signal;
+    std::thread worker;
+    bool running = false;
+    bool requested = false;
+
+    ArchiveManager() = default;
+    void loadState();
+    void workerLoop();
+    void runArchival();
+    void advanceHorizon(sqlite3* conn, const std::string& cutoff);
+    uint64_t moveRows(sqlite3* conn, int tableIndex, int year, const std::string& cutoff, int batchRows);
+
+public:
+    ~ArchiveManager();
+    static ArchiveManager& getInstance();
+
+    // Loads the horizon and the archive files present; archives stay
+    // readable when settings.horizonDays is 0, only nothing new is moved.
+    void start(const ArchiveSettings& settings);
+    void stop();
+
+    // false when archival is disabled or a run is already queued or in progress
+    bool requestArchival();
+    ArchiveStatus getStatus() const;
+    ArchiveSettings getSettings() const;
+
+    std::string archivedBefore() const;
+    // Archive years holding rows dated in [from, to], newest first; empty
+    // when the range can be answered from the hot tables alone.
+    std::vector<int> yearsFor(const std::string& from, const std::string& to) const;
+    std::vector<int> allYears() const;
+    std::string pathFor(int year) const;
+
+    static std::string schemaFor(int year);
+    // Appointments and MedicalRecords
+    static bool isArchived(const std::string& table);
+    // The table as a FROM source: the hot table alone when years is empty or
+    // the table is never archived, otherwise a UNION ALL with its copies in
+    // those years, with the archive columns in the hot table's order.
+    static std::string unionSource(const std::string& table, const std::vector<int>& years);
+    // Only the archived rows of table in those (non-empty) years that are
+    // no longer in the hot table.
+    static std::string archivedSource(const std::string& table, const std::vector<int>& years);
+
+    // Attaches the archive files for years (newest first) to conn, as many
+    // as the connection's attach limit allows, and returns those attached.
+    std::vector<int> attach(sqlite3* conn, const std::vector<int>& years) const;
+    // For reads that may need every archive year, more than one connection
+    // can attach: calls read(conn, source) once per batch of years, newest
+    // first, each on a private read-only connection where source is
+    // archivedSource(table, batch). Stops early when read returns false.
+    // Rows moved while the batches are read can show up in the hot table
+    // and an archive both, so callers merge by key.
+    void readArchived(const std::string& table, std::vector<int> years,
+                      const std::function<bool(sqlite3*, const std::string&)>& read) const;
+};
+
+// A connection for one read over [from, to]. When the range reaches
+// archived dates, a private read-only connection is opened with the archive
+// years it needs attached; otherwise hot is used as is, or a private
+// read-only connection is opened when hot is null.
+class ArchiveScope {
+private:
+    sqlite3* conn = nullptr;
+    bool owned = false;
+    std::vector<int> years;     // attached, newest first
+    bool allAttached = true;
+
+public:
+    ArchiveScope(const std::string& from, const std::string& to, sqlite3* hot = nullptr);
+    ~ArchiveScope();
+    ArchiveScope(const ArchiveScope&) = delete;
+    ArchiveScope& operator=(const ArchiveScope&) = delete;
+
+    sqlite3* connection() const;
+    bool spansArchive() const;
+    // false when the range reaches more years than one connection can
+    // attach; the newest ones are attached
+    bool complete() const;
+    int oldestYear() const;
+    std::string source(const std::string& table) const;
+};
+
+#endif // ARCHIVE_MANAGER_H
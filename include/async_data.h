@@ -0,0 +1,29 @@
+#ifndef ASYNC_DATA_H
+#define ASYNC_DATA_H
+
+#include "task.h"
+#include "patient.h"
+#include "doctor.h"
+#include "appointment.h"
+#include "record.h"
+#include <memory>
+#include <vector>
+
+// Awaitable counterparts of the entity lookups and saves. Each call hops onto
+// the DbExecutor, runs the existing synchronous query there and hands back
+// owned objects, so coroutine handlers can issue independent lookups at the
+// same time (see whenAll) without blocking the thread they started on.
+class AsyncData {
+public:
+    static Task<std::unique_ptr<Patient>> loadPatient(int patientID);
+    static Task<std::unique_ptr<Doctor>> loadDoctor(int doctorID);
+    static Task<std::unique_ptr<Appointment>> loadAppointment(int appointmentID);
+    static Task<std::vector<std::unique_ptr<Appointment>>> loadAppointmentsForPatient(int patientID);
+    static Task<std::vector<std::unique_ptr<Appointment>>> loadAppointmentsForDoctor(int doctorID);
+
+    // The entity must stay alive until the returned task completes.
+    static Task<bool> save(Appointment& appointment);
+    static Task<bool> save(MedicalRecord& record);
+};
+
+#endif // ASYNC_DATA_H
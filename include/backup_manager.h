@@ -0,0 +1,68 @@
+#ifndef BACKUP_MANAGER_H
+#define BACKUP_MANAGER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct BackupSettings {
+    std::string directory = "backups";
+    int pagesPerStep = 64;      // pages copied per step, while the shared connection is held
+    int stepPauseMillis = 10;   // pause between steps so request threads get the connection
+    int intervalMinutes = 0;    // scheduled backups; 0 means on request only
+    int keep = 7;               // completed backups kept in directory; 0 keeps all
+};
+
+struct BackupStatus {
+    bool inProgress = false;
+    std::string path;           // current or most recent backup
+    int pagesTotal = 0;
+    int pagesRemaining = 0;
+    int steps = 0;
+    std::time_t startedAt = 0;
+    std::time_t finishedAt = 0;
+    std::string lastError;      // empty when the most recent backup succeeded
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+};
+
+// Copies the live database to <directory>/hospital-YYYYMMDD-HHMMSS.db with
+// the SQLite online backup API, a few pages at a time on a background thread.
+// The source is the shared connection itself: writes made through it during
+// a backup are carried into the copy rather than restarting it, and a step
+// that finds a write transaction open is retried after the pause. The copy is
+// written to a .partial file and renamed once complete.
+class BackupManager {
+private:
+    static BackupManager* instance;
+
+    BackupSettings settings;
+    BackupStatus status;
+    mutable std::mutex mutex;
+    std::condition_variable signal;
+    std::thread worker;
+    bool running = false;
+    bool requested = false;
+
+    BackupManager() = default;
+    void workerLoop();
+    void runBackup();
+    void pruneOldBackups(const std::string& directory, int keep);
+
+public:
+    ~BackupManager();
+    static BackupManager& getInstance();
+
+    void start(const BackupSettings& settings);
+    void stop();
+
+    // false when a backup is already queued or in progress
+    bool requestBackup();
+    BackupStatus getStatus() const;
+    BackupSettings getSettings() const;
+};
+
+#endif // BACKUP_MANAGER_H
@@ -0,0 +1,34 @@
+#ifndef BINARY_ENCODING_H
+#define BINARY_ENCODING_H
+
+#include <string>
+
+class ResponseBody;
+
+enum class BinaryFormat {
+    MsgPack,
+    Cbor
+};
+
+// Binary alternatives to the JSON bodies the routes build. Routes that fill a
+// ResponseBody are written straight to the binary form by encode. Routes that
+// still build crow::json::wvalue (single-entity reads, a few hundred bytes)
+// go through fromJson, a streaming transcoder: one pass over the JSON text
+// counts the members of every array and object, a second pass writes the
+// binary form with the smallest headers that fit.
+class BinaryEncoding {
+public:
+    // Picks a binary format from an Accept header, honouring q-values: q=0
+    // refuses a type, the highest q wins and ties go to the earlier entry. A
+    // binary type must be named explicitly and rank at least as high as JSON
+    // (application/json, application/* or */*). False means stay on JSON.
+    static bool negotiate(const std::string& accept, BinaryFormat& format);
+    static const char* contentType(BinaryFormat format);
+
+    static void encode(const ResponseBody& body, BinaryFormat format, std::string& out);
+
+    // Returns false (leaving out unspecified) if json is not valid JSON.
+    static bool fromJson(const std::string& json, BinaryFormat format, std::string& out);
+};
+
+#endif // BINARY_ENCODING_H
@@ -0,0 +1,88 @@
+#ifndef CHANGE_FEED_H
+#define CHANGE_FEED_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ChangeEvent {
+    uint64_t id;
+    std::string entity;  // "appointment" or "record"
+    std::string action;  // "created", "updated" or "deleted"
+    std::string data;    // compact JSON body
+};
+
+// In-process pub/sub behind GET /events. Save and delete paths publish change
+// events; each /events request is a subscriber with its own fixed-size ring
+// that the dispatcher thread drains into a server-sent events body. A
+// subscriber whose ring fills up is dropped and told to reset instead of
+// holding back the publisher. Recent events are also kept in a bounded
+// history so a reconnecting client resumes from its Last-Event-ID.
+class ChangeFeed {
+public:
+    using Deliver = std::function<void(const std::string& body)>;
+
+    static constexpr size_t kSubscriberBuffer = 64;
+    static constexpr size_t kHistorySize = 1024;
+    static constexpr size_t kMaxSubscribers = 512;
+    static constexpr int kPollSeconds = 25;
+    static constexpr int kRetryMillis = 1000;
+
+private:
+    struct Subscriber {
+        std::vector<std::shared_ptr<const ChangeEvent>> ring;
+        size_t head = 0;
+        size_t count = 0;
+        bool overflowed = false;
+        std::chrono::steady_clock::time_point deadline;
+        Deliver deliver;
+    };
+
+    static ChangeFeed* instance;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<const ChangeEvent>> history;
+    std::list<std::shared_ptr<Subscriber>> subscribers;
+    uint64_t lastID = 0;
+    uint64_t droppedSubscribers = 0;
+
+    std::thread dispatcher;
+    bool running = false;
+
+    ChangeFeed() = default;
+    void dispatchLoop();
+    // position is the newest event id the subscriber has accounted for; it
+    // becomes the client's Last-Event-ID on a reset or an empty poll.
+    static std::string render(const std::vector<std::shared_ptr<const ChangeEvent>>& events, bool reset,
+                              uint64_t position);
+
+public:
+    ~ChangeFeed();
+    static ChangeFeed& getInstance();
+
+    void start();
+    void stop();
+
+    void publish(const std::string& entity, const std::string& action, int entityID,
+                 int patientID, int doctorID, const std::string& date);
+
+    // Registers one long-poll subscriber. deliver runs exactly once with the
+    // event-stream body, either right away when history can be replayed or
+    // later from the dispatcher thread. Returns false when the subscriber
+    // limit is reached; deliver is not called in that case.
+    bool subscribe(bool resume, uint64_t lastEventID, Deliver deliver);
+
+    size_t subscriberCount();
+    uint64_t droppedCount();
+};
+
+#endif // CHANGE_FEED_H
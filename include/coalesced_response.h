@@ -0,0 +1,59 @@
+#ifndef COALESCED_RESPONSE_H
+#define COALESCED_RESPONSE_H
+
+#include "crow.h"
+#include "binary_encoding.h"
+#include "database_handler.h"
+#include "response_body.h"
+#include "single_flight.h"
+#include <functional>
+#include <string>
+
+// JSON unless the Accept header negotiates MessagePack or CBOR.
+inline const char* negotiatedContentType(const crow::request& req, bool& binary, BinaryFormat& format) {
+    binary = BinaryEncoding::negotiate(req.get_header_value("Accept"), format);
+    return binary ? BinaryEncoding::contentType(format) : "application/json";
+}
+
+inline std::string encodeBody(const ResponseBody& body, bool binary, BinaryFormat format) {
+    if (!binary) return body.dump();
+    std::string out;
+    body.encode(format, out);
+    return out;
+}
+
+// Writes a ResponseBody in the format the client asked for. The
+// ContentNegotiationMiddleware leaves these responses alone.
+inline crow::response encodedResponse(const crow::request& req, const ResponseBody& body, int code = 200) {
+    bool binary;
+    BinaryFormat format;
+    const char* contentType = negotiatedContentType(req, binary, format);
+
+    crow::response res(code, encodeBody(body, binary, format));
+    res.set_header("Content-Type", contentType);
+    res.add_header("Vary", "Accept");
+    return res;
+}
+
+// Serves a GET through SingleFlight. Requests for the same URL (path and
+// query string) and response format that arrive while the database is at the
+// same data version share one run of build and one encoded body.
+inline crow::response coalescedJsonResponse(const crow::request& req,
+                                            const std::function<ResponseBody()>& build) {
+    bool binary;
+    BinaryFormat format;
+    const char* contentType = negotiatedContentType(req, binary, format);
+
+    std::string key = req.raw_url + "@" + std::to_string(DatabaseHandler::getInstance().getDataVersion()) +
+                      "#" + contentType;
+    auto body = SingleFlight::getInstance().run(key, [&build, binary, format]() {
+        return encodeBody(build(), binary, format);
+    });
+
+    crow::response res(200, *body);
+    res.set_header("Content-Type", contentType);
+    res.add_header("Vary", "Accept");
+    return res;
+}
+
+#endif // COALESCED_RESPONSE_H
@@ -0,0 +1,50 @@
+#ifndef COMPRESSION_MIDDLEWARE_H
+#define COMPRESSION_MIDDLEWARE_H
+
+#include "crow.h"
+#include "response_compression.h"
+#include <string>
+
+// Tags successful GET responses with an ETag (answering If-None-Match with
+// 304) and compresses bodies over the configured size with the best coding
+// the client accepts. Coded variants get their own ETag suffix so caches do
+// not mix them up, while If-None-Match still matches any of them.
+struct CompressionMiddleware {
+    struct context {};
+
+    void before_handle(crow::request&, crow::response&, context&) {}
+
+    void after_handle(crow::request& req, crow::response& res, context&) {
+        if (res.body.empty() || !res.get_header_value("Content-Encoding").empty()) return;
+        const std::string& contentType = res.get_header_value("Content-Type");
+        if (!ResponseCompressor::isCompressible(contentType)) return;
+
+        std::string etag;
+        if (req.method == crow::HTTPMethod::Get && res.code == 200) {
+            etag = ResponseCompressor::etag(contentType, res.body);
+            if (ResponseCompressor::etagMatches(req.get_header_value("If-None-Match"), etag)) {
+                res.code = 304;
+                res.body.clear();
+                res.set_header("ETag", etag);
+                return;
+            }
+            res.set_header("ETag", etag);
+        }
+
+        auto& compressor = ResponseCompressor::getInstance();
+        if (res.body.size() < compressor.getSettings().minBytes) return;
+        res.add_header("Vary", "Accept-Encoding");
+
+        ContentCoding coding = ResponseCompressor::negotiate(req.get_header_value("Accept-Encoding"));
+        auto compressed = compressor.compress(res.body, coding, etag);
+        if (!compressed) return;
+
+        res.body = *compressed;
+        res.set_header("Content-Encoding", ResponseCompressor::codingName(coding));
+        if (!etag.empty()) {
+            res.set_header("ETag", etag.substr(0, etag.size() - 1) + "-" + ResponseCompressor::codingName(coding) + "\"");
+        }
+    }
+};
+
+#endif // COMPRESSION_MIDDLEWARE_H
@@ -0,0 +1,34 @@
+#ifndef CONTENT_NEGOTIATION_MIDDLEWARE_H
+#define CONTENT_NEGOTIATION_MIDDLEWARE_H
+
+#include "crow.h"
+#include "binary_encoding.h"
+#include <string>
+
+// Serves successful JSON responses as MessagePack or CBOR when the client's
+// Accept header asks for one. List routes build a ResponseBody and encode the
+// negotiated format themselves (encodedResponse sets Vary: Accept, which is
+// how they are recognised here). Routes that still build crow::json::wvalue
+// are transcoded here on the way out.
+struct ContentNegotiationMiddleware {
+    struct context {};
+
+    void before_handle(crow::request&, crow::response&, context&) {}
+
+    void after_handle(crow::request& req, crow::response& res, context&) {
+        if (res.code < 200 || res.code >= 300 || res.body.empty()) return;
+        if (res.get_header_value("Content-Type").find("application/json") != 0) return;
+        if (!res.get_header_value("Vary").empty()) return;
+
+        res.add_header("Vary", "Accept");
+        BinaryFormat format;
+        if (!BinaryEncoding::negotiate(req.get_header_value("Accept"), format)) return;
+
+        std::string encoded;
+        if (!BinaryEncoding::fromJson(res.body, format, encoded)) return;
+        res.body = std::move(encoded);
+        res.set_header("Content-Type", BinaryEncoding::contentType(format));
+    }
+};
+
+#endif // CONTENT_NEGOTIATION_MIDDLEWARE_H
@@ -0,0 +1,60 @@
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+struct DashboardAppointment {
+    int appointmentID;
+    int patientID;
+    std::string patientName;
+    int doctorID;
+    std::string doctorName;
+    std::string date;
+    std::string time;
+    std::string status;
+};
+
+struct DashboardDoctorLoad {
+    int doctorID;
+    std::string doctorName;
+    int today;
+    int nextSevenDays;
+};
+
+struct DashboardRecord {
+    int recordID;
+    int patientID;
+    std::string patientName;
+    std::string doctorName;
+    std::string diagnosis;
+    std::string date;
+};
+
+struct DashboardSummary {
+    std::string today;
+    int totalPatients = 0;
+    int totalDoctors = 0;
+    int totalAppointments = 0;
+    int totalRecords = 0;
+    std::map<std::string, int> appointmentsByStatus;
+    std::vector<DashboardAppointment> todaysAppointments;
+    std::vector<DashboardAppointment> upcomingAppointments;
+    std::vector<DashboardDoctorLoad> doctorLoad;
+    std::vector<DashboardRecord> recentRecords;
+};
+
+// Everything the front desk dashboard shows, in one call. Totals come from the
+// trigger-maintained aggregate tables and every list is a bounded index range
+// scan, so the cost does not grow with the size of the hospital's history.
+class Dashboard {
+public:
+    static const int kMaxTodaysAppointments = 200;
+    static const int kUpcomingAppointments = 5;
+    static const int kRecentRecords = 5;
+
+    static DashboardSummary getSummary();
+};
+
+#endif // DASHBOARD_H
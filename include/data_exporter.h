@@ -0,0 +1,48 @@
+#ifndef DATA_EXPORTER_H
+#define DATA_EXPORTER_H
+
+#include <memory>
+#include <string>
+
+// A finished export on disk; the file is removed with the last reference.
+class ExportFile {
+private:
+    std::string path;
+
+public:
+    explicit ExportFile(const std::string& path);
+    ~ExportFile();
+    ExportFile(const ExportFile&) = delete;
+    ExportFile& operator=(const ExportFile&) = delete;
+
+    const std::string& getPath() const;
+};
+
+// Writes a table export straight from a SQLite cursor into a spool file, one
+// row at a time through a fixed-size buffer, so memory stays flat no matter
+// how many rows match. The cursor runs on a private read-only connection, so
+// a long export never holds up the shared one. The route hands the file to
+// Crow, which streams it to the client in chunks, and keeps the ExportFile
+// alive until the response has been written.
+class DataExporter {
+public:
+    enum class Format { CSV, NDJSON };
+
+    static bool isExportableTable(const std::string& table);
+    static bool parseFormat(const std::string& name, Format& format);
+    static std::string contentType(Format format);
+
+    // Returns the finished spool file; nothing is left on disk when this
+    // throws. Dates are inclusive "YYYY-MM-DD" bounds and are ignored for
+    // tables without a date column.
+    static std::shared_ptr<ExportFile> exportTable(const std::string& table, Format format,
+                                   const std::string& startDate, const std::string& endDate);
+
+    static void setExportDirectory(const std::string& directory);
+
+private:
+    static std::string exportDirectory;
+    static void removeStaleExports();
+};
+
+#endif // DATA_EXPORTER_H
@@ -2,21 +2,96 @@
 #define DATABASEHANDLER_H
 
 #include <sqlite3.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <stdexcept>
+#include <thread>
+
+struct MaintenanceSettings {
+    int checkSeconds = 1;                          // how often the WAL is looked at
+    int idleSeconds = 5;                           // no commits for this long is an idle window
+    int64_t passiveCheckpointBytes = 4 << 20;      // WAL size that triggers a passive checkpoint
+    int64_t truncateCheckpointBytes = 64 << 20;    // WAL size that forces a truncate checkpoint
+    int optimizeMinutes = 60;                      // PRAGMA optimize, in the next idle window
+    int vacuumMinutes = 60;                        // incremental vacuum, in the next idle window
+    int vacuumPages = 512;                         // free pages returned per incremental vacuum
+};
+
+struct MaintenanceMetrics {
+    int64_t walBytes = 0;
+    int walFrames = 0;                 // frames in the WAL at the last checkpoint
+    int checkpointedFrames = 0;        // of those, frames copied back into the database
+    uint64_t passiveCheckpoints = 0;
+    uint64_t truncateCheckpoints = 0;
+    uint64_t busyCheckpoints = 0;      // checkpoints that could not finish because of readers
+    double lastCheckpointMillis = 0;
+    int64_t lastCheckpointAt = 0;      // unix time
+    uint64_t optimizeRuns = 0;
+    uint64_t vacuumRuns = 0;
+    int freelistPages = 0;
+};
 
 class DatabaseHandler {
 private:
     sqlite3* db;
+    std::string dbName;
     static DatabaseHandler* instance;
     DatabaseHandler(const std::string& dbName);
 
+    MaintenanceSettings maintenanceSettings;
+    MaintenanceMetrics maintenanceMetrics;
+    mutable std::mutex maintenanceMutex;
+    std::condition_variable maintenanceSignal;
+    std::thread maintenanceWorker;
+    bool maintenanceRunning = false;
+    void maintenanceLoop();
+
+    std::atomic<int64_t> externalChanges{0};
+
 public:
     ~DatabaseHandler();
     static DatabaseHandler& getInstance(const std::string& dbName = "hospital.db");
     sqlite3* getDatabase() const;
+    const std::string& getDatabaseName() const;
+
+    // Opens a separate read-only connection to the same database file for
+    // work that must stay off the shared connection. The caller owns it and
+    // releases it with sqlite3_close.
+    sqlite3* openReadOnlyConnection() const;
+
+    // Same, read-write, for background writers that must not hold the
+    // shared connection for long (archival, statistics rebuild). They report
+    // the rows they commit with recordExternalChanges.
+    sqlite3* openWriteConnection() const;
+    void recordExternalChanges(int64_t rows);
+
+    // Increases with every row written through the shared connection or
+    // reported by a writer on its own connection; equal values mean the data
+    // has not changed.
+    int64_t getDataVersion() const;
+
+    // Runs WAL checkpoints, PRAGMA optimize and incremental vacuum on a
+    // background thread over its own connection. Small WALs are checkpointed
+    // passively (never waiting on readers or writers); in idle windows, or
+    // once the WAL passes truncateCheckpointBytes, a truncate checkpoint
+    // copies everything back and resets the file to zero bytes.
+    void startMaintenance(const MaintenanceSettings& settings);
+    void stopMaintenance();
+    MaintenanceMetrics getMaintenanceMetrics() const;
 
     void execute(const std::string& sql);
+    // Ends the open transaction, if any. A statement stopped by its
+    // QueryBudget may already have rolled it back, and the rollback itself
+    // runs without a deadline so the shared connection is never left inside
+    // a transaction.
+    void rollback();
+    bool tableExists(const std::string& tableName);
+    // True when the table has no rows. tableName is spliced into the SQL, so
+    // pass only names from this codebase.
+    bool tableIsEmpty(const std::string& tableName);
     void initializeDatabase();
 };
 
@@ -0,0 +1,46 @@
+#ifndef DB_EXECUTOR_H
+#define DB_EXECUTOR_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool that runs database work off the HTTP worker threads. Route
+// handlers hand their body to submit() and return at once, so a slow query
+// ties up a DB thread rather than the thread parsing requests and serving
+// keep-alive connections. Queue growth is bounded upstream by the admission
+// limits, so the task queue itself is not capped.
+class DbExecutor {
+private:
+    static DbExecutor* instance;
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    bool running = false;
+    size_t busyWorkers = 0;
+
+    DbExecutor() = default;
+    void workerLoop();
+
+public:
+    ~DbExecutor();
+    static DbExecutor& getInstance();
+
+    void start(size_t threadCount);
+    void stop();
+
+    // Runs task on a pool thread; runs it inline when the pool is not started.
+    void submit(std::function<void()> task);
+
+    size_t threadCount();
+    size_t queuedCount();
+    size_t busyCount();
+};
+
+#endif // DB_EXECUTOR_H
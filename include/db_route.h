@@ -0,0 +1,288 @@
+#ifndef DB_ROUTE_H
+#define DB_ROUTE_H
+
+#include "crow.h"
+#include "admission_control.h"
+#include "cors_config.h"
+#include "db_executor.h"
+#include "query_budget.h"
+#include "response_compression.h"
+#include "task.h"
+#include <chrono>
+#include <exception>
+#include <tuple>
+#include <utility>
+
+// onDbExecutor adapts an ordinary route lambda, which returns a
+// crow::response, into an asynchronous Crow handler that runs the lambda on
+// the DbExecutor and completes the response from there:
+//
+//     CROW_ROUTE(app, "/patients/<int>")
+//     .methods("GET"_method)(onDbExecutor([](int id){ ... }));
+//
+// The request stays valid until the response is completed, so lambdas that
+// take the request by reference are fine.
+//
+// onCoroutine does the same for coroutine lambdas returning
+// Task<crow::response>; the coroutine decides where each step runs, usually
+// by awaiting AsyncData calls. Coroutine lambdas must not capture anything
+// and should take URL parameters by value, since their frame outlives the
+// call that created it.
+//
+// Both take an admission slot for the request's route class first. When the
+// class is saturated the request is parked in its admission queue, never on
+// the HTTP thread, and starts from whichever thread frees a slot; a request
+// the queue cannot take, or that waits too long, gets 503. The slot is given
+// back once the response has been completed.
+//
+// Both run under the QueryBudget of the request's route class, counted from
+// admission. The request's Budget is shared by every task working for it, so
+// a statement interrupted on any DB thread is seen when the response is
+// completed. A request whose budget ran out while it waited for a DB thread
+// gets 503 without touching the database; one whose statement was
+// interrupted gets 408, whatever the handler made of the failed statement.
+namespace db_route_detail {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename T>
+struct lambda_args : lambda_args<decltype(&T::operator())> {};
+
+template <typename C, typename R, typename... A>
+struct lambda_args<R (C::*)(A...) const> {
+    using type = std::tuple<A...>;
+};
+
+inline RouteClass routeClassOf(const crow::request& req) {
+    return AdmissionController::classify(crow::method_name(req.method), req.url);
+}
+
+inline crow::response budgetExceeded(RouteClass routeClass, bool inQueue) {
+    crow::json::wvalue error;
+    error["class"] = AdmissionController::className(routeClass);
+    error["budget_ms"] = QueryBudget::getInstance().getBudget(routeClass);
+    crow::response res;
+    if (inQueue) {
+        QueryBudget::getInstance().recordExpiredInQueue(routeClass);
+        error["error"] = "Server is busy, retry later";
+        res = crow::response(503, error);
+        int retryAfter = AdmissionController::getInstance().getLimits(routeClass).retryAfterSeconds;
+        res.set_header("Retry-After", std::to_string(retryAfter));
+    } else {
+        QueryBudget::getInstance().recordInterrupted(routeClass);
+        error["error"] = "Query exceeded its time budget";
+        res = crow::response(408, error);
+    }
+    add_cors_headers(res);
+    return res;
+}
+
+// An export stopped by the export budget (QueryBudget::exportBudget).
+inline crow::response exportBudgetExceeded() {
+    QueryBudget::getInstance().recordExportInterrupted();
+    crow::json::wvalue error;
+    error["error"] = "Export exceeded its time budget";
+    error["class"] = "export";
+    error["budget_ms"] = QueryBudget::getInstance().getExportBudget();
+    crow::response res(408, error);
+    add_cors_headers(res);
+    return res;
+}
+
+inline crow::response admissionRejected(RouteClass routeClass) {
+    crow::json::wvalue error;
+    error["error"] = "Server is busy, retry later";
+    error["class"] = AdmissionController::className(routeClass);
+    crow::response res(503, error);
+    int retryAfter = AdmissionController::getInstance().getLimits(routeClass).retryAfterSeconds;
+    res.set_header("Retry-After", std::to_string(retryAfter));
+    add_cors_headers(res);
+    return res;
+}
+
+// Completing the response runs the after_handle middleware (compression
+// included) before the slot goes back. A response that will be compressed is
+// completed on a compression thread, so the DB thread moves on to the next
+// query instead of spending tens of milliseconds in gzip or brotli.
+inline void finish(const crow::request& req, crow::response& res, RouteClass routeClass,
+                   Clock::time_point admittedAt) {
+    auto done = [&res, routeClass, admittedAt]() {
+        res.end();
+        AdmissionController::getInstance().release(routeClass, Clock::now() - admittedAt);
+    };
+    ResponseCompressor& compressor = ResponseCompressor::getInstance();
+    if (compressor.willCompress(req.get_header_value("Accept-Encoding"), res.get_header_value("Content-Type"),
+                                res.body.size())) {
+        compressor.submit(done);
+    } else {
+        done();
+    }
+}
+
+// Runs body(admittedAt, budget) under a new budget for the route class once
+// the request holds an admission slot: on this thread when startHere is set and a slot
+// is free now, otherwise on the DbExecutor.
+template <typename Body>
+void whenAdmitted(RouteClass routeClass, crow::response* pending, bool startHere, Body body) {
+    auto start = [routeClass](Body& body, bool here) {
+        Clock::time_point admittedAt = Clock::now();
+        QueryBudget::BudgetPtr budget = QueryBudget::getInstance().budgetFor(routeClass);
+        QueryBudget::Scope scope(budget);
+        if (here) {
+            body(admittedAt, budget);
+        } else {
+            DbExecutor::getInstance().submit([body, admittedAt, budget]() mutable { body(admittedAt, budget); });
+        }
+    };
+
+    auto outcome = AdmissionController::getInstance().admit(routeClass,
+        [routeClass, pending, body, start](bool admitted) mutable {
+            if (!admitted) {
+                *pending = admissionRejected(routeClass);
+                pending->end();
+                return;
+            }
+            // on the thread that freed the slot, which must not run the handler
+            start(body, false);
+        });
+
+    if (outcome == AdmissionController::Outcome::Admitted) {
+        start(body, startHere);
+    } else if (outcome == AdmissionController::Outcome::Rejected) {
+        *pending = admissionRejected(routeClass);
+        pending->end();
+    }
+}
+
+template <typename Run>
+void complete(const crow::request& req, crow::response& res, RouteClass routeClass, Clock::time_point admittedAt,
+              const QueryBudget::Budget& budget, Run&& run) {
+    crow::response result;
+    if (budget.expired()) {
+        result = budgetExceeded(routeClass, true);
+    } else {
+        try {
+            result = run();
+        } catch (const std::exception& e) {
+            result = crow::response(500, e.what());
+        }
+        if (budget.interrupted) {
+            result = budgetExceeded(routeClass, false);
+        }
+    }
+    res = std::move(result);
+    finish(req, res, routeClass, admittedAt);
+}
+
+template <typename F, typename Args>
+struct Adapter;
+
+template <typename F, typename... A>
+struct Adapter<F, std::tuple<A...>> {
+    F handler;
+
+    void operator()(const crow::request& req, crow::response& res, A... args) const {
+        F run = handler;
+        const crow::request* request = &req;
+        crow::response* pending = &res;
+        RouteClass routeClass = routeClassOf(req);
+        whenAdmitted(routeClass, pending, false,
+                     [run, request, pending, routeClass, args...](Clock::time_point admittedAt,
+                                                                  const QueryBudget::BudgetPtr& budget) {
+            complete(*request, *pending, routeClass, admittedAt, *budget, [&]() { return crow::response(run(args...)); });
+        });
+    }
+};
+
+template <typename F, typename... A>
+struct Adapter<F, std::tuple<const crow::request&, A...>> {
+    F handler;
+
+    void operator()(const crow::request& req, crow::response& res, A... args) const {
+        F run = handler;
+        const crow::request* request = &req;
+        crow::response* pending = &res;
+        RouteClass routeClass = routeClassOf(req);
+        whenAdmitted(routeClass, pending, false,
+                     [run, request, pending, routeClass, args...](Clock::time_point admittedAt,
+                                                                  const QueryBudget::BudgetPtr& budget) {
+            complete(*request, *pending, routeClass, admittedAt, *budget,
+                     [&]() { return crow::response(run(*request, args...)); });
+        });
+    }
+};
+
+// The task is lazy, so a request whose budget ran out in the admission queue
+// never starts its handler.
+inline DetachedTask completeWith(Task<crow::response> task, const crow::request* request, crow::response* pending,
+                                 RouteClass routeClass, Clock::time_point admittedAt, QueryBudget::BudgetPtr budget) {
+    crow::response result;
+    if (budget->expired()) {
+        result = budgetExceeded(routeClass, true);
+    } else {
+        try {
+            result = co_await task;
+        } catch (const std::exception& e) {
+            result = crow::response(500, e.what());
+        }
+        // whichever thread ran the statement, whenAll branches included
+        if (budget->interrupted) {
+            result = budgetExceeded(routeClass, false);
+        }
+    }
+    *pending = std::move(result);
+    finish(*request, *pending, routeClass, admittedAt);
+}
+
+// The coroutine starts on the HTTP thread when a slot is free, since its
+// first step usually just hands a query to the DbExecutor.
+template <typename F, typename Args>
+struct CoroutineAdapter;
+
+template <typename F, typename... A>
+struct CoroutineAdapter<F, std::tuple<A...>> {
+    F handler;
+
+    void operator()(const crow::request& req, crow::response& res, A... args) const {
+        F run = handler;
+        const crow::request* request = &req;
+        crow::response* pending = &res;
+        RouteClass routeClass = routeClassOf(req);
+        whenAdmitted(routeClass, pending, true,
+                     [run, request, pending, routeClass, args...](Clock::time_point admittedAt,
+                                                                  const QueryBudget::BudgetPtr& budget) {
+            completeWith(run(args...), request, pending, routeClass, admittedAt, budget);
+        });
+    }
+};
+
+template <typename F, typename... A>
+struct CoroutineAdapter<F, std::tuple<const crow::request&, A...>> {
+    F handler;
+
+    void operator()(const crow::request& req, crow::response& res, A... args) const {
+        F run = handler;
+        const crow::request* request = &req;
+        crow::response* pending = &res;
+        RouteClass routeClass = routeClassOf(req);
+        whenAdmitted(routeClass, pending, true,
+                     [run, request, pending, routeClass, args...](Clock::time_point admittedAt,
+                                                                  const QueryBudget::BudgetPtr& budget) {
+            completeWith(run(*request, args...), request, pending, routeClass, admittedAt, budget);
+        });
+    }
+};
+
+} // namespace db_route_detail
+
+template <typename F>
+db_route_detail::Adapter<F, typename db_route_detail::lambda_args<F>::type> onDbExecutor(F handler) {
+    return {std::move(handler)};
+}
+
+template <typename F>
+db_route_detail::CoroutineAdapter<F, typename db_route_detail::lambda_args<F>::type> onCoroutine(F handler) {
+    return {std::move(handler)};
+}
+
+#endif // DB_ROUTE_H
@@ -1,6 +1,7 @@
 #include <iostream>
 #include "database_handler.h"
-#include "api_server.h"
+#include <stdexcept>
+#include <string>
 
 void initializeDatabaseSchema(DatabaseHandler& dbHandler) {
     try {
@@ -102,6 +103,277 @@ void initializeDatabaseSchema(DatabaseHandler& dbHandler) {
                 FOREIGN KEY (doctorID) REFERENCES Doctors(doctorID) ON DELETE CASCADE
             );
         )");
+        // Per-patient, date-ordered access paths used by the history and
+        // timeline queries
+        dbHandler.execute("CREATE INDEX IF NOT EXISTS idx_appointments_patient_date "
+                          "ON Appointments (patientID, date, appointmentID);");
+        dbHandler.execute("CREATE INDEX IF NOT EXISTS idx_records_patient_date "
+                          "ON MedicalRecords (patientID, date, recordID);");
+        dbHandler.execute("CREATE INDEX IF NOT EXISTS idx_prescriptions_patient_date "
+                          "ON Prescriptions (patientID, date, prescriptionID);");
+        dbHandler.execute("CREATE INDEX IF NOT EXISTS idx_prescriptions_doctor_date "
+                          "ON Prescriptions (doctorID, date, prescriptionID);");
+        dbHandler.execute("CREATE INDEX IF NOT EXISTS idx_appointments_date "
+                          "ON Appointments (date, time);");
+        // date-range scans of records (exports, archival)
+        dbHandler.execute("CREATE INDEX IF NOT EXISTS idx_records_date "
+                          "ON MedicalRecords (date);");
+
+        // Aggregate tables maintained incrementally by the triggers below, so
+        // reports and dashboard counters never have to scan Appointments or
+        // MedicalRecords.
+        dbHandler.execute(R"(
+            CREATE TABLE IF NOT EXISTS PatientAppointmentStats (
+                patientID INTEGER PRIMARY KEY,
+                appointment_count INTEGER NOT NULL DEFAULT 0
+            );
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TABLE IF NOT EXISTS DoctorDailyAppointmentStats (
+                doctorID INTEGER NOT NULL,
+                date TEXT NOT NULL,
+                appointment_count INTEGER NOT NULL DEFAULT 0,
+                PRIMARY KEY (doctorID, date)
+            ) WITHOUT ROWID;
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TABLE IF NOT EXISTS AppointmentStatusStats (
+                status TEXT PRIMARY KEY,
+                appointment_count INTEGER NOT NULL DEFAULT 0
+            );
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TABLE IF NOT EXISTS DoctorRecordStats (
+                doctorID INTEGER PRIMARY KEY,
+                record_count INTEGER NOT NULL DEFAULT 0
+            );
+        )");
+
+        bool entityCountsExist = dbHandler.tableExists("EntityCounts");
+        dbHandler.execute(R"(
+            CREATE TABLE IF NOT EXISTS EntityCounts (
+                entity TEXT PRIMARY KEY,
+                total INTEGER NOT NULL DEFAULT 0
+            );
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS PatientCountInsert
+            AFTER INSERT ON Patients
+            BEGIN
+                INSERT INTO EntityCounts (entity, total) VALUES ('patients', 1)
+                ON CONFLICT(entity) DO UPDATE SET total = total + 1;
+            END;
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS PatientCountDelete
+            AFTER DELETE ON Patients
+            BEGIN
+                UPDATE EntityCounts SET total = total - 1 WHERE entity = 'patients';
+            END;
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS DoctorCountInsert
+            AFTER INSERT ON Doctors
+            BEGIN
+                INSERT INTO EntityCounts (entity, total) VALUES ('doctors', 1)
+                ON CONFLICT(entity) DO UPDATE SET total = total + 1;
+            END;
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS DoctorCountDelete
+            AFTER DELETE ON Doctors
+            BEGIN
+                UPDATE EntityCounts SET total = total - 1 WHERE entity = 'doctors';
+            END;
+        )");
+
+        if (!entityCountsExist) {
+            dbHandler.execute("INSERT INTO EntityCounts (entity, total) "
+                              "SELECT 'patients', COUNT(*) FROM Patients "
+                              "UNION ALL SELECT 'doctors', COUNT(*) FROM Doctors;");
+        }
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS AppointmentStatsInsert
+            AFTER INSERT ON Appointments
+            BEGIN
+                INSERT INTO PatientAppointmentStats (patientID, appointment_count)
+                VALUES (NEW.patientID, 1)
+                ON CONFLICT(patientID) DO UPDATE SET appointment_count = appointment_count + 1;
+
+                INSERT INTO DoctorDailyAppointmentStats (doctorID, date, appointment_count)
+                VALUES (NEW.doctorID, NEW.date, 1)
+                ON CONFLICT(doctorID, date) DO UPDATE SET appointment_count = appointment_count + 1;
+
+                INSERT INTO AppointmentStatusStats (status, appointment_count)
+                VALUES (NEW.status, 1)
+                ON CONFLICT(status) DO UPDATE SET appointment_count = appointment_count + 1;
+            END;
+        )");
+
+        // Rows dated before archived_before may have moved to the per-year
+        // archive files (see ArchiveManager). ArchiveInProgress only ever
+        // holds a row inside an archival transaction, where it tells the
+        // delete triggers that the row still counts.
+        dbHandler.execute(R"(
+            CREATE TABLE IF NOT EXISTS ArchiveState (
+                id INTEGER PRIMARY KEY CHECK (id = 1),
+                archived_before TEXT NOT NULL
+            );
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TABLE IF NOT EXISTS ArchiveInProgress (
+                active INTEGER NOT NULL
+            );
+        )");
+
+        // recreated so databases from before archival get the WHEN guard
+        dbHandler.execute("DROP TRIGGER IF EXISTS AppointmentStatsDelete;");
+        dbHandler.execute(R"(
+            CREATE TRIGGER AppointmentStatsDelete
+            AFTER DELETE ON Appointments
+            WHEN NOT EXISTS (SELECT 1 FROM ArchiveInProgress)
+            BEGIN
+                UPDATE PatientAppointmentStats SET appointment_count = appointment_count - 1
+                WHERE patientID = OLD.patientID;
+
+                UPDATE DoctorDailyAppointmentStats SET appointment_count = appointment_count - 1
+                WHERE doctorID = OLD.doctorID AND date = OLD.date;
+                DELETE FROM DoctorDailyAppointmentStats
+                WHERE doctorID = OLD.doctorID AND date = OLD.date AND appointment_count <= 0;
+
+                UPDATE AppointmentStatusStats SET appointment_count = appointment_count - 1
+                WHERE status = OLD.status;
+            END;
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS AppointmentStatsUpdate
+            AFTER UPDATE OF patientID, doctorID, date, status ON Appointments
+            BEGIN
+                UPDATE PatientAppointmentStats SET appointment_count = appointment_count - 1
+                WHERE patientID = OLD.patientID;
+                INSERT INTO PatientAppointmentStats (patientID, appointment_count)
+                VALUES (NEW.patientID, 1)
+                ON CONFLICT(patientID) DO UPDATE SET appointment_count = appointment_count + 1;
+
+                UPDATE DoctorDailyAppointmentStats SET appointment_count = appointment_count - 1
+                WHERE doctorID = OLD.doctorID AND date = OLD.date;
+                DELETE FROM DoctorDailyAppointmentStats
+                WHERE doctorID = OLD.doctorID AND date = OLD.date AND appointment_count <= 0;
+                INSERT INTO DoctorDailyAppointmentStats (doctorID, date, appointment_count)
+                VALUES (NEW.doctorID, NEW.date, 1)
+                ON CONFLICT(doctorID, date) DO UPDATE SET appointment_count = appointment_count + 1;
+
+                UPDATE AppointmentStatusStats SET appointment_count = appointment_count - 1
+                WHERE status = OLD.status;
+                INSERT INTO AppointmentStatusStats (status, appointment_count)
+                VALUES (NEW.status, 1)
+                ON CONFLICT(status) DO UPDATE SET appointment_count = appointment_count + 1;
+            END;
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS RecordStatsInsert
+            AFTER INSERT ON MedicalRecords
+            BEGIN
+                INSERT INTO DoctorRecordStats (doctorID, record_count)
+                VALUES (NEW.doctorID, 1)
+                ON CONFLICT(doctorID) DO UPDATE SET record_count = record_count + 1;
+            END;
+        )");
+
+        dbHandler.execute("DROP TRIGGER IF EXISTS RecordStatsDelete;");
+        dbHandler.execute(R"(
+            CREATE TRIGGER RecordStatsDelete
+            AFTER DELETE ON MedicalRecords
+            WHEN NOT EXISTS (SELECT 1 FROM ArchiveInProgress)
+            BEGIN
+                UPDATE DoctorRecordStats SET record_count = record_count - 1
+                WHERE doctorID = OLD.doctorID;
+            END;
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS RecordStatsUpdate
+            AFTER UPDATE OF doctorID ON MedicalRecords
+            BEGIN
+                UPDATE DoctorRecordStats SET record_count = record_count - 1
+                WHERE doctorID = OLD.doctorID;
+                INSERT INTO DoctorRecordStats (doctorID, record_count)
+                VALUES (NEW.doctorID, 1)
+                ON CONFLICT(doctorID) DO UPDATE SET record_count = record_count + 1;
+            END;
+        )");
+
+        // Full-text index over diagnosis/treatment. It is an external-content
+        // table, so the text lives only in MedicalRecords; the triggers keep
+        // the index in step with every insert, update and delete.
+        bool searchIndexExists = dbHandler.tableExists("MedicalRecordsSearch");
+        dbHandler.execute(R"(
+            CREATE VIRTUAL TABLE IF NOT EXISTS MedicalRecordsSearch USING fts5(
+                diagnosis,
+                treatment,
+                content = 'MedicalRecords',
+                content_rowid = 'recordID',
+                tokenize = 'porter unicode61'
+            );
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS RecordSearchInsert
+            AFTER INSERT ON MedicalRecords
+            BEGIN
+                INSERT INTO MedicalRecordsSearch (rowid, diagnosis, treatment)
+                VALUES (NEW.recordID, NEW.diagnosis, NEW.treatment);
+            END;
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS RecordSearchDelete
+            AFTER DELETE ON MedicalRecords
+            BEGIN
+                INSERT INTO MedicalRecordsSearch (MedicalRecordsSearch, rowid, diagnosis, treatment)
+                VALUES ('delete', OLD.recordID, OLD.diagnosis, OLD.treatment);
+            END;
+        )");
+
+        dbHandler.execute(R"(
+            CREATE TRIGGER IF NOT EXISTS RecordSearchUpdate
+            AFTER UPDATE OF diagnosis, treatment ON MedicalRecords
+            BEGIN
+                INSERT INTO MedicalRecordsSearch (MedicalRecordsSearch, rowid, diagnosis, treatment)
+                VALUES ('delete', OLD.recordID, OLD.diagnosis, OLD.treatment);
+                INSERT INTO MedicalRecordsSearch (rowid, diagnosis, treatment)
+                VALUES (NEW.recordID, NEW.diagnosis, NEW.treatment);
+            END;
+        )");
+
+        // index records that predate the search table
+        if (!searchIndexExists) {
+            dbHandler.execute("INSERT INTO MedicalRecordsSearch (MedicalRecordsSearch) VALUES ('rebuild');");
+        }
+
+        // Responses to POSTs carrying an Idempotency-Key, so retries survive
+        // a restart (see IdempotencyStore)
+        dbHandler.execute(R"(
+            CREATE TABLE IF NOT EXISTS IdempotencyKeys (
+                idempotency_key TEXT PRIMARY KEY,
+                fingerprint INTEGER NOT NULL,
+                status_code INTEGER NOT NULL,
+                content_type TEXT NOT NULL,
+                body TEXT NOT NULL,
+                created_at INTEGER NOT NULL
+            ) WITHOUT ROWID;
+        )");
     } catch (const std::exception& e) {
         throw std::runtime_error("Schema creation failed: " + std::string(e.what()));
     }
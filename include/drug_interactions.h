@@ -0,0 +1,36 @@
+#ifndef DRUG_INTERACTIONS_H
+#define DRUG_INTERACTIONS_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct DrugInteraction {
+    std::string medicine;       // the already active medicine it clashes with
+    std::string severity;
+    std::string description;
+};
+
+// Pairwise interaction table loaded once from a local CSV file
+// (medicine_a,medicine_b,severity,description). Lookups are hash probes on
+// the normalized, order-independent pair, so checking a new prescription
+// against a patient's active list costs one probe per active medicine.
+class DrugInteractions {
+private:
+    static DrugInteractions* instance;
+    std::unordered_map<std::string, DrugInteraction> pairs;
+
+    DrugInteractions() = default;
+    static std::string normalize(const std::string& medicine);
+    static std::string pairKey(const std::string& a, const std::string& b);
+
+public:
+    static DrugInteractions& getInstance();
+
+    // Returns the number of pairs loaded; a missing file leaves the table empty.
+    size_t load(const std::string& path);
+    std::vector<DrugInteraction> check(const std::string& medicine,
+                                       const std::vector<std::string>& activeMedicines) const;
+};
+
+#endif // DRUG_INTERACTIONS_H
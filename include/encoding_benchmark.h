@@ -0,0 +1,33 @@
+#ifndef ENCODING_BENCHMARK_H
+#define ENCODING_BENCHMARK_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Shape of the synthetic list the benchmark serializes: rows shaped like the
+// GET /appointments response (two ids, three names, date and time).
+struct EncodingWorkload {
+    int rows = 5000;
+    int iterations = 50;
+};
+
+struct EncodingPathResult {
+    std::string path;
+    size_t bytes;       // size of one encoded body
+    double seconds;     // total over all iterations, build included
+};
+
+// Times each way a list route can produce its body: crow::json::wvalue dumped
+// to JSON (and transcoded to MessagePack/CBOR, the old path for binary
+// clients) against a ResponseBody written straight to each format.
+class EncodingBenchmark {
+public:
+    static std::vector<EncodingPathResult> run(const EncodingWorkload& workload);
+
+    // One row per path with bodies/s, MB/s and body size.
+    static void print(std::ostream& out, const EncodingWorkload& workload, const std::vector<EncodingPathResult>& results);
+};
+
+#endif // ENCODING_BENCHMARK_H
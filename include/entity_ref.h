@@ -0,0 +1,78 @@
+#ifndef ENTITY_REF_H
+#define ENTITY_REF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+// Process-wide cache of loaded entities, keyed by ID and shared between all
+// EntityRefs that point at the same row. Entries are immutable snapshots;
+// saving or deleting the entity must invalidate its entry. Instantiated for
+// Patient and Doctor in entity_ref.cpp.
+template <typename T>
+class EntityCache {
+public:
+    static constexpr size_t kMaxEntries = 8192;
+
+private:
+    static EntityCache* instance;
+
+    std::mutex mutex;
+    std::unordered_map<int, std::shared_ptr<const T>> entries;
+    uint64_t hits = 0;
+    uint64_t loads = 0;
+    uint64_t generation = 0;    // bumped by invalidate/clear
+
+    EntityCache() = default;
+    static T* load(int id);
+
+public:
+    static EntityCache& getInstance();
+
+    // nullptr when no such row exists; misses are not cached
+    std::shared_ptr<const T> get(int id);
+    void invalidate(int id);
+    void clear();
+
+    uint64_t hitCount();
+    uint64_t loadCount();
+};
+
+// A reference to a Patient or Doctor by ID. The ID is always available; the
+// entity itself is only loaded (through EntityCache) the first time it is
+// dereferenced, so code that needs nothing but the ID never queries its table.
+template <typename T>
+class EntityRef {
+private:
+    int id = 0;
+    mutable std::shared_ptr<const T> resolved;
+
+public:
+    EntityRef() = default;
+    explicit EntityRef(int id) : id(id) {}
+
+    int getID() const { return id; }
+    bool isResolved() const { return resolved != nullptr; }
+
+    // nullptr when the row does not exist
+    std::shared_ptr<const T> get() const {
+        if (!resolved && id != 0) {
+            resolved = EntityCache<T>::getInstance().get(id);
+        }
+        return resolved;
+    }
+
+    const T* operator->() const {
+        const T* target = get().get();
+        if (!target) {
+            throw std::runtime_error("Referenced entity " + std::to_string(id) + " not found");
+        }
+        return target;
+    }
+};
+
+#endif // ENTITY_REF_H
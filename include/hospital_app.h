@@ -0,0 +1,19 @@
+#ifndef HOSPITAL_APP_H
+#define HOSPITAL_APP_H
+
+#include "crow.h"
+#include "compression_middleware.h"
+#include "content_negotiation_middleware.h"
+#include "idempotency_middleware.h"
+#include "static_files_middleware.h"
+
+// Static client files are answered before anything else. Admission is not a
+// middleware: the db_route.h adapters take the slot, because a request
+// waiting for one must not hold the HTTP thread. after_handle runs in reverse
+// order, so the idempotency store records JSON, content negotiation encodes
+// both fresh and replayed responses for the caller, and compression sees the
+// final bytes while the request still holds its admission slot.
+using HospitalApp = crow::App<StaticFilesMiddleware, CompressionMiddleware,
+                              ContentNegotiationMiddleware, IdempotencyMiddleware>;
+
+#endif // HOSPITAL_APP_H
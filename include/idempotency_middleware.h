@@ -0,0 +1,75 @@
+#ifndef IDEMPOTENCY_MIDDLEWARE_H
+#define IDEMPOTENCY_MIDDLEWARE_H
+
+#include "crow.h"
+#include "idempotency_store.h"
+#include "cors_config.h"
+#include <string>
+
+// Honours the Idempotency-Key header on the create endpoints clients retry.
+// The first request with a key runs normally and its response is recorded
+// when it completes; repeats get that response back without reaching the
+// handler. Server errors are not recorded, so a retry after one runs again.
+struct IdempotencyMiddleware {
+    struct context {
+        std::string key;
+        bool owner = false;
+    };
+
+    static bool appliesTo(const crow::request& req) {
+        return req.method == crow::HTTPMethod::Post &&
+               (req.url == "/appointments" || req.url == "/patients" || req.url == "/records");
+    }
+
+    void before_handle(crow::request& req, crow::response& res, context& ctx) {
+        if (!appliesTo(req)) return;
+        const std::string& key = req.get_header_value("Idempotency-Key");
+        if (key.empty()) return;
+
+        if (key.size() > 255) {
+            res = crow::response(400, "Idempotency-Key is too long");
+            add_cors_headers(res);
+            res.end();
+            return;
+        }
+
+        StoredResponse stored;
+        uint64_t fingerprint = IdempotencyStore::fingerprint(crow::method_name(req.method), req.url, req.body);
+        switch (IdempotencyStore::getInstance().begin(key, fingerprint, stored)) {
+            case IdempotencyStore::Outcome::Proceed:
+                ctx.key = key;
+                ctx.owner = true;
+                return;
+            case IdempotencyStore::Outcome::Replay:
+                res = crow::response(stored.code, stored.body);
+                if (!stored.contentType.empty()) {
+                    res.set_header("Content-Type", stored.contentType);
+                }
+                res.set_header("Idempotent-Replayed", "true");
+                break;
+            case IdempotencyStore::Outcome::InProgress:
+                res = crow::response(409, "A request with this Idempotency-Key is still being processed");
+                res.set_header("Retry-After", "1");
+                break;
+            case IdempotencyStore::Outcome::Mismatch:
+                res = crow::response(422, "Idempotency-Key was already used for a different request");
+                break;
+        }
+        add_cors_headers(res);
+        res.end();
+    }
+
+    void after_handle(crow::request&, crow::response& res, context& ctx) {
+        if (!ctx.owner) return;
+        ctx.owner = false;
+
+        auto& store = IdempotencyStore::getInstance();
+        if (res.code >= 500) {
+            store.abandon(ctx.key);
+            return;
+        }
+        store.complete(ctx.key, {res.code, res.get_header_value("Content-Type"), res.body});
+    }
+};
+
+#endif // IDEMPOTENCY_MIDDLEWARE_H
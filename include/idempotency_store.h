@@ -0,0 +1,79 @@
+#ifndef IDEMPOTENCY_STORE_H
+#define IDEMPOTENCY_STORE_H
+
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+struct StoredResponse {
+    int code = 0;
+    std::string contentType;
+    std::string body;
+};
+
+// Remembers the response to each POST sent with an Idempotency-Key so a
+// retried request gets the original answer instead of writing again. Keys
+// live in a sharded in-memory table with a TTL and a per-shard size cap;
+// completed responses are also written to the IdempotencyKeys table and
+// loaded back at startup, so a retry that lands after a restart is still
+// recognised. begin() runs on the HTTP thread and never touches SQLite.
+// Keys still in flight are never evicted for size; completed ones pushed
+// out by the cap are forgotten until the next restart.
+class IdempotencyStore {
+public:
+    enum class Outcome {
+        Proceed,     // first time: caller runs the request, then complete or abandon
+        Replay,      // finished before: send the stored response
+        InProgress,  // the original is still running
+        Mismatch     // the key was already used for a different request
+    };
+
+    static constexpr int kShards = 16;
+    static constexpr size_t kMaxEntriesPerShard = 4096;
+    static constexpr std::time_t kTtlSeconds = 24 * 60 * 60;
+
+private:
+    struct Entry {
+        uint64_t fingerprint;
+        bool completed;
+        StoredResponse response;
+        std::time_t createdAt;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        std::deque<std::pair<std::time_t, std::string>> order;  // insertion order, for expiry
+    };
+
+    static IdempotencyStore* instance;
+    Shard shards[kShards];
+    std::mutex sweepMutex;
+    std::time_t lastSweep = 0;
+
+    IdempotencyStore() = default;
+    Shard& shardFor(const std::string& key);
+    void evict(Shard& shard, std::time_t now);
+    void persist(const std::string& key, const Entry& entry);
+    void sweepPersisted(std::time_t now);
+
+public:
+    static IdempotencyStore& getInstance();
+
+    // Loads the persisted keys still within the TTL; call once at startup,
+    // before requests are served.
+    void load();
+
+    static uint64_t fingerprint(const std::string& method, const std::string& url, const std::string& body);
+
+    Outcome begin(const std::string& key, uint64_t fingerprint, StoredResponse& replay);
+    void complete(const std::string& key, const StoredResponse& response);
+    // Forget an in-progress key, e.g. after a server error, so a retry runs again.
+    void abandon(const std::string& key);
+};
+
+#endif // IDEMPOTENCY_STORE_H
@@ -0,0 +1,42 @@
+#ifndef MEMORY_STORAGE_ENGINE_H
+#define MEMORY_STORAGE_ENGINE_H
+
+#include "storage_engine.h"
+#include <memory>
+
+// StorageEngine that keeps every table in process memory. Each table is a
+// hash map split into lock stripes by key, so writers to different rows do
+// not contend, plus secondary indexes with their own locks: hash indexes on
+// the patient/doctor/user ID columns and ordered indexes on the date, status,
+// type and created_at columns, which also serve between(). Nothing is
+// persisted and the schema's CHECK and foreign key constraints are not
+// enforced; use copyFrom to load from or snapshot to a SqliteStorageEngine
+// on a database file, which does enforce them.
+class MemoryStorageEngine : public StorageEngine {
+private:
+    std::unique_ptr<UserRepository> userRepository;
+    std::unique_ptr<PatientRepository> patientRepository;
+    std::unique_ptr<DoctorRepository> doctorRepository;
+    std::unique_ptr<AppointmentRepository> appointmentRepository;
+    std::unique_ptr<MedicalRecordRepository> recordRepository;
+    std::unique_ptr<PrescriptionRepository> prescriptionRepository;
+    std::unique_ptr<ReportRepository> reportRepository;
+
+public:
+    MemoryStorageEngine();
+    ~MemoryStorageEngine() override;
+
+    std::string name() const override;
+
+    UserRepository& users() override;
+    PatientRepository& patients() override;
+    DoctorRepository& doctors() override;
+    AppointmentRepository& appointments() override;
+    MedicalRecordRepository& records() override;
+    PrescriptionRepository& prescriptions() override;
+    ReportRepository& reports() override;
+
+    void transaction(const std::function<void()>& work) override;
+};
+
+#endif // MEMORY_STORAGE_ENGINE_H
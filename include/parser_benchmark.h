@@ -0,0 +1,30 @@
+#ifndef PARSER_BENCHMARK_H
+#define PARSER_BENCHMARK_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct ParserWorkload {
+    int iterations = 200000;    // per body
+};
+
+struct ParserBodyResult {
+    std::string body;           // which request body
+    size_t bytes;
+    double crowSeconds;         // crow::json::load plus the same field checks
+    double cursorSeconds;       // parseRequest into the typed request
+};
+
+// Decodes the write-endpoint bodies the way the handlers did before typed
+// requests (crow::json::load, then has()/t() checks and s()/i() reads) and
+// with parseRequest, and times both on the same bytes.
+class ParserBenchmark {
+public:
+    static std::vector<ParserBodyResult> run(const ParserWorkload& workload);
+
+    // One row per body with decodes/s for each parser and the speedup.
+    static void print(std::ostream& out, const ParserWorkload& workload, const std::vector<ParserBodyResult>& results);
+};
+
+#endif // PARSER_BENCHMARK_H
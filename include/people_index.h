@@ -0,0 +1,57 @@
+#ifndef PEOPLE_INDEX_H
+#define PEOPLE_INDEX_H
+
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct PersonEntry {
+    int userID;
+    int roleID;         // patientID or doctorID, 0 if the role row is missing
+    std::string type;   // "patient" or "doctor"
+    std::string name;
+    std::string contact;
+};
+
+// In-memory typeahead index over the names and contacts of patients and
+// doctors. Keys are kept lower-cased in an ordered set, so a prefix lookup
+// is one O(log n) seek followed by a scan of the matches only. Every word of
+// a name is indexed, so "smi" finds "Jane Smith".
+//
+// The index is loaded once at startup and then kept current by the entity
+// save paths and Admin::manageUser.
+class PeopleIndex {
+private:
+    static PeopleIndex* instance;
+
+    std::unordered_map<int, PersonEntry> people;
+    std::set<std::pair<std::string, int>> keys;
+    mutable std::shared_mutex mutex;
+
+    PeopleIndex() = default;
+    static std::vector<std::string> keysFor(const PersonEntry& person);
+    void insertLocked(const PersonEntry& person);
+    void eraseLocked(int userID);
+
+public:
+    static PeopleIndex& getInstance();
+
+    void rebuild();
+    // roleID 0 keeps whatever role ID is already indexed for the user
+    void upsert(int userID, int roleID, const std::string& type,
+                const std::string& name, const std::string& contact);
+    void updateName(int userID, const std::string& name);
+    void updateContact(int userID, const std::string& contact);
+    void remove(int userID);
+
+    // type filters to "patient" or "doctor"; empty means both
+    std::vector<PersonEntry> search(const std::string& prefix, const std::string& type, size_t limit) const;
+    size_t size() const;
+
+    static bool isIndexedType(const std::string& type);
+};
+
+#endif // PEOPLE_INDEX_H
@@ -0,0 +1,38 @@
+#ifndef PRESCRIPTION_H
+#define PRESCRIPTION_H
+
+#include <string>
+#include <vector>
+
+class Prescription {
+private:
+    int prescriptionID;
+    int doctorID;
+    int patientID;
+    std::string medicine;
+    std::string dosage;
+    std::string date;
+
+public:
+    Prescription(int prescriptionID, int doctorID, int patientID, const std::string& medicine,
+                 const std::string& dosage, const std::string& date);
+
+    // Both lists are newest first and read through the (patientID, date) and
+    // (doctorID, date) indexes.
+    static std::vector<Prescription*> getPrescriptionsForPatient(int patientID);
+    static std::vector<Prescription*> getPrescriptionsForDoctor(int doctorID);
+
+    // Distinct medicines prescribed to the patient in the last activeDays
+    // days, in one indexed range read.
+    static std::vector<std::string> getActiveMedicinesForPatient(int patientID, int activeDays = 90);
+
+    // Getters
+    int getPrescriptionID() const;
+    int getDoctorID() const;
+    int getPatientID() const;
+    std::string getMedicine() const;
+    std::string getDosage() const;
+    std::string getDate() const;
+};
+
+#endif // PRESCRIPTION_H
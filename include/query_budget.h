@@ -0,0 +1,113 @@
+#ifndef QUERY_BUDGET_H
+#define QUERY_BUDGET_H
+
+#include "admission_control.h"
+#include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct QueryBudgetMetrics {
+    std::string name;
+    int budgetMillis;           // 0 means unlimited
+    uint64_t expiredInQueue;    // budget spent before a DB thread picked the request up
+    uint64_t interrupted;       // a statement was stopped part way through
+};
+
+// Per-request time budgets for database work. A route's budget starts when
+// its handler is dispatched and is carried as a Budget on whichever thread
+// runs its queries (DbExecutor tasks inherit the Budget of the thread that
+// submitted them). install() puts a progress handler on a connection that
+// fails the running statement with SQLITE_INTERRUPT once the deadline of the
+// calling thread's Budget has passed. sqlite3_interrupt() is not used: it
+// stops every statement on the connection, and the shared connection serves
+// all requests.
+class QueryBudget {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Deadline and interrupted flag of one request. Every thread and task
+    // working for the request shares the same Budget, whenAll branches
+    // included, so a statement stopped on one DB thread is seen by
+    // whichever thread completes the response.
+    struct Budget {
+        const Clock::time_point deadline;
+        std::atomic<bool> interrupted{false};
+
+        explicit Budget(Clock::time_point deadline) : deadline(deadline) {}
+        bool expired() const;
+    };
+    using BudgetPtr = std::shared_ptr<Budget>;
+
+    // Makes budget the calling thread's until the scope ends; the previous
+    // one is restored afterwards.
+    class Scope {
+    private:
+        BudgetPtr previous;
+
+    public:
+        explicit Scope(BudgetPtr budget);
+        // A budget of its own, e.g. an unlimited one for cleanup work.
+        explicit Scope(Clock::time_point deadline);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    static QueryBudget* instance;
+
+    struct ClassState {
+        int budgetMillis = 0;
+        std::atomic<uint64_t> expiredInQueue{0};
+        std::atomic<uint64_t> interrupted{0};
+    };
+
+    mutable std::mutex mutex;
+    ClassState states[3];
+    ClassState exports;
+
+    QueryBudget();
+    ClassState& state(RouteClass routeClass);
+
+public:
+    static QueryBudget& getInstance();
+
+    // Checks the deadline every few hundred VM steps on this connection.
+    static void install(sqlite3* conn);
+
+    // The calling thread's budget; nullptr outside any Scope.
+    static BudgetPtr current();
+    // true once the calling thread's deadline has passed
+    static bool expired();
+    // true when a statement of the calling thread's request was stopped by
+    // its deadline, on this thread or another
+    static bool interrupted();
+
+    // millis <= 0 lifts the budget; Exempt routes never have one
+    void setBudget(RouteClass routeClass, int millis);
+    int getBudget(RouteClass routeClass);
+    // Clock::time_point::max() when the class has no budget
+    Clock::time_point deadlineFor(RouteClass routeClass);
+    // A new request's budget, counted from now.
+    BudgetPtr budgetFor(RouteClass routeClass);
+
+    // Exports spool whole tables to disk and may run far longer than a
+    // Bulk request, so their statements run under a budget of their own
+    // (10 minutes by default; millis <= 0 lifts it). Reported as "export".
+    void setExportBudget(int millis);
+    int getExportBudget();
+    // A new export's budget, counted from now.
+    BudgetPtr exportBudget();
+    void recordExportInterrupted();
+
+    void recordExpiredInQueue(RouteClass routeClass);
+    void recordInterrupted(RouteClass routeClass);
+    std::vector<QueryBudgetMetrics> metrics();
+};
+
+#endif // QUERY_BUDGET_H
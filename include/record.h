@@ -4,32 +4,61 @@
 #include <string>
 #include "patient.h"
 #include "doctor.h"
+#include "entity_ref.h"
 
+struct RecordSearchHit {
+    int recordID;
+    int patientID;
+    std::string patientName;
+    int doctorID;
+    std::string doctorName;
+    std::string diagnosis;
+    std::string treatment;
+    std::string date;
+    std::string snippet;    // HTML-escaped, matches wrapped in <b></b>
+    double score;
+};
+
+// Holds the patient and doctor by ID; they are loaded on first use.
 class MedicalRecord {
 private:
     int recordID;
-    Patient* patient;
-    Doctor* doctor;
+    EntityRef<Patient> patient;
+    EntityRef<Doctor> doctor;
     std::string diagnosis;
     std::string treatment;
     std::string date;
 
 public:
-    MedicalRecord(int recordID, Patient* patient, Doctor* doctor, 
+    // Dated today
+    MedicalRecord(int recordID, int patientID, int doctorID,
                   const std::string& diagnosis, const std::string& treatment);
+    MedicalRecord(int recordID, int patientID, int doctorID, const std::string& diagnosis,
+                  const std::string& treatment, const std::string& date);
     
     // inhreited methods declaration
     bool saveToDatabase();
     bool deleteFromDatabase();
-    static MedicalRecord* getRecordFromDatabase(int recordID);
+    // Archived records are read-only, so only lookups for display ask for
+    // them.
+    static MedicalRecord* getRecordFromDatabase(int recordID, bool includeArchived = false);
+    // Includes archived records.
     static std::vector<MedicalRecord*> getRecordsForPatient(int patientID);
     std::vector<MedicalRecord*> getRecordsByDoctor(int doctorID);
     static std::vector<MedicalRecord*> getAllRecordsFromDatabase();
+
+    // Full-text search over diagnosis and treatment, best match first.
+    // patientID/doctorID of 0 disable that filter. Fetches one row past
+    // limit so the caller can tell whether another page exists.
+    static std::vector<RecordSearchHit> searchRecords(const std::string& query, int patientID, int doctorID,
+                                                      int limit, int offset);
                   
     // Getters
     int getRecordID() const;
-    Patient* getPatient() const;
-    Doctor* getDoctor() const;
+    int getPatientID() const;
+    int getDoctorID() const;
+    const EntityRef<Patient>& getPatient() const;
+    const EntityRef<Doctor>& getDoctor() const;
     std::string getDiagnosis() const;
     std::string getTreatment() const;
     std::string getDate() const;
@@ -0,0 +1,146 @@
+#ifndef REQUEST_PARSER_H
+#define REQUEST_PARSER_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Typed bodies of the write endpoints. Each is decoded straight from the
+// request text by parseRequest below, field by field, with no JSON tree in
+// between. Unknown fields are skipped; a missing required field or a value
+// of the wrong type fails the parse with a message meant for a 400.
+
+struct PatientRequest {
+    std::string name;
+    std::string contact;
+    int age = 0;
+    std::string gender;
+};
+
+struct DoctorRequest {
+    std::string name;
+    std::string contact;
+    std::string specialization;
+};
+
+struct UserRequest {
+    std::string name;
+    std::string contact;
+    std::string type;
+};
+
+struct AppointmentRequest {
+    int patientID = 0;
+    int doctorID = 0;
+    std::string date;
+    std::string time;
+};
+
+struct AppointmentUpdate {
+    std::optional<std::string> date;
+    std::optional<std::string> time;
+};
+
+struct RecordRequest {
+    int patientID = 0;
+    int doctorID = 0;
+    std::string diagnosis;
+    std::string treatment;
+};
+
+struct PrescriptionRequest {
+    int patientID = 0;
+    std::string medicine;
+    std::string dosage;
+    bool overrideInteractions = false;
+};
+
+struct ReportRequest {
+    int doctorID = 0;
+    std::string details;
+};
+
+struct ReportGenerationRequest {
+    std::string reportType;
+    std::string startDate;
+    std::string endDate;
+};
+
+// Forward-only reader over one JSON document. Errors carry the field name
+// or the byte offset where the text went wrong.
+class JsonCursor {
+private:
+    const char* begin;
+    const char* p;
+    const char* end;
+    std::string key;
+    std::string error;
+
+    void skipSpace();
+    bool readString(std::string& out);
+    bool skipValue(int depth);
+
+public:
+    // Reads text in place, so it must outlive the cursor.
+    explicit JsonCursor(const std::string& text);
+    JsonCursor(std::string&&) = delete;
+
+    // Walks a top-level object, calling onField(key) with the cursor on each
+    // member's value. onField must consume the value (string, integer,
+    // boolean or skip) and return false to stop on an error.
+    template <typename OnField>
+    bool object(OnField&& onField);
+
+    bool string(std::string& out, const char* field);
+    bool integer(int& out, const char* field);
+    bool boolean(bool& out, const char* field);
+    bool skip();
+
+    bool syntaxError(const std::string& message);
+    bool fieldError(const std::string& message);
+    bool require(bool seen, const char* field);
+    const std::string& getError() const;
+};
+
+template <typename OnField>
+bool JsonCursor::object(OnField&& onField) {
+    skipSpace();
+    if (p >= end || *p != '{') return syntaxError("Request body must be a JSON object");
+    p++;
+    skipSpace();
+    if (p < end && *p == '}') {
+        p++;
+    } else {
+        while (true) {
+            skipSpace();
+            if (p >= end || *p != '"') return syntaxError("Expected a field name");
+            if (!readString(key)) return false;
+            skipSpace();
+            if (p >= end || *p != ':') return syntaxError("Expected ':'");
+            p++;
+            skipSpace();
+            if (!onField(std::string_view(key))) return false;
+            skipSpace();
+            if (p < end && *p == ',') { p++; continue; }
+            if (p < end && *p == '}') { p++; break; }
+            return syntaxError("Expected ',' or '}'");
+        }
+    }
+    skipSpace();
+    if (p != end) return syntaxError("Unexpected data after the JSON object");
+    return true;
+}
+
+// Each returns false with error set to a client-facing message.
+bool parseRequest(const std::string& body, PatientRequest& out, std::string& error);
+bool parseRequest(const std::string& body, DoctorRequest& out, std::string& error);
+bool parseRequest(const std::string& body, UserRequest& out, std::string& error);
+bool parseRequest(const std::string& body, AppointmentRequest& out, std::string& error);
+bool parseRequest(const std::string& body, AppointmentUpdate& out, std::string& error);
+bool parseRequest(const std::string& body, RecordRequest& out, std::string& error);
+bool parseRequest(const std::string& body, PrescriptionRequest& out, std::string& error);
+bool parseRequest(const std::string& body, ReportRequest& out, std::string& error);
+bool parseRequest(const std::string& body, ReportGenerationRequest& out, std::string& error);
+
+#endif // REQUEST_PARSER_H
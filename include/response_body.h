@@ -0,0 +1,71 @@
+#ifndef RESPONSE_BODY_H
+#define RESPONSE_BODY_H
+
+#include "binary_encoding.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Response document for the list routes. It is filled the same way as
+// crow::json::wvalue (result[i]["name"] = ...), but keeps its tree open so the
+// body can be written straight to JSON, MessagePack or CBOR instead of
+// dumping JSON and transcoding it. Object members keep insertion order.
+class ResponseBody {
+public:
+    enum class Type { Null, Boolean, Integer, Real, Text, List, Object };
+
+    ResponseBody() = default;
+
+    static ResponseBody list();
+    static ResponseBody object();
+
+    ResponseBody& operator=(std::nullptr_t);
+    ResponseBody& operator=(bool value);
+    ResponseBody& operator=(const char* value);
+    ResponseBody& operator=(std::string value);
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+    ResponseBody& operator=(T value) {
+        reset(Type::Integer);
+        integer = static_cast<int64_t>(value);
+        return *this;
+    }
+
+    template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    ResponseBody& operator=(T value) {
+        reset(Type::Real);
+        real = static_cast<double>(value);
+        return *this;
+    }
+
+    // Turns the value into an object (or list) on first use, like wvalue.
+    ResponseBody& operator[](const std::string& key);
+    ResponseBody& operator[](size_t index);
+
+    Type getType() const { return type; }
+    bool getBoolean() const { return boolean; }
+    int64_t getInteger() const { return integer; }
+    double getReal() const { return real; }
+    const std::string& getText() const { return text; }
+    const std::vector<std::string>& getKeys() const { return keys; }
+    const std::vector<ResponseBody>& getItems() const { return items; }
+
+    std::string dump() const;
+    void dump(std::string& out) const;
+    void encode(BinaryFormat format, std::string& out) const;
+
+private:
+    Type type = Type::Null;
+    bool boolean = false;
+    int64_t integer = 0;
+    double real = 0;
+    std::string text;
+    std::vector<std::string> keys;      // objects only, parallel to items
+    std::vector<ResponseBody> items;
+
+    void reset(Type to);
+};
+
+#endif // RESPONSE_BODY_H
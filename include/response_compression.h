@@ -0,0 +1,117 @@
+#ifndef RESPONSE_COMPRESSION_H
+#define RESPONSE_COMPRESSION_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class ContentCoding {
+    Identity,
+    Gzip,
+    Brotli
+};
+
+struct CompressionSettings {
+    size_t minBytes = 1024;                  // smaller bodies go out as they are
+    int gzipLevel = 6;                       // 1 (fast) .. 9 (small)
+    int brotliQuality = 5;                   // 0 (fast) .. 11 (small)
+    size_t cacheBytes = 32 * 1024 * 1024;    // compressed bytes kept for ETag-stable bodies
+    // Threads that complete responses large enough to compress. With 0 the
+    // DB thread that finished the handler compresses (a 2 MB brotli pass is
+    // tens of milliseconds), so size HOSPX_DB_THREADS for that instead.
+    size_t threads = 2;
+};
+
+struct CompressionMetrics {
+    uint64_t compressed;
+    uint64_t cacheHits;
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+    size_t cachedEntries;
+    size_t cachedBytes;
+    size_t queued;             // responses waiting for a compression thread
+};
+
+// gzip and brotli encoding of response bodies. Bodies that carry an ETag are
+// the same bytes every time until the data changes, so their compressed form
+// is kept in a byte-bounded LRU keyed by ETag and coding and reused by later
+// requests instead of being compressed again.
+//
+// Compression runs in after_handle on whichever thread completes the
+// response. Routes on the DbExecutor hand responses that will be compressed
+// to this class's own threads (submit), so the CPU work does not hold a
+// database thread.
+class ResponseCompressor {
+private:
+    struct CacheEntry {
+        std::string key;
+        std::shared_ptr<const std::string> bytes;
+    };
+
+    static ResponseCompressor* instance;
+
+    std::mutex mutex;
+    CompressionSettings settings;
+    std::list<CacheEntry> lru;  // most recently used first
+    std::unordered_map<std::string, std::list<CacheEntry>::iterator> cache;
+    size_t cachedBytes = 0;
+    uint64_t compressedCount = 0;
+    uint64_t cacheHits = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+
+    std::mutex poolMutex;
+    std::condition_variable taskReady;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread> workers;
+    bool running = false;
+
+    ResponseCompressor() = default;
+    void workerLoop();
+    std::shared_ptr<const std::string> cached(const std::string& key);
+    void remember(const std::string& key, const std::shared_ptr<const std::string>& bytes);
+
+public:
+    static ResponseCompressor& getInstance();
+
+    // Best coding the Accept-Encoding header allows; brotli wins ties.
+    static ContentCoding negotiate(const std::string& acceptEncoding);
+    // Whether the header allows coding at all (q > 0, by name or wildcard).
+    static bool accepts(const std::string& acceptEncoding, ContentCoding coding);
+    static const char* codingName(ContentCoding coding);
+    static bool isCompressible(const std::string& contentType);
+    // Strong validator for a body, quoted as it goes in the ETag header.
+    static std::string etag(const std::string& contentType, const std::string& body);
+    // True when an If-None-Match header matches etag or one of its coded variants.
+    static bool etagMatches(const std::string& ifNoneMatch, const std::string& etag);
+
+    void configure(const CompressionSettings& settings);
+    CompressionSettings getSettings();
+
+    // Starts settings.threads compression threads; call after configure.
+    void start();
+    void stop();
+
+    // True when a response with these headers and size would be compressed,
+    // which is when it is worth completing it on a compression thread.
+    bool willCompress(const std::string& acceptEncoding, const std::string& contentType, size_t bytes);
+    // Runs task on a compression thread; inline when none are started.
+    void submit(std::function<void()> task);
+
+    // Compressed body, or nullptr when compression would not make it smaller.
+    // A non-empty etag makes the result cacheable.
+    std::shared_ptr<const std::string> compress(const std::string& body, ContentCoding coding, const std::string& etag);
+
+    CompressionMetrics metrics();
+};
+
+#endif // RESPONSE_COMPRESSION_H
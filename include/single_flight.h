@@ -0,0 +1,47 @@
+#ifndef SINGLE_FLIGHT_H
+#define SINGLE_FLIGHT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Collapses concurrent identical computations into one. The first caller for
+// a key runs the computation; callers arriving with the same key while it is
+// still running wait and receive the same result (or the same exception).
+// Nothing is kept once the flight lands, so this is not a cache: the key
+// should include whatever makes two requests interchangeable, such as the
+// database data version.
+class SingleFlight {
+private:
+    struct Call {
+        std::mutex mutex;
+        std::condition_variable landed;
+        bool done = false;
+        std::shared_ptr<const std::string> result;
+        std::exception_ptr error;
+    };
+
+    static SingleFlight* instance;
+
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<Call>> calls;
+    uint64_t executed = 0;
+    uint64_t coalesced = 0;
+
+    SingleFlight() = default;
+
+public:
+    static SingleFlight& getInstance();
+
+    std::shared_ptr<const std::string> run(const std::string& key, const std::function<std::string()>& compute);
+
+    uint64_t executedCount();
+    uint64_t coalescedCount();
+};
+
+#endif // SINGLE_FLIGHT_H
@@ -0,0 +1,38 @@
+#ifndef SQLITE_STORAGE_ENGINE_H
+#define SQLITE_STORAGE_ENGINE_H
+
+#include "storage_engine.h"
+#include <sqlite3.h>
+#include <memory>
+
+// StorageEngine over an open SQLite connection whose schema was created by
+// initializeDatabaseSchema. The connection is borrowed, not owned.
+class SqliteStorageEngine : public StorageEngine {
+private:
+    sqlite3* db;
+    std::unique_ptr<UserRepository> userRepository;
+    std::unique_ptr<PatientRepository> patientRepository;
+    std::unique_ptr<DoctorRepository> doctorRepository;
+    std::unique_ptr<AppointmentRepository> appointmentRepository;
+    std::unique_ptr<MedicalRecordRepository> recordRepository;
+    std::unique_ptr<PrescriptionRepository> prescriptionRepository;
+    std::unique_ptr<ReportRepository> reportRepository;
+
+public:
+    explicit SqliteStorageEngine(sqlite3* db);
+    ~SqliteStorageEngine() override;
+
+    std::string name() const override;
+
+    UserRepository& users() override;
+    PatientRepository& patients() override;
+    DoctorRepository& doctors() override;
+    AppointmentRepository& appointments() override;
+    MedicalRecordRepository& records() override;
+    PrescriptionRepository& prescriptions() override;
+    ReportRepository& reports() override;
+
+    void transaction(const std::function<void()>& work) override;
+};
+
+#endif // SQLITE_STORAGE_ENGINE_H
@@ -0,0 +1,55 @@
+#ifndef STATIC_FILES_H
+#define STATIC_FILES_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+struct StaticFile {
+    std::string path;          // on disk
+    std::string contentType;
+    std::string etag;          // quoted; size and mtime based
+    uintmax_t size = 0;
+    bool immutable = false;    // content-hashed build output, safe to cache forever
+
+    // Pre-compressed variants: foo.js.gz / foo.js.br from the build when they
+    // exist, otherwise written to the cache directory while the index is
+    // built. Empty when compressing would not make the file smaller.
+    std::string gzipPath;
+    std::string brotliPath;
+};
+
+// In-memory index of the built client bundle (client/dist). The directory is
+// walked once at startup; requests are answered from the index without
+// touching the filesystem until the file itself is streamed out. Every
+// variant, compressed ones included, is a file Crow can stream.
+class StaticFiles {
+private:
+    static StaticFiles* instance;
+
+    std::string root;
+    std::string cacheDirectory;
+    std::unordered_map<std::string, StaticFile> files;  // keyed by URL path, e.g. "/assets/index-3f9a1c.js"
+
+    StaticFiles() = default;
+
+public:
+    static StaticFiles& getInstance();
+
+    // Returns false (and serves nothing) when root is not a directory.
+    // Compressed variants the build did not ship are written under
+    // cacheDirectory, named by the source file's size and mtime so they are
+    // reused across restarts; variants no longer referenced are removed.
+    bool load(const std::string& root, const std::string& cacheDirectory);
+
+    // The file for a URL path, or nullptr.
+    const StaticFile* find(const std::string& urlPath) const;
+    // index.html, which browser navigations to client-side routes such as
+    // / or /patients/12 are answered with.
+    const StaticFile* appShell() const;
+
+    size_t fileCount() const;
+    uintmax_t totalBytes() const;
+};
+
+#endif // STATIC_FILES_H
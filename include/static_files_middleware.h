@@ -0,0 +1,80 @@
+#ifndef STATIC_FILES_MIDDLEWARE_H
+#define STATIC_FILES_MIDDLEWARE_H
+
+#include "crow.h"
+#include "static_files.h"
+#include "response_compression.h"
+#include <memory>
+#include <string>
+
+// Serves the built client from StaticFiles before routing, so the UI and the
+// API share one origin. Files are streamed from disk by Crow, compressed
+// variants included (from the build or the startup cache), picked by
+// Accept-Encoding with q-values honoured. Browser navigations to a
+// client-side route (Accept: text/html, no file extension) get index.html,
+// while fetch() calls to the same paths still reach the API handlers.
+//
+// Handlers that answer with a file of their own (admin exports) park it in
+// the context; Crow drops the context once the response has been written,
+// when the connection starts its next request or closes.
+struct StaticFilesMiddleware {
+    struct context {
+        std::shared_ptr<const void> servedFile;
+    };
+
+    static bool isNavigation(const crow::request& req) {
+        if (req.get_header_value("Accept").find("text/html") == std::string::npos) return false;
+        if (req.url.rfind("/admin/", 0) == 0 || req.url == "/events") return false;
+        size_t slash = req.url.rfind('/');
+        return req.url.find('.', slash) == std::string::npos;
+    }
+
+    void before_handle(crow::request& req, crow::response& res, context&) {
+        if (req.method != crow::HTTPMethod::Get) return;
+
+        const StaticFiles& files = StaticFiles::getInstance();
+        const StaticFile* file = files.find(req.url);
+        if (!file && isNavigation(req)) file = files.appShell();
+        if (!file) return;
+
+        res.set_header("Cache-Control", file->immutable ? "public, max-age=31536000, immutable" : "no-cache");
+        res.set_header("Vary", "Accept-Encoding");
+
+        if (ResponseCompressor::etagMatches(req.get_header_value("If-None-Match"), file->etag)) {
+            res.code = 304;
+            res.set_header("ETag", file->etag);
+            res.end();
+            return;
+        }
+
+        const std::string& acceptEncoding = req.get_header_value("Accept-Encoding");
+        ContentCoding coding = ResponseCompressor::negotiate(acceptEncoding);
+        if (coding == ContentCoding::Brotli && !file->brotliPath.empty()) {
+            serveFile(res, *file, file->brotliPath, "br");
+        } else if (ResponseCompressor::accepts(acceptEncoding, ContentCoding::Gzip) && !file->gzipPath.empty()) {
+            serveFile(res, *file, file->gzipPath, "gzip");
+        } else {
+            serveFile(res, *file, file->path, "");
+        }
+        res.end();
+    }
+
+    void after_handle(crow::request&, crow::response&, context&) {}
+
+private:
+    static std::string variantTag(const StaticFile& file, const std::string& coding) {
+        if (coding.empty()) return file.etag;
+        return file.etag.substr(0, file.etag.size() - 1) + "-" + coding + "\"";
+    }
+
+    // The index already checked the path, so skip Crow's sanitising stat.
+    static void serveFile(crow::response& res, const StaticFile& file, const std::string& path,
+                          const std::string& coding) {
+        res.set_static_file_info_unsafe(path);
+        res.set_header("Content-Type", file.contentType);
+        res.set_header("ETag", variantTag(file, coding));
+        if (!coding.empty()) res.set_header("Content-Encoding", coding);
+    }
+};
+
+#endif // STATIC_FILES_MIDDLEWARE_H
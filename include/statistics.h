@@ -0,0 +1,33 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+struct DoctorDailyCount {
+    int doctorID;
+    std::string date;
+    int appointmentCount;
+};
+
+// Read side of the aggregate tables kept up to date by the Appointments and
+// MedicalRecords triggers (see initializeDatabaseSchema). Every lookup here
+// is proportional to the size of its result, not to the size of the tables.
+class Statistics {
+public:
+    static int getAppointmentCountForPatient(int patientID);
+    static std::map<int, int> getAppointmentCountsByPatient();
+    static std::vector<DoctorDailyCount> getDoctorDailyCounts(int doctorID, const std::string& startDate,
+                                                              const std::string& endDate);
+    static std::map<std::string, int> getAppointmentStatusCounts();
+    static std::map<int, int> getRecordCountsByDoctor();
+    // "patients" or "doctors"
+    static int getEntityCount(const std::string& entity);
+
+    // Recompute every aggregate from the base tables, e.g. after a bulk import
+    // that bypassed the triggers.
+    static void rebuild();
+};
+
+#endif // STATISTICS_H
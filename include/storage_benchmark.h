@@ -0,0 +1,47 @@
+#ifndef STORAGE_BENCHMARK_H
+#define STORAGE_BENCHMARK_H
+
+#include "storage_engine.h"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Sizes of the synthetic hospital the benchmark loads and then queries.
+struct StorageWorkload {
+    int patients = 2000;
+    int doctors = 50;
+    int appointments = 20000;
+    int records = 10000;
+    int prescriptions = 10000;
+    int lookups = 20000;     // per read phase
+    int writes = 2000;       // per single-row write phase
+    int readerThreads = 4;
+    unsigned seed = 42;
+};
+
+struct StoragePhaseResult {
+    std::string phase;
+    int operations;
+    size_t rows;        // rows read or written; equal across engines for the same workload
+    double seconds;
+};
+
+struct StorageBenchmarkResult {
+    std::string engine;
+    std::vector<StoragePhaseResult> phases;
+};
+
+// Runs the same deterministic workload against any StorageEngine, which must
+// start out empty: a bulk load in one transaction, point and index lookups,
+// date-range scans, single-row inserts/updates/removes outside a transaction
+// (as the entity classes write), and lookups from several threads at once.
+class StorageBenchmark {
+public:
+    static StorageBenchmarkResult run(StorageEngine& engine, const StorageWorkload& workload);
+
+    // One row per phase, with a column of ops/s per engine.
+    static void print(std::ostream& out, const std::vector<StorageBenchmarkResult>& results);
+};
+
+#endif // STORAGE_BENCHMARK_H
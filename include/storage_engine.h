@@ -0,0 +1,112 @@
+#ifndef STORAGE_ENGINE_H
+#define STORAGE_ENGINE_H
+
+#include "tables.h"
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Row storage for one table described in tables.h. Rows are the descriptor's
+// tuples and are keyed by their first column. Results come back in key
+// order, except findRange, which orders by the ranged column and then key.
+//
+//     auto rows = engine.appointments().where<"patientID">(patientID);
+//     auto week = engine.appointments().between<"date">("2025-01-06", "2025-01-12");
+template <typename TableT>
+class Repository {
+public:
+    using Table = TableT;
+    using Row = typename TableT::Row;
+
+    virtual ~Repository() = default;
+
+    // Stores the row and returns its key; a key of 0 lets the backend assign
+    // one. Empty status and created_at columns get the schema's defaults
+    // ('scheduled' and the current UTC time) on every backend. Throws
+    // std::runtime_error when the row cannot be stored.
+    int insert(Row row);
+    // false when no row has the row's key
+    virtual bool update(const Row& row) = 0;
+    virtual bool remove(int key) = 0;
+    virtual std::optional<Row> find(int key) = 0;
+    virtual std::vector<Row> all() = 0;
+    virtual size_t count() = 0;
+
+    // Column positions as given by Table::indexOf. Throw
+    // std::invalid_argument when the column's type does not match the value.
+    virtual std::vector<Row> findEqual(int column, int value) = 0;
+    virtual std::vector<Row> findEqual(int column, const std::string& value) = 0;
+    // inclusive on both ends
+    virtual std::vector<Row> findRange(int column, const std::string& low, const std::string& high) = 0;
+
+    template <table::FixedString ColumnName>
+    std::vector<Row> where(int value) {
+        return findEqual(TableT::template indexOf<ColumnName>(), value);
+    }
+    template <table::FixedString ColumnName>
+    std::vector<Row> where(const std::string& value) {
+        return findEqual(TableT::template indexOf<ColumnName>(), value);
+    }
+    template <table::FixedString ColumnName>
+    std::vector<Row> between(const std::string& low, const std::string& high) {
+        return findRange(TableT::template indexOf<ColumnName>(), low, high);
+    }
+
+protected:
+    // The row has its defaults filled in.
+    virtual int insertRow(const Row& row) = 0;
+};
+
+using UserRepository = Repository<UsersTable>;
+using PatientRepository = Repository<PatientsTable>;
+using DoctorRepository = Repository<DoctorsTable>;
+using AppointmentRepository = Repository<AppointmentsFullTable>;
+using MedicalRecordRepository = Repository<MedicalRecordsFullTable>;
+using PrescriptionRepository = Repository<PrescriptionsTable>;
+using ReportRepository = Repository<ReportsFullTable>;
+
+// "YYYY-MM-DD HH:MM:SS" in UTC, as SQLite's CURRENT_TIMESTAMP writes it.
+std::string currentTimestamp();
+
+template <typename TableT>
+int Repository<TableT>::insert(Row row) {
+    constexpr int status = TableT::findColumn("status");
+    constexpr int createdAt = TableT::findColumn("created_at");
+    if constexpr (status >= 0) {
+        if (std::get<status>(row).empty()) std::get<status>(row) = "scheduled";
+    }
+    if constexpr (createdAt >= 0) {
+        if (std::get<createdAt>(row).empty()) std::get<createdAt>(row) = currentTimestamp();
+    }
+    return insertRow(row);
+}
+
+// A persistence backend: one repository per entity table, holding every
+// column of the schema in db_seed.h.
+class StorageEngine {
+public:
+    virtual ~StorageEngine() = default;
+
+    virtual std::string name() const = 0;
+
+    virtual UserRepository& users() = 0;
+    virtual PatientRepository& patients() = 0;
+    virtual DoctorRepository& doctors() = 0;
+    virtual AppointmentRepository& appointments() = 0;
+    virtual MedicalRecordRepository& records() = 0;
+    virtual PrescriptionRepository& prescriptions() = 0;
+    virtual ReportRepository& reports() = 0;
+
+    // Runs work as one unit where the backend supports it. The in-memory
+    // backend applies each write as it is made and has nothing to roll back.
+    virtual void transaction(const std::function<void()>& work) = 0;
+
+    // Inserts every row of source with its key preserved, parents first, in
+    // one transaction. This engine must be empty. Loads the in-memory backend
+    // from a database file and snapshots it back to one.
+    void copyFrom(StorageEngine& source);
+};
+
+#endif // STORAGE_ENGINE_H
@@ -0,0 +1,280 @@
+#ifndef TABLE_DESCRIPTOR_H
+#define TABLE_DESCRIPTOR_H
+
+#include <sqlite3.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Compile-time table descriptors. A table is declared once as a list of
+// typed columns (see tables.h); its INSERT/UPDATE/SELECT text is built at
+// compile time, and values are bound and rows decoded by code generated from
+// the column types, so a wrong type or a missing value is a compile error
+// rather than a misnumbered sqlite3_bind_* call.
+//
+//     using UsersTable = Table<"Users", Column<"userID", int>, Column<"name", std::string>>;
+//     int id = UsersTable::insert(db, name);
+//     auto [userID, name] = UsersTable::decode(stmt);
+namespace table {
+
+template <size_t N>
+struct FixedString {
+    char value[N] = {};
+
+    constexpr FixedString() = default;
+    constexpr FixedString(const char (&text)[N]) {
+        for (size_t i = 0; i < N; i++) value[i] = text[i];
+    }
+
+    static constexpr size_t size() { return N - 1; }
+    constexpr const char* c_str() const { return value; }
+    constexpr std::string_view view() const { return {value, N - 1}; }
+};
+
+template <size_t... Ns>
+constexpr auto concat(const FixedString<Ns>&... parts) {
+    FixedString<(Ns + ...) - sizeof...(Ns) + 1> out;
+    size_t at = 0;
+    auto append = [&](const auto& part) {
+        for (size_t i = 0; i < part.size(); i++) out.value[at++] = part.value[i];
+    };
+    (append(parts), ...);
+    return out;
+}
+
+template <FixedString Name, typename T>
+struct Column {
+    static constexpr auto name = Name;
+    using type = T;
+};
+
+// "p.a, p.b, p.c"
+template <FixedString Prefix, typename First, typename... Rest>
+constexpr auto columnList() {
+    if constexpr (sizeof...(Rest) == 0) {
+        return concat(Prefix, First::name);
+    } else {
+        return concat(Prefix, First::name, FixedString(", "), columnList<Prefix, Rest...>());
+    }
+}
+
+// "a = ?, b = ?"
+template <typename First, typename... Rest>
+constexpr auto assignmentList() {
+    if constexpr (sizeof...(Rest) == 0) {
+        return concat(First::name, FixedString(" = ?"));
+    } else {
+        return concat(First::name, FixedString(" = ?, "), assignmentList<Rest...>());
+    }
+}
+
+// "?, ?, ?"
+template <typename First, typename... Rest>
+constexpr auto placeholderList() {
+    if constexpr (sizeof...(Rest) == 0) {
+        return FixedString("?");
+    } else {
+        return concat(FixedString("?, "), placeholderList<Rest...>());
+    }
+}
+
+inline void bindValue(sqlite3_stmt* stmt, int index, int value) {
+    sqlite3_bind_int(stmt, index, value);
+}
+inline void bindValue(sqlite3_stmt* stmt, int index, int64_t value) {
+    sqlite3_bind_int64(stmt, index, value);
+}
+inline void bindValue(sqlite3_stmt* stmt, int index, double value) {
+    sqlite3_bind_double(stmt, index, value);
+}
+inline void bindValue(sqlite3_stmt* stmt, int index, const std::string& value) {
+    sqlite3_bind_text(stmt, index, value.c_str(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
+}
+
+template <typename T>
+T readColumn(sqlite3_stmt* stmt, int index);
+
+template <>
+inline int readColumn<int>(sqlite3_stmt* stmt, int index) {
+    return sqlite3_column_int(stmt, index);
+}
+template <>
+inline int64_t readColumn<int64_t>(sqlite3_stmt* stmt, int index) {
+    return sqlite3_column_int64(stmt, index);
+}
+template <>
+inline double readColumn<double>(sqlite3_stmt* stmt, int index) {
+    return sqlite3_column_double(stmt, index);
+}
+template <>
+inline std::string readColumn<std::string>(sqlite3_stmt* stmt, int index) {
+    const unsigned char* text = sqlite3_column_text(stmt, index);
+    if (!text) return std::string();
+    return std::string(reinterpret_cast<const char*>(text), sqlite3_column_bytes(stmt, index));
+}
+
+template <typename... T, size_t... I>
+std::tuple<T...> readColumns(sqlite3_stmt* stmt, int first, std::index_sequence<I...>) {
+    return std::tuple<T...>{readColumn<T>(stmt, first + static_cast<int>(I))...};
+}
+
+// Finalizes on scope exit so the throwing paths below cannot leak.
+class Statement {
+private:
+    sqlite3_stmt* stmt = nullptr;
+
+public:
+    Statement(sqlite3* db, const char* sql) {
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error(std::string("Failed to prepare statement: ") + sqlite3_errmsg(db));
+        }
+    }
+    ~Statement() { sqlite3_finalize(stmt); }
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+
+    sqlite3_stmt* get() const { return stmt; }
+
+    template <typename... V>
+    void bind(int first, const V&... values) {
+        int index = first;
+        (bindValue(stmt, index++, values), ...);
+    }
+
+    void run(sqlite3* db) {
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            throw std::runtime_error(std::string("Failed to execute statement: ") + sqlite3_errmsg(db));
+        }
+    }
+};
+
+// The first column is the primary key.
+template <FixedString Name, typename Key, typename... Columns>
+struct Table {
+    static constexpr auto name = Name;
+    using KeyType = typename Key::type;
+    using Row = std::tuple<typename Key::type, typename Columns::type...>;
+    using Values = std::tuple<typename Columns::type...>;
+    static constexpr int columnCount = 1 + sizeof...(Columns);
+
+    // Column lists for hand-written joins, e.g. columns<"p."> -> "p.patientID, p.userID, ..."
+    template <FixedString Prefix = "">
+    static constexpr auto columns = columnList<Prefix, Key, Columns...>();
+    template <FixedString Prefix = "">
+    static constexpr auto valueColumns = columnList<Prefix, Columns...>();
+
+    static constexpr auto insertSql = concat(FixedString("INSERT INTO "), Name, FixedString(" ("),
+                                             columnList<"", Columns...>(), FixedString(") VALUES ("),
+                                             placeholderList<Columns...>(), FixedString(");"));
+    static constexpr auto insertWithKeySql = concat(FixedString("INSERT INTO "), Name, FixedString(" ("),
+                                                    columnList<"", Key, Columns...>(), FixedString(") VALUES ("),
+                                                    placeholderList<Key, Columns...>(), FixedString(");"));
+    static constexpr auto updateSql = concat(FixedString("UPDATE "), Name, FixedString(" SET "),
+                                             assignmentList<Columns...>(), FixedString(" WHERE "), Key::name,
+                                             FixedString(" = ?;"));
+    static constexpr auto selectSql = concat(FixedString("SELECT "), columnList<"", Key, Columns...>(),
+                                             FixedString(" FROM "), Name);
+    static constexpr auto selectByKeySql = concat(selectSql, FixedString(" WHERE "), Key::name,
+                                                  FixedString(" = ?;"));
+    static constexpr auto deleteByKeySql = concat(FixedString("DELETE FROM "), Name, FixedString(" WHERE "),
+                                                  Key::name, FixedString(" = ?;"));
+
+    template <size_t I>
+    using ColumnAt = std::tuple_element_t<I, std::tuple<Key, Columns...>>;
+
+    static constexpr std::string_view columnNames[columnCount] = {Key::name.view(), Columns::name.view()...};
+
+    static constexpr int findColumn(std::string_view column) {
+        for (int i = 0; i < columnCount; i++) {
+            if (columnNames[i] == column) return i;
+        }
+        return -1;
+    }
+
+    template <typename V>
+    static constexpr bool columnHasType(int column) {
+        constexpr bool matches[columnCount] = {std::is_same_v<typename Key::type, V>,
+                                               std::is_same_v<typename Columns::type, V>...};
+        return column >= 0 && column < columnCount && matches[column];
+    }
+
+    // Position of a column in Row; a misspelt name is a compile error.
+    template <FixedString ColumnName>
+    static constexpr int indexOf() {
+        constexpr int index = findColumn(ColumnName.view());
+        static_assert(index >= 0, "no such column");
+        return index;
+    }
+
+    // Every column, followed by a WHERE/ORDER BY suffix:
+    // select<" WHERE patientID = ? ORDER BY date;">
+    template <FixedString Suffix>
+    static constexpr auto select = concat(selectSql, Suffix);
+
+    // Every column read from another source with the same columns, such as
+    // the union with an archive. Built per call, so only for sources known
+    // at run time.
+    static std::string selectFrom(const std::string& source) {
+        static constexpr auto head = concat(FixedString("SELECT "), columnList<"", Key, Columns...>(),
+                                            FixedString(" FROM "));
+        return head.c_str() + source;
+    }
+
+    // Lets SQLite assign the key and returns it. Throws std::runtime_error.
+    static int64_t insert(sqlite3* db, const typename Columns::type&... values) {
+        Statement stmt(db, insertSql.c_str());
+        stmt.bind(1, values...);
+        stmt.run(db);
+        return sqlite3_last_insert_rowid(db);
+    }
+
+    static void insertWithKey(sqlite3* db, const KeyType& key, const typename Columns::type&... values) {
+        Statement stmt(db, insertWithKeySql.c_str());
+        stmt.bind(1, key, values...);
+        stmt.run(db);
+    }
+
+    // Returns whether a row was updated.
+    static bool update(sqlite3* db, const KeyType& key, const typename Columns::type&... values) {
+        Statement stmt(db, updateSql.c_str());
+        stmt.bind(1, values..., key);
+        stmt.run(db);
+        return sqlite3_changes(db) > 0;
+    }
+
+    // Returns whether a row was deleted.
+    static bool remove(sqlite3* db, const KeyType& key) {
+        Statement stmt(db, deleteByKeySql.c_str());
+        stmt.bind(1, key);
+        stmt.run(db);
+        return sqlite3_changes(db) > 0;
+    }
+
+    static std::optional<Row> findByKey(sqlite3* db, const KeyType& key) {
+        Statement stmt(db, selectByKeySql.c_str());
+        stmt.bind(1, key);
+        if (sqlite3_step(stmt.get()) != SQLITE_ROW) return std::nullopt;
+        return decode(stmt.get());
+    }
+
+    // Decodes a row selected with `columns`, starting at result column first.
+    static Row decode(sqlite3_stmt* stmt, int first = 0) {
+        return readColumns<typename Key::type, typename Columns::type...>(
+            stmt, first, std::make_index_sequence<columnCount>());
+    }
+
+    // Decodes a row selected with `valueColumns` (everything but the key).
+    static Values decodeValues(sqlite3_stmt* stmt, int first = 0) {
+        return readColumns<typename Columns::type...>(stmt, first, std::index_sequence_for<Columns...>());
+    }
+};
+
+} // namespace table
+
+#endif // TABLE_DESCRIPTOR_H
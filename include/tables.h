@@ -0,0 +1,92 @@
+#ifndef TABLES_H
+#define TABLES_H
+
+#include "table_descriptor.h"
+#include <string>
+
+// Column layouts of the entity tables created in db_seed.h. Only the
+// columns the entity classes read and write are listed; defaulted columns
+// such as Appointments.status and created_at are left to SQLite.
+using table::Column;
+
+using UsersTable = table::Table<"Users",
+    Column<"userID", int>,
+    Column<"name", std::string>,
+    Column<"contact", std::string>,
+    Column<"type", std::string>>;
+
+using PatientsTable = table::Table<"Patients",
+    Column<"patientID", int>,
+    Column<"userID", int>,
+    Column<"age", int>,
+    Column<"gender", std::string>>;
+
+using DoctorsTable = table::Table<"Doctors",
+    Column<"doctorID", int>,
+    Column<"userID", int>,
+    Column<"specialization", std::string>>;
+
+using ReceptionistsTable = table::Table<"Receptionists",
+    Column<"receptionistID", int>,
+    Column<"userID", int>>;
+
+using AdminsTable = table::Table<"Admins",
+    Column<"adminID", int>,
+    Column<"userID", int>>;
+
+using AppointmentsTable = table::Table<"Appointments",
+    Column<"appointmentID", int>,
+    Column<"patientID", int>,
+    Column<"doctorID", int>,
+    Column<"date", std::string>,
+    Column<"time", std::string>>;
+
+using MedicalRecordsTable = table::Table<"MedicalRecords",
+    Column<"recordID", int>,
+    Column<"patientID", int>,
+    Column<"doctorID", int>,
+    Column<"diagnosis", std::string>,
+    Column<"treatment", std::string>,
+    Column<"date", std::string>>;
+
+using PrescriptionsTable = table::Table<"Prescriptions",
+    Column<"prescriptionID", int>,
+    Column<"doctorID", int>,
+    Column<"patientID", int>,
+    Column<"medicine", std::string>,
+    Column<"dosage", std::string>,
+    Column<"date", std::string>>;
+
+using ReportsTable = table::Table<"Reports",
+    Column<"reportID", int>,
+    Column<"doctorID", int>,
+    Column<"details", std::string>>;
+
+// Whole rows, defaulted columns included, for the storage engines in
+// storage_engine.h. A NULL notes column reads back as an empty string.
+using AppointmentsFullTable = table::Table<"Appointments",
+    Column<"appointmentID", int>,
+    Column<"patientID", int>,
+    Column<"doctorID", int>,
+    Column<"date", std::string>,
+    Column<"time", std::string>,
+    Column<"status", std::string>,
+    Column<"notes", std::string>,
+    Column<"created_at", std::string>>;
+
+using MedicalRecordsFullTable = table::Table<"MedicalRecords",
+    Column<"recordID", int>,
+    Column<"patientID", int>,
+    Column<"doctorID", int>,
+    Column<"diagnosis", std::string>,
+    Column<"treatment", std::string>,
+    Column<"date", std::string>,
+    Column<"created_at", std::string>>;
+
+using ReportsFullTable = table::Table<"Reports",
+    Column<"reportID", int>,
+    Column<"doctorID", int>,
+    Column<"details", std::string>,
+    Column<"created_at", std::string>>;
+
+#endif // TABLES_H
@@ -0,0 +1,191 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include "db_executor.h"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+// Lazy coroutine result. A Task<T> does nothing until it is co_awaited; the
+// awaiting coroutine is resumed, through symmetric transfer, on whichever
+// thread the task finishes on.
+template <typename T>
+class Task;
+
+namespace task_detail {
+
+template <typename Promise>
+struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        auto continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+    void await_resume() noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+} // namespace task_detail
+
+template <typename T>
+class Task {
+public:
+    struct promise_type : task_detail::PromiseBase {
+        std::optional<T> value;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        task_detail::FinalAwaiter<promise_type> final_suspend() noexcept { return {}; }
+        void return_value(T result) { value.emplace(std::move(result)); }
+    };
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { if (handle) handle.destroy(); }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    T await_resume() {
+        if (handle.promise().error) std::rethrow_exception(handle.promise().error);
+        return std::move(*handle.promise().value);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    std::coroutine_handle<promise_type> handle;
+};
+
+template <>
+class Task<void> {
+public:
+    struct promise_type : task_detail::PromiseBase {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        task_detail::FinalAwaiter<promise_type> final_suspend() noexcept { return {}; }
+        void return_void() {}
+    };
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { if (handle) handle.destroy(); }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    void await_resume() {
+        if (handle.promise().error) std::rethrow_exception(handle.promise().error);
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Eagerly started coroutine that owns itself and frees its frame when it
+// finishes. Used to drive a Task from ordinary code, e.g. a route handler.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// co_await resumeOnDbExecutor() moves the rest of the coroutine onto a
+// DbExecutor thread; no thread is held while the work waits in the queue.
+struct DbExecutorAwaiter {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        DbExecutor::getInstance().submit([handle]() { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+};
+
+inline DbExecutorAwaiter resumeOnDbExecutor() {
+    return {};
+}
+
+namespace task_detail {
+
+struct WhenAllLatch {
+    // one count per child plus one for the awaiting coroutine itself
+    std::atomic<size_t> remaining;
+    std::coroutine_handle<> awaiting;
+
+    explicit WhenAllLatch(size_t children) : remaining(children + 1) {}
+
+    void arrive() {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            awaiting.resume();
+        }
+    }
+};
+
+template <typename T>
+DetachedTask runChild(Task<T>& task, std::optional<T>& slot, std::exception_ptr& error, WhenAllLatch& latch) {
+    try {
+        slot.emplace(co_await task);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    latch.arrive();
+}
+
+template <typename... T>
+struct WhenAllAwaiter {
+    std::tuple<Task<T>...> tasks;
+    std::tuple<std::optional<T>...> results;
+    std::exception_ptr errors[sizeof...(T)];
+    WhenAllLatch latch{sizeof...(T)};
+
+    explicit WhenAllAwaiter(std::tuple<Task<T>...> tasks) : tasks(std::move(tasks)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        latch.awaiting = handle;
+        startAll(std::index_sequence_for<T...>{});
+        // Stay running if every child already finished synchronously.
+        return latch.remaining.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+
+    std::tuple<T...> await_resume() {
+        for (auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+        return std::apply([](auto&... slot) { return std::tuple<T...>(std::move(*slot)...); }, results);
+    }
+
+    template <size_t... I>
+    void startAll(std::index_sequence<I...>) {
+        (runChild(std::get<I>(tasks), std::get<I>(results), errors[I], latch), ...);
+    }
+};
+
+} // namespace task_detail
+
+// Runs independent tasks concurrently and resumes once all have finished,
+// yielding their results in order. The first stored exception is rethrown.
+template <typename... T>
+Task<std::tuple<T...>> whenAll(Task<T>... tasks) {
+    co_return co_await task_detail::WhenAllAwaiter<T...>(std::tuple<Task<T>...>(std::move(tasks)...));
+}
+
+#endif // TASK_H
@@ -0,0 +1,41 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <string>
+#include <vector>
+
+struct TimelineEvent {
+    std::string type;       // "appointment", "record" or "prescription"
+    int id;
+    std::string date;
+    int doctorID;
+    std::string doctorName;
+    std::string title;      // appointment time, diagnosis or medicine
+    std::string detail;     // appointment status, treatment or dosage
+};
+
+// Position in a patient's timeline. Events are ordered newest first by
+// date, then appointment < record < prescription, then newest id first.
+struct TimelineCursor {
+    std::string date;
+    int typeRank;
+    int id;
+
+    std::string encode() const;
+    static bool decode(const std::string& text, TimelineCursor& cursor);
+};
+
+class PatientTimeline {
+public:
+    // Reads one page of a patient's appointments, records and prescriptions
+    // as a single date-ordered list. Each source is read through its own
+    // (patientID, date) index in one read transaction and the three sorted
+    // streams are merged, so the page costs O(limit) rows per source. Pages
+    // that reach past the archive horizon also read the archive years.
+    // Returns false when the patient does not exist; nextCursor is left
+    // empty on the last page.
+    static bool getPage(int patientID, const TimelineCursor* after, int limit,
+                        std::vector<TimelineEvent>& events, std::string& nextCursor);
+};
+
+#endif // TIMELINE_H
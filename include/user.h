@@ -11,6 +11,10 @@ protected:
     std::string contact;
     std::string type;
 
+    // Inserts or updates this user's Users row, assigning userID on insert.
+    // Throws std::runtime_error; subclasses call it inside their transaction.
+    void writeUserRow();
+
 public:
     User(int id, const std::string& name, const std::string& contact, const std::string& type);
     virtual ~User() = default;
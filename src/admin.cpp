@@ -1,10 +1,14 @@
 #include "admin.h"
 #include "database_handler.h"
+#include "tables.h"
 #include "user.h"
 #include "doctor.h"
 #include "patient.h"
 #include "receptionist.h"
 #include "report.h"
+#include "people_index.h"
+#include "entity_ref.h"
+#include "archive_manager.h"
 #include <sqlite3.h>
 #include <iostream>
 #include <vector>
@@ -21,56 +25,38 @@ bool Admin::saveToDatabase() {
     }
 
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-
-    std::string sql = adminID == 0 ?
-        "INSERT INTO Admins (adminID, userID) VALUES (?, ?);" :
-        "UPDATE Admins SET userID = ? WHERE adminID = ?;";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+    try {
+        if (adminID == 0) {
+            adminID = userID; // Use userID as adminID for consistency
+            AdminsTable::insertWithKey(db, adminID, userID);
+        } else {
+            AdminsTable::update(db, adminID, userID);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error saving admin: " << e.what() << std::endl;
         return false;
     }
-
-    if (adminID == 0) {
-        adminID = userID; // Use userID as adminID for consistency
-        sqlite3_bind_int(stmt, 1, adminID);
-        sqlite3_bind_int(stmt, 2, userID);
-    } else {
-        sqlite3_bind_int(stmt, 1, userID);
-        sqlite3_bind_int(stmt, 2, adminID);
-    }
-
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    sqlite3_finalize(stmt);
-    return success;
+    return true;
 }
 
 Admin* Admin::getAdminFromDatabase(int adminID) {
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-
-    std::string sql = "SELECT a.userID, u.name, u.contact "
-                     "FROM Admins a JOIN Users u ON a.userID = u.userID "
-                     "WHERE a.adminID = ?;";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return nullptr;
-    }
-
-    sqlite3_bind_int(stmt, 1, adminID);
-
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        int userID = sqlite3_column_int(stmt, 0);
-        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        std::string contact = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-
-        sqlite3_finalize(stmt);
-        return new Admin(userID, name, contact, adminID);
+    static constexpr auto sql = table::concat(
+        table::FixedString("SELECT "), AdminsTable::columns<"a.">, table::FixedString(", "),
+        UsersTable::valueColumns<"u.">,
+        table::FixedString(" FROM Admins a JOIN Users u ON a.userID = u.userID WHERE a.adminID = ?;"));
+
+    try {
+        table::Statement stmt(db, sql.c_str());
+        stmt.bind(1, adminID);
+        if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            auto [id, userID] = AdminsTable::decode(stmt.get());
+            auto [name, contact, type] = UsersTable::decodeValues(stmt.get(), AdminsTable::columnCount);
+            return new Admin(userID, name, contact, id);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
     }
-
-    sqlite3_finalize(stmt);
     return nullptr;
 }
 
@@ -106,6 +92,20 @@ void Admin::manageUser(int userID, const std::string& action, const std::string&
     }
 
     sqlite3_finalize(stmt);
+
+    PeopleIndex& peopleIndex = PeopleIndex::getInstance();
+    if (action == "delete") {
+        peopleIndex.remove(userID);
+    } else if (action == "update_name") {
+        peopleIndex.updateName(userID, newValue);
+    } else {
+        peopleIndex.updateContact(userID, newValue);
+    }
+
+    // cached entities are keyed by patient/doctor ID, which need not match the
+    // user ID, so drop them all; user management is rare
+    EntityCache<Patient>::getInstance().clear();
+    EntityCache<Doctor>::getInstance().clear();
 }
 
 std::vector<Report> Admin::generateReports(const std::string& reportType, const std::string& startDate, const std::string& endDate) {
@@ -114,9 +114,17 @@ std::vector<Report> Admin::generateReports(const std::string& reportType, const
     sqlite3_stmt* stmt;
     std::string sql;
 
+    // the shared connection unless the range reaches archived appointments
+    std::unique_ptr<ArchiveScope> archive;
+
     if (reportType == "appointments") {
+        archive = std::make_unique<ArchiveScope>(startDate, endDate, db);
+        if (!archive->complete()) {
+            throw std::invalid_argument("Report range spans too many archive years");
+        }
+        db = archive->connection();
         sql = "SELECT a.appointmentID, a.date, a.time, p.name AS patient_name, d.name AS doctor_name "
-              "FROM Appointments a "
+              "FROM " + archive->source("Appointments") + " a "
               "JOIN Patients pt ON a.patientID = pt.patientID "
               "JOIN Users p ON pt.userID = p.userID "
               "JOIN Doctors dr ON a.doctorID = dr.doctorID "
@@ -124,11 +132,18 @@ std::vector<Report> Admin::generateReports(const std::string& reportType, const
               "WHERE a.date BETWEEN ? AND ? "
               "ORDER BY a.date, a.time;";
     } else if (reportType == "patients") {
-        sql = "SELECT p.patientID, u.name, u.contact, p.age, p.gender, COUNT(a.appointmentID) as appointment_count "
+        // appointment counts come from the trigger-maintained aggregate table
+        sql = "SELECT p.patientID, u.name, u.contact, p.age, p.gender, COALESCE(s.appointment_count, 0) "
               "FROM Patients p "
               "JOIN Users u ON p.userID = u.userID "
-              "LEFT JOIN Appointments a ON p.patientID = a.patientID "
-              "GROUP BY p.patientID;";
+              "LEFT JOIN PatientAppointmentStats s ON p.patientID = s.patientID;";
+    } else if (reportType == "doctor_daily") {
+        sql = "SELECT s.doctorID, s.date, u.name, s.appointment_count "
+              "FROM DoctorDailyAppointmentStats s "
+              "JOIN Doctors dr ON s.doctorID = dr.doctorID "
+              "JOIN Users u ON dr.userID = u.userID "
+              "WHERE s.date BETWEEN ? AND ? "
+              "ORDER BY s.date, s.doctorID;";
     } else {
         throw std::invalid_argument("Invalid report type");
     }
@@ -137,13 +152,18 @@ std::vector<Report> Admin::generateReports(const std::string& reportType, const
         throw std::runtime_error("Failed to prepare report statement");
     }
 
-    if (reportType == "appointments") {
+    if (reportType == "appointments" || reportType == "doctor_daily") {
         sqlite3_bind_text(stmt, 1, startDate.c_str(), -1, SQLITE_TRANSIENT);
         sqlite3_bind_text(stmt, 2, endDate.c_str(), -1, SQLITE_TRANSIENT);
     }
 
+    int rowNumber = 0;
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int reportID = sqlite3_column_int(stmt, 0);
+        rowNumber++;
+        // doctor_daily rows are keyed by (doctor, date), so the doctor ID
+        // repeats across rows; number them instead
+        int reportID = reportType == "doctor_daily" ? rowNumber : sqlite3_column_int(stmt, 0);
+        int doctorID = reportType == "doctor_daily" ? sqlite3_column_int(stmt, 0) : 0;
         std::string details;
     
         if (reportType == "appointments") {
@@ -157,10 +177,13 @@ std::vector<Report> Admin::generateReports(const std::string& reportType, const
                       " | Age: " + std::to_string(sqlite3_column_int(stmt, 3)) +
                       " | Gender: " + std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4))) +
                       " | Appointments: " + std::to_string(sqlite3_column_int(stmt, 5));
+        } else if (reportType == "doctor_daily") {
+            details = "Doctor: " + std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2))) +
+                      " | Date: " + std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1))) +
+                      " | Appointments: " + std::to_string(sqlite3_column_int(stmt, 3));
         }
     
-        // Provide a dummy doctorID if you don't have it
-        Report report(reportID, /*dummy*/ 0, details);
+        Report report(reportID, doctorID, details);
         reports.push_back(report);
     }
 
@@ -0,0 +1,223 @@
+#include "admission_control.h"
+#include <algorithm>
+
+AdmissionController* AdmissionController::instance = nullptr;
+
+namespace {
+
+bool startsWith(const std::string& value, const std::string& prefix) {
+    return value.compare(0, prefix.size(), prefix) == 0;
+}
+
+double averageMillis(std::chrono::steady_clock::duration total, uint64_t count) {
+    if (count == 0) return 0.0;
+    return std::chrono::duration<double, std::milli>(total).count() / count;
+}
+
+} // namespace
+
+AdmissionController::AdmissionController() {
+    // SQLite runs one writer at a time, so a handful of concurrent writes is
+    // enough; reads get more room, and bulk work is effectively serialised.
+    state(RouteClass::Read).limits = {16, 32, 2000, 1};
+    state(RouteClass::Write).limits = {4, 16, 5000, 2};
+    state(RouteClass::Bulk).limits = {1, 2, 1000, 30};
+}
+
+AdmissionController::~AdmissionController() {
+    stop();
+}
+
+AdmissionController& AdmissionController::getInstance() {
+    if (!instance) {
+        instance = new AdmissionController();
+    }
+    return *instance;
+}
+
+AdmissionController::ClassState& AdmissionController::state(RouteClass routeClass) {
+    return states[static_cast<int>(routeClass)];
+}
+
+RouteClass AdmissionController::classify(const std::string& method, const std::string& path) {
+    if (method == "OPTIONS" || path == "/" || path == "/events" || path == "/admin/metrics") {
+        return RouteClass::Exempt;
+    }
+
+    if (path == "/admin/generate-report" || path == "/admin/statistics/rebuild" ||
+        startsWith(path, "/admin/export/") || startsWith(path, "/admin/analytics/") ||
+        (method == "GET" && (path == "/records" || path == "/reports"))) {
+        return RouteClass::Bulk;
+    }
+
+    if (method == "GET" || method == "HEAD") {
+        return RouteClass::Read;
+    }
+    return RouteClass::Write;
+}
+
+const char* AdmissionController::className(RouteClass routeClass) {
+    switch (routeClass) {
+        case RouteClass::Read: return "read";
+        case RouteClass::Write: return "write";
+        case RouteClass::Bulk: return "bulk";
+        default: return "exempt";
+    }
+}
+
+void AdmissionController::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return;
+    running = true;
+    expiryWorker = std::thread(&AdmissionController::expiryLoop, this);
+}
+
+void AdmissionController::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    expirySignal.notify_all();
+    if (expiryWorker.joinable()) {
+        expiryWorker.join();
+    }
+}
+
+void AdmissionController::setLimits(RouteClass routeClass, const RouteClassLimits& limits) {
+    if (routeClass == RouteClass::Exempt) return;
+    std::vector<Resume> admitted, expired;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ClassState& s = state(routeClass);
+        s.limits = limits;
+        // a higher limit may free slots for requests already waiting
+        dispatchWaiters(s, Clock::now(), admitted, expired);
+    }
+    expirySignal.notify_all();
+    for (auto& resume : expired) resume(false);
+    for (auto& resume : admitted) resume(true);
+}
+
+RouteClassLimits AdmissionController::getLimits(RouteClass routeClass) {
+    if (routeClass == RouteClass::Exempt) return {0, 0, 0, 0};
+    std::lock_guard<std::mutex> lock(mutex);
+    return state(routeClass).limits;
+}
+
+void AdmissionController::dispatchWaiters(ClassState& s, Clock::time_point now, std::vector<Resume>& admitted,
+                                          std::vector<Resume>& expired) {
+    // waiters past their deadline are dropped wherever they sit in the queue
+    for (auto it = s.waiters.begin(); it != s.waiters.end();) {
+        if (it->deadline <= now) {
+            s.rejectedTimeout++;
+            expired.push_back(std::move(it->resume));
+            it = s.waiters.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    while (!s.waiters.empty() && s.inFlight < s.limits.maxConcurrent) {
+        Waiter& waiter = s.waiters.front();
+        s.inFlight++;
+        s.peakInFlight = std::max(s.peakInFlight, s.inFlight);
+        s.admitted++;
+        s.totalWait += now - waiter.queuedAt;
+        admitted.push_back(std::move(waiter.resume));
+        s.waiters.pop_front();
+    }
+}
+
+AdmissionController::Outcome AdmissionController::admit(RouteClass routeClass, Resume resume) {
+    if (routeClass == RouteClass::Exempt) return Outcome::Admitted;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ClassState& s = state(routeClass);
+
+        if (s.inFlight < s.limits.maxConcurrent && s.waiters.empty()) {
+            s.inFlight++;
+            s.peakInFlight = std::max(s.peakInFlight, s.inFlight);
+            s.admitted++;
+            return Outcome::Admitted;
+        }
+        if (static_cast<int>(s.waiters.size()) >= s.limits.maxQueued) {
+            s.rejectedQueueFull++;
+            return Outcome::Rejected;
+        }
+
+        Clock::time_point now = Clock::now();
+        s.waiters.push_back({std::move(resume), now, now + std::chrono::milliseconds(s.limits.maxWaitMillis)});
+        s.peakQueued = std::max(s.peakQueued, static_cast<int>(s.waiters.size()));
+    }
+    // the expiry thread may be sleeping past this waiter's deadline
+    expirySignal.notify_all();
+    return Outcome::Queued;
+}
+
+void AdmissionController::release(RouteClass routeClass, Clock::duration serviceTime) {
+    if (routeClass == RouteClass::Exempt) return;
+
+    std::vector<Resume> admitted, expired;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ClassState& s = state(routeClass);
+        s.inFlight--;
+        s.completed++;
+        s.totalService += serviceTime;
+        dispatchWaiters(s, Clock::now(), admitted, expired);
+    }
+    for (auto& resume : expired) resume(false);
+    for (auto& resume : admitted) resume(true);
+}
+
+void AdmissionController::expiryLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        Clock::time_point now = Clock::now();
+        Clock::time_point next = Clock::time_point::max();
+        std::vector<Resume> admitted, expired;
+        for (ClassState& s : states) {
+            dispatchWaiters(s, now, admitted, expired);
+            for (const Waiter& waiter : s.waiters) {
+                next = std::min(next, waiter.deadline);
+            }
+        }
+
+        if (!admitted.empty() || !expired.empty()) {
+            lock.unlock();
+            for (auto& resume : expired) resume(false);
+            for (auto& resume : admitted) resume(true);
+            lock.lock();
+            continue;
+        }
+
+        if (next == Clock::time_point::max()) {
+            expirySignal.wait(lock);
+        } else {
+            expirySignal.wait_until(lock, next);
+        }
+    }
+}
+
+std::vector<RouteClassMetrics> AdmissionController::metrics() {
+    std::vector<RouteClassMetrics> result;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (RouteClass routeClass : {RouteClass::Read, RouteClass::Write, RouteClass::Bulk}) {
+        ClassState& s = state(routeClass);
+        RouteClassMetrics m;
+        m.name = className(routeClass);
+        m.limits = s.limits;
+        m.inFlight = s.inFlight;
+        m.queued = static_cast<int>(s.waiters.size());
+        m.peakInFlight = s.peakInFlight;
+        m.peakQueued = s.peakQueued;
+        m.admitted = s.admitted;
+        m.rejectedQueueFull = s.rejectedQueueFull;
+        m.rejectedTimeout = s.rejectedTimeout;
+        m.averageWaitMillis = averageMillis(s.totalWait, s.admitted);
+        m.averageServiceMillis = averageMillis(s.totalService, s.completed);
+        result.push_back(m);
+    }
+    return result;
+}
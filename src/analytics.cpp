@@ -0,0 +1,482 @@
+#include "analytics.h"
+#include "archive_manager.h"
+#include "database_handler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+// Column scans are split into contiguous chunks, one per worker thread; each
+// worker fills its own partial result and the caller merges them. Small
+// tables are scanned inline.
+template <typename Partial, typename ScanFn>
+std::vector<Partial> parallelScan(size_t rows, const Partial& init, ScanFn scan) {
+    const size_t minRowsPerThread = 1 << 16;
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    threads = std::min(threads, rows / minRowsPerThread + 1);
+
+    std::vector<Partial> partials(threads, init);
+    if (threads == 1) {
+        scan(size_t(0), rows, partials[0]);
+        return partials;
+    }
+
+    std::vector<std::thread> workers;
+    size_t chunk = (rows + threads - 1) / threads;
+    for (size_t t = 0; t < threads; t++) {
+        size_t begin = t * chunk;
+        size_t end = std::min(rows, begin + chunk);
+        workers.emplace_back([&scan, &partials, t, begin, end]() {
+            scan(begin, end, partials[t]);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return partials;
+}
+
+int32_t monthIndex(int32_t date) {
+    return (date / 10000) * 12 + (date / 100 % 100 - 1);
+}
+
+std::string columnText(sqlite3_stmt* stmt, int column) {
+    const unsigned char* text = sqlite3_column_text(stmt, column);
+    return text ? reinterpret_cast<const char*>(text) : "";
+}
+
+} // namespace
+
+int32_t Dictionary::encode(const std::string& value) {
+    auto it = codes.find(value);
+    if (it != codes.end()) {
+        return it->second;
+    }
+    int32_t code = static_cast<int32_t>(values.size());
+    values.push_back(value);
+    codes.emplace(value, code);
+    return code;
+}
+
+int32_t Dictionary::find(const std::string& value) const {
+    auto it = codes.find(value);
+    return it == codes.end() ? -1 : it->second;
+}
+
+const std::string& Dictionary::decode(int32_t code) const { return values.at(code); }
+size_t Dictionary::size() const { return values.size(); }
+
+AnalyticsEngine* AnalyticsEngine::instance = nullptr;
+
+AnalyticsEngine& AnalyticsEngine::getInstance() {
+    if (!instance) {
+        instance = new AnalyticsEngine();
+    }
+    return *instance;
+}
+
+AnalyticsEngine::~AnalyticsEngine() {
+    stop();
+}
+
+int32_t AnalyticsEngine::encodeDate(const std::string& date) {
+    // expects YYYY-MM-DD, anything trailing (e.g. a time) is ignored
+    if (date.size() < 10 || date[4] != '-' || date[7] != '-') {
+        return 0;
+    }
+    int32_t value = 0;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (date[i] < '0' || date[i] > '9') {
+            return 0;
+        }
+        value = value * 10 + (date[i] - '0');
+    }
+    return value;
+}
+
+void AnalyticsEngine::dateBounds(const std::string& startDate, const std::string& endDate, int32_t& from, int32_t& to) {
+    from = startDate.empty() ? 0 : encodeDate(startDate);
+    to = endDate.empty() ? 99999999 : encodeDate(endDate);
+    // a bound that does not parse would otherwise widen the range to everything
+    if ((!startDate.empty() && from == 0) || (!endDate.empty() && to == 0)) {
+        throw std::invalid_argument("Dates must be YYYY-MM-DD");
+    }
+}
+
+std::shared_ptr<AnalyticsSnapshot> AnalyticsEngine::loadSnapshot(sqlite3* hot) {
+    // archived appointments and records still count; they are read after
+    // the hot tables, a connection's worth of archive years at a time
+    ArchiveManager& archive = ArchiveManager::getInstance();
+    std::vector<int> years = archive.allYears();
+    // keys already loaded, when a row moved meanwhile can be read twice
+    std::unordered_set<int> appointmentKeys;
+    std::unordered_set<int> recordKeys;
+
+    auto snap = std::make_shared<AnalyticsSnapshot>();
+    std::unordered_map<int, int32_t> doctorCodes;
+    int32_t minDate = 0;
+    int32_t maxDate = 0;
+
+    auto doctorCode = [&](int doctorID) {
+        auto it = doctorCodes.find(doctorID);
+        if (it != doctorCodes.end()) {
+            return it->second;
+        }
+        // row refers to a doctor that no longer exists
+        int32_t code = static_cast<int32_t>(snap->doctorIDs.size());
+        snap->doctorIDs.push_back(doctorID);
+        snap->doctorNames.push_back("");
+        snap->doctorSpecialization.push_back(snap->specializations.encode(""));
+        doctorCodes.emplace(doctorID, code);
+        return code;
+    };
+    auto trackDate = [&](int32_t date) {
+        if (date == 0) return;
+        if (minDate == 0 || date < minDate) minDate = date;
+        if (date > maxDate) maxDate = date;
+    };
+    auto query = [&](sqlite3* conn, const std::string& sql, auto onRow) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error("Failed to prepare analytics statement: " +
+                                   std::string(sqlite3_errmsg(conn)));
+        }
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            onRow(stmt);
+        }
+        sqlite3_finalize(stmt);
+    };
+
+    auto addAppointment = [&](sqlite3_stmt* stmt) {
+        if (!years.empty() && !appointmentKeys.insert(sqlite3_column_int(stmt, 0)).second) return;
+        int32_t date = encodeDate(columnText(stmt, 3));
+        snap->appointmentDoctor.push_back(doctorCode(sqlite3_column_int(stmt, 1)));
+        snap->appointmentPatient.push_back(sqlite3_column_int(stmt, 2));
+        snap->appointmentDate.push_back(date);
+        snap->appointmentStatus.push_back(snap->statuses.encode(columnText(stmt, 4)));
+        trackDate(date);
+    };
+    auto addRecord = [&](sqlite3_stmt* stmt) {
+        if (!years.empty() && !recordKeys.insert(sqlite3_column_int(stmt, 0)).second) return;
+        int32_t date = encodeDate(columnText(stmt, 3));
+        snap->recordDoctor.push_back(doctorCode(sqlite3_column_int(stmt, 1)));
+        snap->recordPatient.push_back(sqlite3_column_int(stmt, 2));
+        snap->recordDate.push_back(date);
+        trackDate(date);
+    };
+    static const std::string appointmentColumns = "SELECT appointmentID, doctorID, patientID, date, status FROM ";
+    static const std::string recordColumns = "SELECT recordID, doctorID, patientID, date FROM ";
+
+    // One read transaction so all four hot tables come from the same commit.
+    sqlite3* conn = hot;
+    sqlite3_exec(conn, "BEGIN;", nullptr, nullptr, nullptr);
+    try {
+        query(conn, "SELECT d.doctorID, u.name, d.specialization "
+              "FROM Doctors d JOIN Users u ON d.userID = u.userID ORDER BY d.doctorID;",
+              [&](sqlite3_stmt* stmt) {
+                  int32_t code = doctorCode(sqlite3_column_int(stmt, 0));
+                  snap->doctorNames[code] = columnText(stmt, 1);
+                  snap->doctorSpecialization[code] = snap->specializations.encode(columnText(stmt, 2));
+              });
+
+        query(conn, appointmentColumns + "Appointments;", addAppointment);
+        query(conn, recordColumns + "MedicalRecords;", addRecord);
+
+        query(conn, "SELECT doctorID, patientID, date, medicine FROM Prescriptions;",
+              [&](sqlite3_stmt* stmt) {
+                  int32_t date = encodeDate(columnText(stmt, 2));
+                  snap->prescriptionDoctor.push_back(doctorCode(sqlite3_column_int(stmt, 0)));
+                  snap->prescriptionPatient.push_back(sqlite3_column_int(stmt, 1));
+                  snap->prescriptionDate.push_back(date);
+                  snap->prescriptionMedicine.push_back(snap->medicines.encode(columnText(stmt, 3)));
+                  trackDate(date);
+              });
+    } catch (...) {
+        sqlite3_exec(conn, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+    sqlite3_exec(conn, "COMMIT;", nullptr, nullptr, nullptr);
+
+    if (!years.empty()) {
+        archive.readArchived("Appointments", years, [&](sqlite3* reader, const std::string& source) {
+            query(reader, appointmentColumns + source + ";", addAppointment);
+            return true;
+        });
+        archive.readArchived("MedicalRecords", years, [&](sqlite3* reader, const std::string& source) {
+            query(reader, recordColumns + source + ";", addRecord);
+            return true;
+        });
+    }
+
+    // make sure every report can index the status dictionary without lookups failing
+    for (const char* status : {"scheduled", "completed", "cancelled"}) {
+        snap->statuses.encode(status);
+    }
+    if (maxDate != 0) {
+        snap->firstMonth = monthIndex(minDate);
+        snap->lastMonth = monthIndex(maxDate);
+    }
+    snap->refreshedAt = std::time(nullptr);
+    return snap;
+}
+
+void AnalyticsEngine::start(int refreshIntervalSeconds) {
+    std::lock_guard<std::mutex> lock(workerMutex);
+    if (running) return;
+    this->refreshIntervalSeconds = refreshIntervalSeconds;
+    running = true;
+    worker = std::thread(&AnalyticsEngine::refreshLoop, this);
+}
+
+void AnalyticsEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        if (!running) return;
+        running = false;
+    }
+    workerSignal.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void AnalyticsEngine::refresh() {
+    sqlite3* conn = DatabaseHandler::getInstance().openReadOnlyConnection();
+    try {
+        auto snap = loadSnapshot(conn);
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        snapshot = std::move(snap);
+    } catch (...) {
+        sqlite3_close(conn);
+        throw;
+    }
+    sqlite3_close(conn);
+}
+
+void AnalyticsEngine::refreshLoop() {
+    sqlite3* conn = nullptr;
+    try {
+        conn = DatabaseHandler::getInstance().openReadOnlyConnection();
+    } catch (const std::exception& e) {
+        std::cerr << "Analytics refresh disabled: " << e.what() << std::endl;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(workerMutex);
+    while (running) {
+        lock.unlock();
+        try {
+            // data_version only moves when another connection commits, so an
+            // idle database does not cost a reload every interval
+            sqlite3_stmt* stmt;
+            int64_t dataVersion = -1;
+            if (sqlite3_prepare_v2(conn, "PRAGMA data_version;", -1, &stmt, nullptr) == SQLITE_OK) {
+                if (sqlite3_step(stmt) == SQLITE_ROW) {
+                    dataVersion = sqlite3_column_int64(stmt, 0);
+                }
+                sqlite3_finalize(stmt);
+            }
+            if (dataVersion != lastDataVersion || !getSnapshot()) {
+                auto snap = loadSnapshot(conn);
+                {
+                    std::lock_guard<std::mutex> snapshotLock(snapshotMutex);
+                    snapshot = std::move(snap);
+                }
+                lastDataVersion = dataVersion;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Analytics refresh failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+        workerSignal.wait_for(lock, std::chrono::seconds(refreshIntervalSeconds), [this]() { return !running; });
+    }
+    lock.unlock();
+    sqlite3_close(conn);
+}
+
+std::shared_ptr<const AnalyticsSnapshot> AnalyticsEngine::getSnapshot() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return snapshot;
+}
+
+std::vector<DoctorUtilization> AnalyticsEngine::utilizationByDoctor(const std::string& startDate,
+                                                                    const std::string& endDate) const {
+    std::vector<DoctorUtilization> result;
+    int32_t from, to;
+    dateBounds(startDate, endDate, from, to);
+    auto snap = getSnapshot();
+    if (!snap) {
+        throw std::runtime_error("Analytics snapshot is not ready yet");
+    }
+
+    const size_t doctors = snap->doctorIDs.size();
+    const size_t statusCount = snap->statuses.size();
+
+    // counts[doctor * statusCount + status]; a row outside the range adds 0
+    struct Partial {
+        std::vector<int64_t> counts;
+        std::unordered_set<int64_t> doctorDays;
+    };
+    const int32_t* doctor = snap->appointmentDoctor.data();
+    const int32_t* date = snap->appointmentDate.data();
+    const int32_t* status = snap->appointmentStatus.data();
+    auto appointmentPartials = parallelScan(snap->appointmentDoctor.size(),
+        Partial{std::vector<int64_t>(doctors * statusCount, 0), {}},
+        [&](size_t begin, size_t end, Partial& partial) {
+            int64_t* counts = partial.counts.data();
+            for (size_t i = begin; i < end; i++) {
+                int64_t inRange = (date[i] >= from) & (date[i] <= to);
+                counts[doctor[i] * statusCount + status[i]] += inRange;
+            }
+            for (size_t i = begin; i < end; i++) {
+                if (date[i] >= from && date[i] <= to) {
+                    partial.doctorDays.insert(static_cast<int64_t>(doctor[i]) << 32 | date[i]);
+                }
+            }
+        });
+
+    const int32_t* recordDoctor = snap->recordDoctor.data();
+    const int32_t* recordDate = snap->recordDate.data();
+    auto recordPartials = parallelScan(snap->recordDoctor.size(), std::vector<int64_t>(doctors, 0),
+        [&](size_t begin, size_t end, std::vector<int64_t>& partial) {
+            int64_t* counts = partial.data();
+            for (size_t i = begin; i < end; i++) {
+                counts[recordDoctor[i]] += (recordDate[i] >= from) & (recordDate[i] <= to);
+            }
+        });
+
+    std::vector<int64_t> counts(doctors * statusCount, 0);
+    std::unordered_set<int64_t> doctorDays;
+    for (const auto& partial : appointmentPartials) {
+        for (size_t i = 0; i < counts.size(); i++) counts[i] += partial.counts[i];
+        doctorDays.insert(partial.doctorDays.begin(), partial.doctorDays.end());
+    }
+    std::vector<int64_t> activeDays(doctors, 0);
+    for (int64_t key : doctorDays) {
+        activeDays[key >> 32]++;
+    }
+    std::vector<int64_t> records(doctors, 0);
+    for (const auto& partial : recordPartials) {
+        for (size_t i = 0; i < doctors; i++) records[i] += partial[i];
+    }
+
+    const int32_t scheduled = snap->statuses.find("scheduled");
+    const int32_t completed = snap->statuses.find("completed");
+    const int32_t cancelled = snap->statuses.find("cancelled");
+    for (size_t d = 0; d < doctors; d++) {
+        DoctorUtilization row;
+        row.doctorID = snap->doctorIDs[d];
+        row.name = snap->doctorNames[d];
+        row.specialization = snap->specializations.decode(snap->doctorSpecialization[d]);
+        row.scheduled = counts[d * statusCount + scheduled];
+        row.completed = counts[d * statusCount + completed];
+        row.cancelled = counts[d * statusCount + cancelled];
+        row.activeDays = activeDays[d];
+        row.records = records[d];
+        result.push_back(row);
+    }
+    return result;
+}
+
+std::vector<MonthlyVolume> AnalyticsEngine::monthlyVolume(const std::string& startDate,
+                                                          const std::string& endDate) const {
+    std::vector<MonthlyVolume> result;
+    int32_t from, to;
+    dateBounds(startDate, endDate, from, to);
+    auto snap = getSnapshot();
+    if (!snap) {
+        throw std::runtime_error("Analytics snapshot is not ready yet");
+    }
+    if (snap->lastMonth < snap->firstMonth) {
+        return result;
+    }
+
+    const int32_t firstMonth = snap->firstMonth;
+    const size_t months = snap->lastMonth - snap->firstMonth + 1;
+
+    // Rows without a parseable date land in an overflow slot that is dropped.
+    auto countByMonth = [&](const std::vector<int32_t>& dates) {
+        const int32_t* date = dates.data();
+        auto partials = parallelScan(dates.size(), std::vector<int64_t>(months + 1, 0),
+            [&](size_t begin, size_t end, std::vector<int64_t>& partial) {
+                int64_t* counts = partial.data();
+                for (size_t i = begin; i < end; i++) {
+                    bool keep = date[i] != 0 && date[i] >= from && date[i] <= to;
+                    size_t slot = keep ? static_cast<size_t>(monthIndex(date[i]) - firstMonth) : months;
+                    counts[slot]++;
+                }
+            });
+        std::vector<int64_t> counts(months, 0);
+        for (const auto& partial : partials) {
+            for (size_t m = 0; m < months; m++) counts[m] += partial[m];
+        }
+        return counts;
+    };
+
+    auto appointments = countByMonth(snap->appointmentDate);
+    auto records = countByMonth(snap->recordDate);
+    auto prescriptions = countByMonth(snap->prescriptionDate);
+
+    for (size_t m = 0; m < months; m++) {
+        if (appointments[m] == 0 && records[m] == 0 && prescriptions[m] == 0) continue;
+        int32_t index = firstMonth + static_cast<int32_t>(m);
+        MonthlyVolume row;
+        row.month = (index / 12) * 100 + index % 12 + 1;
+        row.appointments = appointments[m];
+        row.records = records[m];
+        row.prescriptions = prescriptions[m];
+        result.push_back(row);
+    }
+    return result;
+}
+
+std::vector<MonthlyCancellations> AnalyticsEngine::cancellationsByMonth(const std::string& startDate,
+                                                                        const std::string& endDate) const {
+    std::vector<MonthlyCancellations> result;
+    int32_t from, to;
+    dateBounds(startDate, endDate, from, to);
+    auto snap = getSnapshot();
+    if (!snap) {
+        throw std::runtime_error("Analytics snapshot is not ready yet");
+    }
+    if (snap->lastMonth < snap->firstMonth) {
+        return result;
+    }
+
+    const int32_t firstMonth = snap->firstMonth;
+    const size_t months = snap->lastMonth - snap->firstMonth + 1;
+    const int32_t cancelledStatus = snap->statuses.find("cancelled");
+
+    // counts[month * 2] is every appointment, counts[month * 2 + 1] the
+    // cancelled ones; undated or out-of-range rows go to the overflow pair
+    const int32_t* date = snap->appointmentDate.data();
+    const int32_t* status = snap->appointmentStatus.data();
+    auto partials = parallelScan(snap->appointmentDate.size(), std::vector<int64_t>((months + 1) * 2, 0),
+        [&](size_t begin, size_t end, std::vector<int64_t>& partial) {
+            int64_t* counts = partial.data();
+            for (size_t i = begin; i < end; i++) {
+                bool keep = date[i] != 0 && date[i] >= from && date[i] <= to;
+                size_t slot = keep ? static_cast<size_t>(monthIndex(date[i]) - firstMonth) : months;
+                counts[slot * 2]++;
+                counts[slot * 2 + 1] += status[i] == cancelledStatus;
+            }
+        });
+
+    std::vector<int64_t> counts(months * 2, 0);
+    for (const auto& partial : partials) {
+        for (size_t i = 0; i < counts.size(); i++) counts[i] += partial[i];
+    }
+    for (size_t m = 0; m < months; m++) {
+        if (counts[m * 2] == 0) continue;
+        int32_t index = firstMonth + static_cast<int32_t>(m);
+        MonthlyCancellations row;
+        row.month = (index / 12) * 100 + index % 12 + 1;
+        row.appointments = counts[m * 2];
+        row.cancelled = counts[m * 2 + 1];
+        result.push_back(row);
+    }
+    return result;
+}
@@ -1,234 +1,168 @@
 #include "appointment.h"
+#include "archive_manager.h"
 #include "database_handler.h"
 #include "patient.h"
 #include "doctor.h"
+#include "change_feed.h"
+#include "tables.h"
 #include <sqlite3.h>
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
+#include <unordered_set>
+#include <utility>
 
-Appointment::Appointment(int appointmentID, Patient* patient, Doctor* doctor,
+Appointment::Appointment(int appointmentID, int patientID, int doctorID,
                          const std::string& date, const std::string& time)
-    : appointmentID(appointmentID), patient(patient), doctor(doctor),
+    : appointmentID(appointmentID), patient(patientID), doctor(doctorID),
       date(date), time(time) {}
 
 bool Appointment::saveToDatabase() {
-    if (!patient || !doctor) {
+    if (patient.getID() == 0 || doctor.getID() == 0) {
         throw std::invalid_argument("Patient and Doctor must be valid");
     }
 
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-    
-    std::string sql = appointmentID == 0 ?
-        "INSERT INTO Appointments (patientID, doctorID, date, time, status) VALUES (?, ?, ?, ?, 'scheduled');" :
-        "UPDATE Appointments SET patientID = ?, doctorID = ?, date = ?, time = ? WHERE appointmentID = ?;";
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare appointment statement: " + 
-                               std::string(sqlite3_errmsg(db)));
-    }
-    
-    if (appointmentID == 0) {
-        sqlite3_bind_int(stmt, 1, patient->getPatientID());
-        sqlite3_bind_int(stmt, 2, doctor->getDoctorID());
-        sqlite3_bind_text(stmt, 3, date.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 4, time.c_str(), -1, SQLITE_TRANSIENT);
-    } else {
-        sqlite3_bind_int(stmt, 1, patient->getPatientID());
-        sqlite3_bind_int(stmt, 2, doctor->getDoctorID());
-        sqlite3_bind_text(stmt, 3, date.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 4, time.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 5, appointmentID);
+    bool created = appointmentID == 0;
+    bool changed = true;
+
+    // status is left to its 'scheduled' default on insert and untouched on update
+    try {
+        if (created) {
+            appointmentID = static_cast<int>(AppointmentsTable::insert(db, patient.getID(), doctor.getID(),
+                                                                       date, time));
+        } else {
+            changed = AppointmentsTable::update(db, appointmentID, patient.getID(), doctor.getID(),
+                                                date, time);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error saving appointment: " << e.what() << std::endl;
+        return false;
     }
-    
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    if (success && appointmentID == 0) {
-        appointmentID = sqlite3_last_insert_rowid(db);
+
+    // an update that matched no row (already deleted) has nothing to announce
+    if (changed) {
+        ChangeFeed::getInstance().publish("appointment", created ? "created" : "updated", appointmentID,
+                                          patient.getID(), doctor.getID(), date);
     }
-    
-    sqlite3_finalize(stmt);
-    return success;
+    return true;
 }
 
 bool Appointment::deleteFromDatabase() {
     if (appointmentID == 0) return false;
 
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-    
-    std::string sql = "DELETE FROM Appointments WHERE appointmentID = ?;";
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare delete statement: " + 
-                               std::string(sqlite3_errmsg(db)));
+    bool deleted;
+    try {
+        deleted = AppointmentsTable::remove(db, appointmentID);
+    } catch (const std::exception& e) {
+        std::cerr << "Error deleting appointment: " << e.what() << std::endl;
+        return false;
     }
-    
-    sqlite3_bind_int(stmt, 1, appointmentID);
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    
-    sqlite3_finalize(stmt);
-    return success;
-}
 
-Appointment* Appointment::getAppointmentFromDatabase(int appointmentID) {
-    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-    
-    std::string sql = "SELECT a.appointmentID, a.patientID, a.doctorID, a.date, a.time, a.status "
-                     "FROM Appointments a "
-                     "WHERE a.appointmentID = ?;";
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare select statement: " + 
-                               std::string(sqlite3_errmsg(db)));
+    if (deleted) {
+        ChangeFeed::getInstance().publish("appointment", "deleted", appointmentID,
+                                          patient.getID(), doctor.getID(), date);
     }
-    
-    sqlite3_bind_int(stmt, 1, appointmentID);
-    
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        int patientID = sqlite3_column_int(stmt, 1);
-        int doctorID = sqlite3_column_int(stmt, 2);
-        std::string date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        std::string time = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        std::string status = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-        
-        Patient* patient = Patient::getPatientFromDatabase(patientID);
-        Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
-        
-        if (!patient || !doctor) {
-            sqlite3_finalize(stmt);
-            throw std::runtime_error("Failed to load patient or doctor data");
-        }
-        
-        Appointment* appointment = new Appointment(id, patient, doctor, date, time);
-        sqlite3_finalize(stmt);
-        return appointment;
-    }
-    
-    sqlite3_finalize(stmt);
-    return nullptr;
+    return true;
 }
 
-std::vector<Appointment*> Appointment::getAppointmentsForPatient(int patientID) {
-    std::vector<Appointment*> appointments;
+static Appointment* decodeAppointment(sqlite3_stmt* stmt) {
+    auto [id, patientID, doctorID, date, time] = AppointmentsTable::decode(stmt);
+    return new Appointment(id, patientID, doctorID, date, time);
+}
+
+Appointment* Appointment::getAppointmentFromDatabase(int appointmentID, bool includeArchived) {
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-    
-    std::string sql = "SELECT a.appointmentID, a.doctorID, a.date, a.time, a.status "
-                     "FROM Appointments a "
-                     "WHERE a.patientID = ? "
-                     "ORDER BY a.date, a.time;";
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare select statement: " + 
-                               std::string(sqlite3_errmsg(db)));
+
+    auto row = AppointmentsTable::findByKey(db, appointmentID);
+    if (row) {
+        auto& [id, patientID, doctorID, date, time] = *row;
+        return new Appointment(id, patientID, doctorID, date, time);
     }
-    
-    sqlite3_bind_int(stmt, 1, patientID);
-    
-    Patient* patient = Patient::getPatientFromDatabase(patientID);
-    if (!patient) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Invalid patient ID");
+    if (!includeArchived) {
+        return nullptr;
     }
-    
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        int doctorID = sqlite3_column_int(stmt, 1);
-        std::string date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string time = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        
-        Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
-        if (doctor) {
-            appointments.push_back(new Appointment(id, patient, doctor, date, time));
+
+    // the key does not tell which year the row was archived under, so every
+    // year is searched, a connection's worth at a time
+    Appointment* appointment = nullptr;
+    ArchiveManager& archive = ArchiveManager::getInstance();
+    archive.readArchived("Appointments", archive.allYears(), [&](sqlite3* conn, const std::string& source) {
+        std::string sql = AppointmentsTable::selectFrom(source) + " WHERE appointmentID = ?;";
+        table::Statement stmt(conn, sql.c_str());
+        stmt.bind(1, appointmentID);
+        if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            appointment = decodeAppointment(stmt.get());
         }
-    }
-    
-    sqlite3_finalize(stmt);
-    return appointments;
+        return appointment == nullptr;
+    });
+    return appointment;
 }
 
-std::vector<Appointment*> Appointment::getAppointmentsForDoctor(int doctorID) {
+// Rows in (date, time) order, archived ones included. The hot rows come from
+// the shared connection and the prebuilt SELECT; archived ones are read a
+// connection's worth of years at a time and merged in.
+template <table::FixedString Suffix>
+static std::vector<Appointment*> loadAppointments(int filterID) {
     std::vector<Appointment*> appointments;
-    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-    
-    std::string sql = "SELECT a.appointmentID, a.patientID, a.date, a.time, a.status "
-                     "FROM Appointments a "
-                     "WHERE a.doctorID = ? "
-                     "ORDER BY a.date, a.time;";
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare select statement: " + 
-                               std::string(sqlite3_errmsg(db)));
-    }
-    
-    sqlite3_bind_int(stmt, 1, doctorID);
-    
-    Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
-    if (!doctor) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Invalid doctor ID");
-    }
-    
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        int patientID = sqlite3_column_int(stmt, 1);
-        std::string date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string time = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        
-        Patient* patient = Patient::getPatientFromDatabase(patientID);
-        if (patient) {
-            appointments.push_back(new Appointment(id, patient, doctor, date, time));
+    std::unordered_set<int> seen;
+    auto read = [&](table::Statement& stmt) {
+        if (filterID != 0) {
+            stmt.bind(1, filterID);
+        }
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            // a row moved while the batches were read is in both
+            if (seen.insert(sqlite3_column_int(stmt.get(), 0)).second) {
+                appointments.push_back(decodeAppointment(stmt.get()));
+            }
+        }
+    };
+
+    try {
+        table::Statement hot(DatabaseHandler::getInstance().getDatabase(), AppointmentsTable::select<Suffix>.c_str());
+        read(hot);
+
+        ArchiveManager& archive = ArchiveManager::getInstance();
+        std::vector<int> years = archive.allYears();
+        if (years.empty()) {
+            return appointments;
         }
+        archive.readArchived("Appointments", years, [&](sqlite3* conn, const std::string& source) {
+            std::string sql = AppointmentsTable::selectFrom(source) + Suffix.c_str();
+            table::Statement stmt(conn, sql.c_str());
+            read(stmt);
+            return true;
+        });
+    } catch (...) {
+        for (Appointment* appointment : appointments) delete appointment;
+        throw;
     }
-    
-    sqlite3_finalize(stmt);
+
+    std::stable_sort(appointments.begin(), appointments.end(), [](const Appointment* a, const Appointment* b) {
+        return std::make_pair(a->getDate(), a->getTime()) < std::make_pair(b->getDate(), b->getTime());
+    });
     return appointments;
 }
 
+std::vector<Appointment*> Appointment::getAppointmentsForPatient(int patientID) {
+    return loadAppointments<" WHERE patientID = ? ORDER BY date, time;">(patientID);
+}
+
+std::vector<Appointment*> Appointment::getAppointmentsForDoctor(int doctorID) {
+    return loadAppointments<" WHERE doctorID = ? ORDER BY date, time;">(doctorID);
+}
+
 std::vector<Appointment*> Appointment::getAllAppointmentsFromDatabase() {
-    std::vector<Appointment*> appointments;
-    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-    
-    std::string sql = "SELECT a.appointmentID, a.patientID, a.doctorID, a.date, a.time, a.status "
-                     "FROM Appointments a "
-                     "ORDER BY a.date, a.time;";
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare select statement: " + 
-                               std::string(sqlite3_errmsg(db)));
-    }
-    
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        int patientID = sqlite3_column_int(stmt, 1);
-        int doctorID = sqlite3_column_int(stmt, 2);
-        std::string date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        std::string time = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        
-        Patient* patient = Patient::getPatientFromDatabase(patientID);
-        Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
-        
-        if (patient && doctor) {
-            appointments.push_back(new Appointment(id, patient, doctor, date, time));
-        } else {
-            // Clean up if we couldn't get both patient and doctor
-            if (patient) delete patient;
-            if (doctor) delete doctor;
-        }
-    }
-    
-    sqlite3_finalize(stmt);
-    return appointments;
+    return loadAppointments<" ORDER BY date, time;">(0);
 }
 
 // Getters
 int Appointment::getAppointmentID() const { return appointmentID; }
-Patient* Appointment::getPatient() const { return patient; }
-Doctor* Appointment::getDoctor() const { return doctor; }
+int Appointment::getPatientID() const { return patient.getID(); }
+int Appointment::getDoctorID() const { return doctor.getID(); }
+const EntityRef<Patient>& Appointment::getPatient() const { return patient; }
+const EntityRef<Doctor>& Appointment::getDoctor() const { return doctor; }
 std::string Appointment::getDate() const { return date; }
 std::string Appointment::getTime() const { return time; }
 
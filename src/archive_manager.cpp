@@ -0,0 +1,542 @@
+#include "archive_manager.h"
+#include "database_handler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+ArchiveManager* ArchiveManager::instance = nullptr;
+
+namespace {
+
+struct ArchivedTable {
+    const char* name;
+    const char* key;
+    const char* columns;        // in the hot table's order
+    const char* definition;     // the archive copy: no foreign keys, no AUTOINCREMENT
+};
+
+const ArchivedTable kArchivedTables[] = {
+    {"Appointments", "appointmentID",
+     "appointmentID, patientID, doctorID, date, time, status, notes, created_at",
+     "appointmentID INTEGER PRIMARY KEY, patientID INTEGER NOT NULL, doctorID INTEGER NOT NULL, "
+     "date TEXT NOT NULL, time TEXT NOT NULL, status TEXT, notes TEXT, created_at TIMESTAMP"},
+    {"MedicalRecords", "recordID",
+     "recordID, patientID, doctorID, diagnosis, treatment, date, created_at",
+     "recordID INTEGER PRIMARY KEY, patientID INTEGER NOT NULL, doctorID INTEGER NOT NULL, "
+     "diagnosis TEXT NOT NULL, treatment TEXT NOT NULL, date TEXT NOT NULL, created_at TIMESTAMP"},
+};
+
+const ArchivedTable* findArchivedTable(const std::string& name) {
+    for (const auto& table : kArchivedTables) {
+        if (name == table.name) return &table;
+    }
+    return nullptr;
+}
+
+int yearOf(const std::string& date) {
+    if (date.size() < 4) return 0;
+    try {
+        return std::stoi(date.substr(0, 4));
+    } catch (const std::exception&) {
+        return 0;
+    }
+}
+
+std::string yearStart(int year) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%04d-01-01", year);
+    return buffer;
+}
+
+std::string dateDaysAgo(int days) {
+    std::time_t when = std::time(nullptr) - static_cast<std::time_t>(days) * 24 * 60 * 60;
+    char buffer[16];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", std::localtime(&when));
+    return buffer;
+}
+
+void exec(sqlite3* conn, const std::string& sql) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(conn, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::string error = "SQL error: " + std::string(errMsg ? errMsg : sqlite3_errmsg(conn));
+        sqlite3_free(errMsg);
+        throw std::runtime_error(error);
+    }
+}
+
+// "x.a IS h.a AND x.b IS h.b ..." over a column list
+std::string sameRow(const std::string& columns) {
+    std::string condition;
+    size_t start = 0;
+    while (start < columns.size()) {
+        size_t end = columns.find(", ", start);
+        std::string column = columns.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (!condition.empty()) condition += " AND ";
+        condition += "x." + column + " IS h." + column;
+        if (end == std::string::npos) break;
+        start = end + 2;
+    }
+    return condition;
+}
+
+// Creates the year's file and its tables on first use.
+void createArchiveFile(const std::string& path) {
+    sqlite3* conn = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &conn, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX,
+                        nullptr) != SQLITE_OK) {
+        std::string error = conn ? sqlite3_errmsg(conn) : "out of memory";
+        sqlite3_close(conn);
+        throw std::runtime_error("Failed to open " + path + ": " + error);
+    }
+    try {
+        for (const auto& table : kArchivedTables) {
+            std::string name = table.name;
+            exec(conn, "CREATE TABLE IF NOT EXISTS " + name + " (" + table.definition + ");");
+            exec(conn, "CREATE INDEX IF NOT EXISTS idx_" + name + "_patient_date ON " + name + " (patientID, date, " +
+                       table.key + ");");
+            exec(conn, "CREATE INDEX IF NOT EXISTS idx_" + name + "_doctor_date ON " + name + " (doctorID, date);");
+            exec(conn, "CREATE INDEX IF NOT EXISTS idx_" + name + "_date ON " + name + " (date);");
+        }
+    } catch (...) {
+        sqlite3_close(conn);
+        throw;
+    }
+    sqlite3_close(conn);
+}
+
+} // namespace
+
+ArchiveManager& ArchiveManager::getInstance() {
+    if (!instance) {
+        instance = new ArchiveManager();
+    }
+    return *instance;
+}
+
+ArchiveManager::~ArchiveManager() {
+    stop();
+}
+
+void ArchiveManager::start(const ArchiveSettings& settings) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) return;
+        this->settings = settings;
+        this->settings.batchRows = std::max(1, settings.batchRows);
+    }
+    loadState();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (settings.horizonDays <= 0) return;
+    running = true;
+    worker = std::thread(&ArchiveManager::workerLoop, this);
+}
+
+void ArchiveManager::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    signal.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void ArchiveManager::loadState() {
+    std::string directory = getSettings().directory;
+    std::set<int> found;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() == 24 && name.rfind("hospital-archive-", 0) == 0 && entry.path().extension() == ".db") {
+            int year = yearOf(name.substr(17, 4));
+            if (year > 0) found.insert(year);
+        }
+    }
+
+    std::string horizon;
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT archived_before FROM ArchiveState WHERE id = 1;", -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            horizon = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    years = std::move(found);
+    status.archivedBefore = horizon;
+}
+
+bool ArchiveManager::requestArchival() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running || requested || status.inProgress) return false;
+        requested = true;
+    }
+    signal.notify_all();
+    return true;
+}
+
+ArchiveStatus ArchiveManager::getStatus() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    ArchiveStatus current = status;
+    current.years.assign(years.begin(), years.end());
+    return current;
+}
+
+ArchiveSettings ArchiveManager::getSettings() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return settings;
+}
+
+std::string ArchiveManager::archivedBefore() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return status.archivedBefore;
+}
+
+std::vector<int> ArchiveManager::yearsFor(const std::string& from, const std::string& to) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<int> result;
+    if (years.empty() || status.archivedBefore.empty() || from >= status.archivedBefore) {
+        return result;
+    }
+
+    int first = yearOf(from);
+    int last = yearOf(std::min(to, status.archivedBefore));
+    for (auto it = years.rbegin(); it != years.rend(); ++it) {
+        if (*it >= first && *it <= last) result.push_back(*it);
+    }
+    return result;
+}
+
+std::vector<int> ArchiveManager::allYears() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::vector<int>(years.rbegin(), years.rend());
+}
+
+std::string ArchiveManager::pathFor(int year) const {
+    return getSettings().directory + "/hospital-archive-" + std::to_string(year) + ".db";
+}
+
+std::string ArchiveManager::schemaFor(int year) {
+    return "archive_" + std::to_string(year);
+}
+
+bool ArchiveManager::isArchived(const std::string& table) {
+    return findArchivedTable(table) != nullptr;
+}
+
+std::string ArchiveManager::archivedSource(const std::string& table, const std::vector<int>& years) {
+    const ArchivedTable* archived = findArchivedTable(table);
+    if (!archived || years.empty()) {
+        throw std::invalid_argument("No archive years to read " + table + " from");
+    }
+
+    std::string columns = archived->columns;
+    std::string sql;
+    for (int year : years) {
+        // a batch is visible on both sides between its copy and its delete
+        sql += sql.empty() ? "(" : " UNION ALL ";
+        sql += "SELECT " + columns + " FROM " + schemaFor(year) + "." + table + " x" +
+               " WHERE NOT EXISTS (SELECT 1 FROM main." + table + " h WHERE h." + archived->key +
+               " = x." + archived->key + ")";
+    }
+    return sql + ")";
+}
+
+std::string ArchiveManager::unionSource(const std::string& table, const std::vector<int>& years) {
+    const ArchivedTable* archived = findArchivedTable(table);
+    if (!archived || years.empty()) {
+        return table;
+    }
+    std::string arms = archivedSource(table, years);
+    // drop the parentheses so both arms form one compound select
+    return "(SELECT " + std::string(archived->columns) + " FROM main." + table + " UNION ALL " +
+           arms.substr(1, arms.size() - 2) + ")";
+}
+
+std::vector<int> ArchiveManager::attach(sqlite3* conn, const std::vector<int>& years) const {
+    std::vector<int> attached;
+    size_t slots = static_cast<size_t>(std::max(0, sqlite3_limit(conn, SQLITE_LIMIT_ATTACHED, -1)));
+    for (int year : years) {
+        if (attached.size() == slots) break;
+        sqlite3_stmt* stmt;
+        std::string sql = "ATTACH DATABASE ? AS " + schemaFor(year) + ";";
+        if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error("Failed to prepare archive attach: " + std::string(sqlite3_errmsg(conn)));
+        }
+        std::string path = pathFor(year);
+        sqlite3_bind_text(stmt, 1, path.c_str(), -1, SQLITE_TRANSIENT);
+        int rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error("Failed to attach " + path + ": " + std::string(sqlite3_errmsg(conn)));
+        }
+        attached.push_back(year);
+    }
+    return attached;
+}
+
+void ArchiveManager::readArchived(const std::string& table, std::vector<int> years,
+                                  const std::function<bool(sqlite3*, const std::string&)>& read) const {
+    while (!years.empty()) {
+        sqlite3* reader = DatabaseHandler::getInstance().openReadOnlyConnection();
+        bool more;
+        try {
+            std::vector<int> attached = attach(reader, years);
+            if (attached.empty()) {
+                throw std::runtime_error("No archive database can be attached");
+            }
+            more = read(reader, archivedSource(table, attached));
+            years.erase(years.begin(), years.begin() + attached.size());
+        } catch (...) {
+            sqlite3_close(reader);
+            throw;
+        }
+        sqlite3_close(reader);
+        if (!more) break;
+    }
+}
+
+void ArchiveManager::workerLoop() {
+    using Clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> lock(mutex);
+    // the first run starts right away; a backlog past the horizon is moved
+    // in the background after startup
+    Clock::time_point nextScheduled = Clock::now();
+
+    while (running) {
+        signal.wait_until(lock, nextScheduled, [this, &nextScheduled]() {
+            return !running || requested || Clock::now() >= nextScheduled;
+        });
+        if (!running) break;
+
+        requested = false;
+        status.inProgress = true;
+        lock.unlock();
+        runArchival();
+        lock.lock();
+
+        nextScheduled = Clock::now() + std::chrono::minutes(std::max(1, settings.intervalMinutes));
+    }
+}
+
+void ArchiveManager::runArchival() {
+    ArchiveSettings current = getSettings();
+    std::string cutoff = dateDaysAgo(current.horizonDays);
+
+    std::string error;
+    uint64_t appointments = 0;
+    uint64_t records = 0;
+    sqlite3* conn = nullptr;
+    try {
+        conn = DatabaseHandler::getInstance().openWriteConnection();
+        advanceHorizon(conn, cutoff);
+
+        std::set<int> pending;
+        for (const auto& table : kArchivedTables) {
+            sqlite3_stmt* stmt;
+            std::string sql = std::string("SELECT DISTINCT CAST(substr(date, 1, 4) AS INTEGER) FROM main.") +
+                              table.name + " WHERE date < ?1 AND date GLOB '[0-9][0-9][0-9][0-9]-*';";
+            if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                throw std::runtime_error("Failed to prepare archive scan: " + std::string(sqlite3_errmsg(conn)));
+            }
+            sqlite3_bind_text(stmt, 1, cutoff.c_str(), -1, SQLITE_TRANSIENT);
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                pending.insert(sqlite3_column_int(stmt, 0));
+            }
+            sqlite3_finalize(stmt);
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(current.directory, ec);
+        if (ec) {
+            throw std::runtime_error("Failed to create archive directory: " + ec.message());
+        }
+
+        for (int year : pending) {
+            if (year <= 0) continue;
+            createArchiveFile(pathFor(year));
+            attach(conn, {year});
+            std::string schema = schemaFor(year);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                years.insert(year);
+            }
+
+            appointments += moveRows(conn, 0, year, cutoff, current.batchRows);
+            records += moveRows(conn, 1, year, cutoff, current.batchRows);
+            exec(conn, "DETACH DATABASE " + schema + ";");
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) {
+                error = "Archival cancelled";
+                break;
+            }
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+        if (conn && !sqlite3_get_autocommit(conn)) {
+            sqlite3_exec(conn, "ROLLBACK;", nullptr, nullptr, nullptr);
+        }
+    }
+    sqlite3_close(conn);
+
+    if (!error.empty()) {
+        std::cerr << "Archival failed: " << error << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    status.inProgress = false;
+    status.appointmentsMoved += appointments;
+    status.recordsMoved += records;
+    status.runs++;
+    status.lastRunAt = std::time(nullptr);
+    status.lastError = error;
+}
+
+void ArchiveManager::advanceHorizon(sqlite3* conn, const std::string& cutoff) {
+    sqlite3_stmt* stmt;
+    const char* sql = "INSERT INTO ArchiveState (id, archived_before) VALUES (1, ?1) "
+                      "ON CONFLICT(id) DO UPDATE SET archived_before = max(archived_before, excluded.archived_before) "
+                      "RETURNING archived_before;";
+    if (sqlite3_prepare_v2(conn, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare archive horizon: " + std::string(sqlite3_errmsg(conn)));
+    }
+    sqlite3_bind_text(stmt, 1, cutoff.c_str(), -1, SQLITE_TRANSIENT);
+    std::string horizon;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        horizon = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+    }
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (horizon.empty() || rc != SQLITE_DONE) {
+        throw std::runtime_error("Failed to advance archive horizon: " + std::string(sqlite3_errmsg(conn)));
+    }
+    DatabaseHandler::getInstance().recordExternalChanges(1);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    status.archivedBefore = horizon;
+}
+
+uint64_t ArchiveManager::moveRows(sqlite3* conn, int tableIndex, int year, const std::string& cutoff, int batchRows) {
+    const ArchivedTable& table = kArchivedTables[tableIndex];
+    std::string schema = schemaFor(year);
+    std::string from = yearStart(year);
+    std::string until = std::min(yearStart(year + 1), cutoff);
+    std::string name = table.name;
+    std::string key = table.key;
+    std::string columns = table.columns;
+
+    // Copy first, in its own commit to the archive file, then delete in a
+    // transaction on the hot database; with WAL a transaction spanning both
+    // files is not atomic across a crash, and this order can only leave a
+    // row on both sides, never on neither. REPLACE refreshes a row updated
+    // since an earlier copy, and the delete only takes rows whose archived
+    // copy is identical, so an update racing the move is kept.
+    std::string copySql = "INSERT OR REPLACE INTO " + schema + "." + name + " (" + columns + ") SELECT " + columns +
+                          " FROM main." + name + " WHERE date >= ?1 AND date < ?2 ORDER BY date, " + key +
+                          " LIMIT ?3;";
+    std::string deleteSql = "DELETE FROM main." + name + " WHERE " + key + " IN (SELECT h." + key + " FROM main." +
+                            name + " h JOIN " + schema + "." + name + " x ON x." + key + " = h." + key +
+                            " WHERE h.date >= ?1 AND h.date < ?2 AND " + sameRow(columns) + ");";
+
+    uint64_t moved = 0;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) break;
+        }
+
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(conn, copySql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error("Failed to prepare archive copy: " + std::string(sqlite3_errmsg(conn)));
+        }
+        sqlite3_bind_text(stmt, 1, from.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, until.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, batchRows);
+        int rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error("Failed to copy " + name + " into " + schema + ": " +
+                                     std::string(sqlite3_errmsg(conn)));
+        }
+        if (sqlite3_changes(conn) == 0) break;
+
+        exec(conn, "BEGIN IMMEDIATE;");
+        // makes the stats delete triggers skip these rows; never committed
+        exec(conn, "INSERT INTO ArchiveInProgress (active) VALUES (1);");
+        if (sqlite3_prepare_v2(conn, deleteSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            throw std::runtime_error("Failed to prepare archive delete: " + std::string(sqlite3_errmsg(conn)));
+        }
+        sqlite3_bind_text(stmt, 1, from.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, until.c_str(), -1, SQLITE_TRANSIENT);
+        rc = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error("Failed to remove archived " + name + ": " + std::string(sqlite3_errmsg(conn)));
+        }
+        int deleted = sqlite3_changes(conn);
+        exec(conn, "DELETE FROM ArchiveInProgress;");
+        exec(conn, "COMMIT;");
+        DatabaseHandler::getInstance().recordExternalChanges(deleted);
+
+        moved += deleted;
+        // only rows updated between every copy and delete stay behind; leave
+        // them to the next run rather than spinning on them
+        if (deleted == 0) break;
+    }
+    return moved;
+}
+
+ArchiveScope::ArchiveScope(const std::string& from, const std::string& to, sqlite3* hot) {
+    ArchiveManager& archive = ArchiveManager::getInstance();
+    std::vector<int> needed = archive.yearsFor(from, to);
+    if (needed.empty() && hot) {
+        conn = hot;
+        return;
+    }
+
+    conn = DatabaseHandler::getInstance().openReadOnlyConnection();
+    owned = true;
+    try {
+        years = archive.attach(conn, needed);
+    } catch (...) {
+        sqlite3_close(conn);
+        throw;
+    }
+    allAttached = years.size() == needed.size();
+}
+
+ArchiveScope::~ArchiveScope() {
+    if (owned) {
+        sqlite3_close(conn);
+    }
+}
+
+sqlite3* ArchiveScope::connection() const {
+    return conn;
+}
+
+bool ArchiveScope::spansArchive() const {
+    return !years.empty();
+}
+
+bool ArchiveScope::complete() const {
+    return allAttached;
+}
+
+int ArchiveScope::oldestYear() const {
+    return years.empty() ? 0 : years.back();
+}
+
+std::string ArchiveScope::source(const std::string& table) const {
+    return ArchiveManager::unionSource(table, years);
+}
@@ -0,0 +1,49 @@
+#include "async_data.h"
+
+namespace {
+
+std::vector<std::unique_ptr<Appointment>> adopt(std::vector<Appointment*> appointments) {
+    std::vector<std::unique_ptr<Appointment>> owned;
+    owned.reserve(appointments.size());
+    for (Appointment* appointment : appointments) {
+        owned.emplace_back(appointment);
+    }
+    return owned;
+}
+
+} // namespace
+
+Task<std::unique_ptr<Patient>> AsyncData::loadPatient(int patientID) {
+    co_await resumeOnDbExecutor();
+    co_return std::unique_ptr<Patient>(Patient::getPatientFromDatabase(patientID));
+}
+
+Task<std::unique_ptr<Doctor>> AsyncData::loadDoctor(int doctorID) {
+    co_await resumeOnDbExecutor();
+    co_return std::unique_ptr<Doctor>(Doctor::getDoctorFromDatabase(doctorID));
+}
+
+Task<std::unique_ptr<Appointment>> AsyncData::loadAppointment(int appointmentID) {
+    co_await resumeOnDbExecutor();
+    co_return std::unique_ptr<Appointment>(Appointment::getAppointmentFromDatabase(appointmentID));
+}
+
+Task<std::vector<std::unique_ptr<Appointment>>> AsyncData::loadAppointmentsForPatient(int patientID) {
+    co_await resumeOnDbExecutor();
+    co_return adopt(Appointment::getAppointmentsForPatient(patientID));
+}
+
+Task<std::vector<std::unique_ptr<Appointment>>> AsyncData::loadAppointmentsForDoctor(int doctorID) {
+    co_await resumeOnDbExecutor();
+    co_return adopt(Appointment::getAppointmentsForDoctor(doctorID));
+}
+
+Task<bool> AsyncData::save(Appointment& appointment) {
+    co_await resumeOnDbExecutor();
+    co_return appointment.saveToDatabase();
+}
+
+Task<bool> AsyncData::save(MedicalRecord& record) {
+    co_await resumeOnDbExecutor();
+    co_return record.saveToDatabase();
+}
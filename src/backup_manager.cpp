@@ -0,0 +1,199 @@
+#include "backup_manager.h"
+#include "database_handler.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+BackupManager* BackupManager::instance = nullptr;
+
+BackupManager& BackupManager::getInstance() {
+    if (!instance) {
+        instance = new BackupManager();
+    }
+    return *instance;
+}
+
+BackupManager::~BackupManager() {
+    stop();
+}
+
+void BackupManager::start(const BackupSettings& settings) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return;
+    this->settings = settings;
+    this->settings.pagesPerStep = std::max(1, settings.pagesPerStep);
+    running = true;
+    worker = std::thread(&BackupManager::workerLoop, this);
+}
+
+void BackupManager::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    signal.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool BackupManager::requestBackup() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running || requested || status.inProgress) return false;
+        requested = true;
+    }
+    signal.notify_all();
+    return true;
+}
+
+BackupStatus BackupManager::getStatus() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return status;
+}
+
+BackupSettings BackupManager::getSettings() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return settings;
+}
+
+void BackupManager::workerLoop() {
+    using Clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> lock(mutex);
+    Clock::time_point nextScheduled = Clock::now() + std::chrono::minutes(settings.intervalMinutes);
+
+    while (running) {
+        auto woken = [this]() { return !running || requested; };
+        if (settings.intervalMinutes > 0) {
+            signal.wait_until(lock, nextScheduled, woken);
+        } else {
+            signal.wait(lock, woken);
+        }
+        if (!running) break;
+
+        requested = false;
+        status.inProgress = true;
+        lock.unlock();
+        runBackup();
+        lock.lock();
+
+        // a requested backup also restarts the schedule
+        nextScheduled = Clock::now() + std::chrono::minutes(settings.intervalMinutes);
+    }
+}
+
+void BackupManager::runBackup() {
+    BackupSettings current = getSettings();
+
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    std::string path = current.directory + "/hospital-" + stamp + ".db";
+    std::string partial = path + ".partial";
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        status.path = path;
+        status.pagesTotal = 0;
+        status.pagesRemaining = 0;
+        status.steps = 0;
+        status.startedAt = now;
+        status.finishedAt = 0;
+    }
+
+    std::string error;
+    std::error_code ec;
+    std::filesystem::create_directories(current.directory, ec);
+    std::remove(partial.c_str());
+
+    sqlite3* destination = nullptr;
+    if (ec) {
+        error = "Failed to create backup directory: " + ec.message();
+    } else if (sqlite3_open(partial.c_str(), &destination) != SQLITE_OK) {
+        error = "Failed to open backup file: " + std::string(sqlite3_errmsg(destination));
+    } else {
+        sqlite3* source = DatabaseHandler::getInstance().getDatabase();
+        sqlite3_backup* backup = sqlite3_backup_init(destination, "main", source, "main");
+        if (!backup) {
+            error = "Failed to start backup: " + std::string(sqlite3_errmsg(destination));
+        } else {
+            int rc;
+            do {
+                rc = sqlite3_backup_step(backup, current.pagesPerStep);
+
+                bool cancelled;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    status.pagesTotal = sqlite3_backup_pagecount(backup);
+                    status.pagesRemaining = sqlite3_backup_remaining(backup);
+                    status.steps++;
+                    cancelled = !running;
+                }
+                if (cancelled) {
+                    error = "Backup cancelled";
+                    break;
+                }
+
+                // BUSY/LOCKED: a transaction is open on the source; try again
+                if (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(current.stepPauseMillis));
+                }
+            } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+
+            if (error.empty() && rc != SQLITE_DONE) {
+                error = "Backup failed: " + std::string(sqlite3_errstr(rc));
+            }
+            sqlite3_backup_finish(backup);
+        }
+    }
+    sqlite3_close(destination);
+
+    if (error.empty()) {
+        std::filesystem::rename(partial, path, ec);
+        if (ec) {
+            error = "Failed to finish backup file: " + ec.message();
+        }
+    }
+    if (!error.empty()) {
+        std::remove(partial.c_str());
+        std::cerr << error << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        status.inProgress = false;
+        status.finishedAt = std::time(nullptr);
+        status.lastError = error;
+        if (error.empty()) {
+            status.completed++;
+        } else {
+            status.failed++;
+        }
+    }
+
+    if (error.empty() && current.keep > 0) {
+        pruneOldBackups(current.directory, current.keep);
+    }
+}
+
+void BackupManager::pruneOldBackups(const std::string& directory, int keep) {
+    std::vector<std::filesystem::path> backups;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("hospital-", 0) == 0 && entry.path().extension() == ".db") {
+            backups.push_back(entry.path());
+        }
+    }
+
+    // names embed the timestamp, so name order is age order
+    std::sort(backups.begin(), backups.end());
+    for (size_t i = 0; i + static_cast<size_t>(keep) < backups.size(); i++) {
+        std::filesystem::remove(backups[i], ec);
+    }
+}
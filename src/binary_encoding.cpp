@@ -0,0 +1,484 @@
+#include "binary_encoding.h"
+#include "response_body.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// First pass: validates the document and records the element count of every
+// array and object in the order their opening brackets appear.
+class Counter {
+public:
+    Counter(const std::string& text, std::vector<uint32_t>& counts) : p(text.data()), end(text.data() + text.size()), counts(counts) {}
+
+    bool run() {
+        if (!value(0)) return false;
+        skipSpace();
+        return p == end;
+    }
+
+private:
+    const char* p;
+    const char* end;
+    std::vector<uint32_t>& counts;
+
+    void skipSpace() {
+        while (p < end && isSpace(*p)) p++;
+    }
+
+    bool string() {
+        p++;  // opening quote
+        while (p < end) {
+            if (*p == '"') { p++; return true; }
+            if (*p == '\\') {
+                if (++p >= end) return false;
+            }
+            p++;
+        }
+        return false;
+    }
+
+    bool literal(const char* word) {
+        size_t length = std::strlen(word);
+        if (static_cast<size_t>(end - p) < length || std::memcmp(p, word, length) != 0) return false;
+        p += length;
+        return true;
+    }
+
+    bool number() {
+        const char* start = p;
+        while (p < end && (std::isdigit(static_cast<unsigned char>(*p)) || *p == '-' || *p == '+' ||
+                           *p == '.' || *p == 'e' || *p == 'E')) {
+            p++;
+        }
+        return p > start;
+    }
+
+    bool container(char close, bool object, int depth) {
+        size_t slot = counts.size();
+        counts.push_back(0);
+        p++;
+        skipSpace();
+        if (p < end && *p == close) { p++; return true; }
+
+        uint32_t count = 0;
+        while (true) {
+            skipSpace();
+            if (object) {
+                if (p >= end || *p != '"' || !string()) return false;
+                skipSpace();
+                if (p >= end || *p != ':') return false;
+                p++;
+            }
+            if (!value(depth + 1)) return false;
+            count++;
+            skipSpace();
+            if (p >= end) return false;
+            if (*p == ',') { p++; continue; }
+            if (*p == close) { p++; break; }
+            return false;
+        }
+        counts[slot] = count;
+        return true;
+    }
+
+    bool value(int depth) {
+        if (depth > 512) return false;
+        skipSpace();
+        if (p >= end) return false;
+        switch (*p) {
+            case '{': return container('}', true, depth);
+            case '[': return container(']', false, depth);
+            case '"': return string();
+            case 't': return literal("true");
+            case 'f': return literal("false");
+            case 'n': return literal("null");
+            default: return number();
+        }
+    }
+};
+
+class Writer {
+public:
+    Writer(BinaryFormat format, std::string& out) : format(format), out(out) {}
+
+    void nil() { byte(format == BinaryFormat::MsgPack ? 0xc0 : 0xf6); }
+
+    void boolean(bool value) {
+        if (format == BinaryFormat::MsgPack) byte(value ? 0xc3 : 0xc2);
+        else byte(value ? 0xf5 : 0xf4);
+    }
+
+    void integer(int64_t value) {
+        if (format == BinaryFormat::Cbor) {
+            if (value >= 0) cborHead(0, static_cast<uint64_t>(value));
+            else cborHead(1, static_cast<uint64_t>(-(value + 1)));
+            return;
+        }
+        if (value >= 0) {
+            if (value < 128) byte(static_cast<uint8_t>(value));
+            else if (value <= 0xff) { byte(0xcc); big(value, 1); }
+            else if (value <= 0xffff) { byte(0xcd); big(value, 2); }
+            else if (value <= 0xffffffffLL) { byte(0xce); big(value, 4); }
+            else { byte(0xcf); big(value, 8); }
+        } else {
+            if (value >= -32) byte(static_cast<uint8_t>(value));
+            else if (value >= INT8_MIN) { byte(0xd0); big(static_cast<uint64_t>(value), 1); }
+            else if (value >= INT16_MIN) { byte(0xd1); big(static_cast<uint64_t>(value), 2); }
+            else if (value >= INT32_MIN) { byte(0xd2); big(static_cast<uint64_t>(value), 4); }
+            else { byte(0xd3); big(static_cast<uint64_t>(value), 8); }
+        }
+    }
+
+    void real(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        byte(format == BinaryFormat::MsgPack ? 0xcb : 0xfb);
+        big(bits, 8);
+    }
+
+    void text(const char* data, size_t length) {
+        if (format == BinaryFormat::Cbor) {
+            cborHead(3, length);
+        } else if (length < 32) {
+            byte(static_cast<uint8_t>(0xa0 | length));
+        } else if (length <= 0xff) {
+            byte(0xd9); big(length, 1);
+        } else if (length <= 0xffff) {
+            byte(0xda); big(length, 2);
+        } else {
+            byte(0xdb); big(length, 4);
+        }
+        out.append(data, length);
+    }
+
+    void array(uint32_t count) {
+        if (format == BinaryFormat::Cbor) cborHead(4, count);
+        else if (count < 16) byte(static_cast<uint8_t>(0x90 | count));
+        else if (count <= 0xffff) { byte(0xdc); big(count, 2); }
+        else { byte(0xdd); big(count, 4); }
+    }
+
+    void map(uint32_t count) {
+        if (format == BinaryFormat::Cbor) cborHead(5, count);
+        else if (count < 16) byte(static_cast<uint8_t>(0x80 | count));
+        else if (count <= 0xffff) { byte(0xde); big(count, 2); }
+        else { byte(0xdf); big(count, 4); }
+    }
+
+private:
+    BinaryFormat format;
+    std::string& out;
+
+    void byte(uint8_t value) { out.push_back(static_cast<char>(value)); }
+
+    void big(uint64_t value, int bytes) {
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            byte(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+    void cborHead(uint8_t major, uint64_t value) {
+        uint8_t type = static_cast<uint8_t>(major << 5);
+        if (value < 24) byte(type | static_cast<uint8_t>(value));
+        else if (value <= 0xff) { byte(type | 24); big(value, 1); }
+        else if (value <= 0xffff) { byte(type | 25); big(value, 2); }
+        else if (value <= 0xffffffffULL) { byte(type | 26); big(value, 4); }
+        else { byte(type | 27); big(value, 8); }
+    }
+};
+
+void appendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out.push_back(static_cast<char>(codepoint));
+    } else if (codepoint < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (codepoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+    } else if (codepoint < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (codepoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+    } else {
+        out.push_back(static_cast<char>(0xf0 | (codepoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+    }
+}
+
+// Second pass over a document the Counter has already validated.
+class Emitter {
+public:
+    Emitter(const std::string& text, const std::vector<uint32_t>& counts, Writer& writer)
+        : p(text.data()), end(text.data() + text.size()), counts(counts), writer(writer) {}
+
+    bool run() { return value(); }
+
+private:
+    const char* p;
+    const char* end;
+    const std::vector<uint32_t>& counts;
+    size_t nextCount = 0;
+    Writer& writer;
+    std::string scratch;
+
+    void skipSpace() {
+        while (p < end && isSpace(*p)) p++;
+    }
+
+    bool hex4(uint32_t& value) {
+        if (end - p < 4) return false;
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *p++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return false;
+        }
+        return true;
+    }
+
+    bool string() {
+        const char* start = ++p;
+        // Fast path: no escapes, copy the bytes straight through.
+        while (p < end && *p != '"' && *p != '\\') p++;
+        if (p < end && *p == '"') {
+            writer.text(start, p - start);
+            p++;
+            return true;
+        }
+
+        scratch.assign(start, p - start);
+        while (p < end && *p != '"') {
+            if (*p != '\\') { scratch.push_back(*p++); continue; }
+            p++;
+            if (p >= end) return false;
+            char escape = *p++;
+            switch (escape) {
+                case '"': scratch.push_back('"'); break;
+                case '\\': scratch.push_back('\\'); break;
+                case '/': scratch.push_back('/'); break;
+                case 'b': scratch.push_back('\b'); break;
+                case 'f': scratch.push_back('\f'); break;
+                case 'n': scratch.push_back('\n'); break;
+                case 'r': scratch.push_back('\r'); break;
+                case 't': scratch.push_back('\t'); break;
+                case 'u': {
+                    uint32_t codepoint;
+                    if (!hex4(codepoint)) return false;
+                    if (codepoint >= 0xd800 && codepoint < 0xdc00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                        p += 2;
+                        uint32_t low;
+                        if (!hex4(low)) return false;
+                        codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                    }
+                    appendUtf8(scratch, codepoint);
+                    break;
+                }
+                default: return false;
+            }
+        }
+        if (p >= end) return false;
+        p++;
+        writer.text(scratch.data(), scratch.size());
+        return true;
+    }
+
+    bool number() {
+        const char* start = p;
+        bool integral = true;
+        while (p < end && (std::isdigit(static_cast<unsigned char>(*p)) || *p == '-' || *p == '+' ||
+                           *p == '.' || *p == 'e' || *p == 'E')) {
+            if (*p == '.' || *p == 'e' || *p == 'E') integral = false;
+            p++;
+        }
+        // Fast path for the ids and counters that make up most numbers.
+        if (integral && p - start <= 18) {
+            const char* digit = start;
+            bool negative = *digit == '-';
+            if (negative) digit++;
+            if (digit < p) {
+                int64_t value = 0;
+                while (digit < p && std::isdigit(static_cast<unsigned char>(*digit))) {
+                    value = value * 10 + (*digit++ - '0');
+                }
+                if (digit == p) {
+                    writer.integer(negative ? -value : value);
+                    return true;
+                }
+            }
+        }
+
+        std::string token(start, p - start);
+        char* parsedEnd = nullptr;
+        errno = 0;
+        if (integral) {
+            long long value = std::strtoll(token.c_str(), &parsedEnd, 10);
+            if (errno == 0 && *parsedEnd == '\0') {
+                writer.integer(value);
+                return true;
+            }
+        }
+        double value = std::strtod(token.c_str(), &parsedEnd);
+        if (*parsedEnd != '\0') return false;
+        writer.real(value);
+        return true;
+    }
+
+    bool container(bool object) {
+        uint32_t count = counts[nextCount++];
+        if (object) writer.map(count);
+        else writer.array(count);
+        p++;
+        for (uint32_t i = 0; i < count; i++) {
+            skipSpace();
+            if (object) {
+                if (!string()) return false;
+                skipSpace();
+                p++;  // ':'
+            }
+            if (!value()) return false;
+            skipSpace();
+            p++;  // ',' or the closing bracket
+        }
+        if (count == 0) {
+            skipSpace();
+            p++;
+        }
+        return true;
+    }
+
+    bool value() {
+        skipSpace();
+        switch (*p) {
+            case '{': return container(true);
+            case '[': return container(false);
+            case '"': return string();
+            case 't': p += 4; writer.boolean(true); return true;
+            case 'f': p += 5; writer.boolean(false); return true;
+            case 'n': p += 4; writer.nil(); return true;
+            default: return number();
+        }
+    }
+};
+
+void writeBody(const ResponseBody& body, Writer& writer);
+
+} // namespace
+
+bool BinaryEncoding::negotiate(const std::string& accept, BinaryFormat& format) {
+    // Best q and list position per candidate; -1 means the client never named it
+    double msgpack = -1, cbor = -1, json = -1, anyApplication = -1, any = -1;
+    size_t msgpackAt = 0, cborAt = 0;
+
+    size_t start = 0;
+    for (size_t position = 0; start <= accept.size(); position++) {
+        size_t comma = accept.find(',', start);
+        if (comma == std::string::npos) comma = accept.size();
+        std::string range = accept.substr(start, comma - start);
+        start = comma + 1;
+
+        size_t semicolon = range.find(';');
+        std::string type = range.substr(0, semicolon);
+        type.erase(0, type.find_first_not_of(" \t"));
+        type.erase(type.find_last_not_of(" \t") + 1);
+        for (char& c : type) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        if (type.empty()) continue;
+
+        double q = 1;
+        while (semicolon != std::string::npos) {
+            size_t next = range.find(';', semicolon + 1);
+            std::string parameter = range.substr(semicolon + 1, next == std::string::npos ? std::string::npos
+                                                                                            : next - semicolon - 1);
+            parameter.erase(0, parameter.find_first_not_of(" \t"));
+            if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+                char* parsedEnd = nullptr;
+                double value = std::strtod(parameter.c_str() + 2, &parsedEnd);
+                if (parsedEnd != parameter.c_str() + 2) q = std::min(1.0, std::max(0.0, value));
+            }
+            semicolon = next;
+        }
+
+        if (type == "application/msgpack" || type == "application/x-msgpack") {
+            if (q > msgpack) { msgpack = q; msgpackAt = position; }
+        } else if (type == "application/cbor") {
+            if (q > cbor) { cbor = q; cborAt = position; }
+        } else if (type == "application/json") {
+            json = std::max(json, q);
+        } else if (type == "application/*") {
+            anyApplication = std::max(anyApplication, q);
+        } else if (type == "*/*") {
+            any = std::max(any, q);
+        }
+    }
+
+    // the most specific range that matches JSON decides its q
+    double jsonQ = json >= 0 ? json : anyApplication >= 0 ? anyApplication : std::max(any, 0.0);
+
+    bool preferMsgPack = msgpack > cbor || (msgpack == cbor && msgpackAt < cborAt);
+    double best = preferMsgPack ? msgpack : cbor;
+    if (best <= 0 || best < jsonQ) return false;
+    format = preferMsgPack ? BinaryFormat::MsgPack : BinaryFormat::Cbor;
+    return true;
+}
+
+const char* BinaryEncoding::contentType(BinaryFormat format) {
+    return format == BinaryFormat::MsgPack ? "application/msgpack" : "application/cbor";
+}
+
+bool BinaryEncoding::fromJson(const std::string& json, BinaryFormat format, std::string& out) {
+    std::vector<uint32_t> counts;
+    Counter counter(json, counts);
+    if (!counter.run()) return false;
+
+    out.clear();
+    out.reserve(json.size());
+    Writer writer(format, out);
+    Emitter emitter(json, counts, writer);
+    return emitter.run();
+}
+
+void BinaryEncoding::encode(const ResponseBody& body, BinaryFormat format, std::string& out) {
+    out.clear();
+    Writer writer(format, out);
+    writeBody(body, writer);
+}
+
+namespace {
+
+void writeBody(const ResponseBody& body, Writer& writer) {
+    switch (body.getType()) {
+        case ResponseBody::Type::Null: writer.nil(); break;
+        case ResponseBody::Type::Boolean: writer.boolean(body.getBoolean()); break;
+        case ResponseBody::Type::Integer: writer.integer(body.getInteger()); break;
+        case ResponseBody::Type::Real: writer.real(body.getReal()); break;
+        case ResponseBody::Type::Text: writer.text(body.getText().data(), body.getText().size()); break;
+        case ResponseBody::Type::List:
+            writer.array(static_cast<uint32_t>(body.getItems().size()));
+            for (const auto& item : body.getItems()) writeBody(item, writer);
+            break;
+        case ResponseBody::Type::Object: {
+            const auto& keys = body.getKeys();
+            const auto& items = body.getItems();
+            writer.map(static_cast<uint32_t>(items.size()));
+            for (size_t i = 0; i < items.size(); i++) {
+                writer.text(keys[i].data(), keys[i].size());
+                writeBody(items[i], writer);
+            }
+            break;
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,201 @@
+#include "change_feed.h"
+#include <algorithm>
+#include <cstdio>
+
+ChangeFeed* ChangeFeed::instance = nullptr;
+
+namespace {
+
+std::string jsonString(const std::string& value) {
+    std::string out = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+} // namespace
+
+ChangeFeed& ChangeFeed::getInstance() {
+    if (!instance) {
+        instance = new ChangeFeed();
+    }
+    return *instance;
+}
+
+ChangeFeed::~ChangeFeed() {
+    stop();
+}
+
+void ChangeFeed::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return;
+    running = true;
+    dispatcher = std::thread(&ChangeFeed::dispatchLoop, this);
+}
+
+void ChangeFeed::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    wake.notify_all();
+    dispatcher.join();
+}
+
+void ChangeFeed::publish(const std::string& entity, const std::string& action, int entityID,
+                         int patientID, int doctorID, const std::string& date) {
+    auto event = std::make_shared<ChangeEvent>();
+    event->entity = entity;
+    event->action = action;
+    event->data = "{\"entity\":" + jsonString(entity) +
+                  ",\"action\":" + jsonString(action) +
+                  ",\"id\":" + std::to_string(entityID) +
+                  ",\"patient_id\":" + std::to_string(patientID) +
+                  ",\"doctor_id\":" + std::to_string(doctorID) +
+                  ",\"date\":" + jsonString(date) + "}";
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        event->id = ++lastID;
+        history.push_back(event);
+        if (history.size() > kHistorySize) {
+            history.pop_front();
+        }
+
+        for (auto& subscriber : subscribers) {
+            if (subscriber->overflowed) continue;
+            if (subscriber->count == subscriber->ring.size()) {
+                // Slow consumer: stop buffering and let it resynchronise.
+                subscriber->overflowed = true;
+                continue;
+            }
+            subscriber->ring[(subscriber->head + subscriber->count) % subscriber->ring.size()] = event;
+            subscriber->count++;
+        }
+    }
+    wake.notify_one();
+}
+
+bool ChangeFeed::subscribe(bool resume, uint64_t lastEventID, Deliver deliver) {
+    std::vector<std::shared_ptr<const ChangeEvent>> replay;
+    bool reset = false;
+    uint64_t position;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (resume && lastEventID < lastID) {
+            uint64_t oldest = history.empty() ? lastID + 1 : history.front()->id;
+            if (lastEventID + 1 < oldest) {
+                reset = true;
+            } else {
+                for (size_t i = lastEventID + 1 - oldest; i < history.size() && replay.size() < kSubscriberBuffer; i++) {
+                    replay.push_back(history[i]);
+                }
+            }
+        } else if (resume && lastEventID > lastID) {
+            // The client saw ids from before a server restart.
+            reset = true;
+        }
+
+        if (!reset && replay.empty()) {
+            if (subscribers.size() >= kMaxSubscribers) {
+                return false;
+            }
+            auto subscriber = std::make_shared<Subscriber>();
+            subscriber->ring.resize(kSubscriberBuffer);
+            subscriber->deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kPollSeconds);
+            subscriber->deliver = std::move(deliver);
+            subscribers.push_back(subscriber);
+            return true;
+        }
+        position = lastID;
+    }
+
+    deliver(render(replay, reset, position));
+    return true;
+}
+
+void ChangeFeed::dispatchLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        wake.wait_for(lock, std::chrono::seconds(1));
+
+        auto now = std::chrono::steady_clock::now();
+        std::vector<std::pair<std::shared_ptr<Subscriber>, std::vector<std::shared_ptr<const ChangeEvent>>>> ready;
+        uint64_t position = lastID;
+        for (auto it = subscribers.begin(); it != subscribers.end();) {
+            Subscriber& subscriber = **it;
+            if (running && subscriber.count == 0 && !subscriber.overflowed && now < subscriber.deadline) {
+                ++it;
+                continue;
+            }
+
+            std::vector<std::shared_ptr<const ChangeEvent>> events;
+            if (!subscriber.overflowed) {
+                for (size_t i = 0; i < subscriber.count; i++) {
+                    events.push_back(subscriber.ring[(subscriber.head + i) % subscriber.ring.size()]);
+                }
+            } else {
+                droppedSubscribers++;
+            }
+            ready.emplace_back(*it, std::move(events));
+            it = subscribers.erase(it);
+        }
+
+        if (ready.empty()) continue;
+
+        // Rendering and completing responses happens without the lock so
+        // publishers are never blocked behind the network.
+        lock.unlock();
+        for (auto& entry : ready) {
+            entry.first->deliver(render(entry.second, entry.first->overflowed, position));
+        }
+        lock.lock();
+    }
+}
+
+std::string ChangeFeed::render(const std::vector<std::shared_ptr<const ChangeEvent>>& events, bool reset,
+                               uint64_t position) {
+    std::string body = "retry: " + std::to_string(kRetryMillis) + "\n\n";
+    if (reset) {
+        body += "id: " + std::to_string(position) + "\nevent: reset\ndata: {}\n\n";
+        return body;
+    }
+
+    for (const auto& event : events) {
+        body += "id: " + std::to_string(event->id) + "\n";
+        body += "event: " + event->entity + "\n";
+        body += "data: " + event->data + "\n\n";
+    }
+    if (events.empty()) {
+        // Nothing happened before the poll deadline. The bare id keeps the
+        // client's Last-Event-ID current so the next request resumes here.
+        body += ": keepalive\nid: " + std::to_string(position) + "\n\n";
+    }
+    return body;
+}
+
+size_t ChangeFeed::subscriberCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscribers.size();
+}
+
+uint64_t ChangeFeed::droppedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return droppedSubscribers;
+}
@@ -0,0 +1,127 @@
+#include "dashboard.h"
+#include "database_handler.h"
+#include "statistics.h"
+#include <sqlite3.h>
+#include <stdexcept>
+
+namespace {
+
+sqlite3_stmt* prepare(sqlite3* db, const char* sql) {
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare dashboard statement: " +
+                               std::string(sqlite3_errmsg(db)));
+    }
+    return stmt;
+}
+
+std::string columnText(sqlite3_stmt* stmt, int column) {
+    const unsigned char* text = sqlite3_column_text(stmt, column);
+    return text ? reinterpret_cast<const char*>(text) : "";
+}
+
+DashboardAppointment readAppointment(sqlite3_stmt* stmt) {
+    DashboardAppointment appointment;
+    appointment.appointmentID = sqlite3_column_int(stmt, 0);
+    appointment.patientID = sqlite3_column_int(stmt, 1);
+    appointment.patientName = columnText(stmt, 2);
+    appointment.doctorID = sqlite3_column_int(stmt, 3);
+    appointment.doctorName = columnText(stmt, 4);
+    appointment.date = columnText(stmt, 5);
+    appointment.time = columnText(stmt, 6);
+    appointment.status = columnText(stmt, 7);
+    return appointment;
+}
+
+// Both appointment lists walk idx_appointments_date from a fixed starting point.
+const char* kAppointmentColumns =
+    "SELECT a.appointmentID, a.patientID, pu.name, a.doctorID, du.name, a.date, a.time, a.status "
+    "FROM Appointments a "
+    "JOIN Patients p ON a.patientID = p.patientID JOIN Users pu ON p.userID = pu.userID "
+    "JOIN Doctors d ON a.doctorID = d.doctorID JOIN Users du ON d.userID = du.userID ";
+
+} // namespace
+
+DashboardSummary Dashboard::getSummary() {
+    DashboardSummary summary;
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+
+    sqlite3_stmt* stmt = prepare(db, "SELECT date('now', 'localtime'), date('now', 'localtime', '+6 days');");
+    std::string weekEnd;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        summary.today = columnText(stmt, 0);
+        weekEnd = columnText(stmt, 1);
+    }
+    sqlite3_finalize(stmt);
+
+    summary.totalPatients = Statistics::getEntityCount("patients");
+    summary.totalDoctors = Statistics::getEntityCount("doctors");
+    summary.appointmentsByStatus = Statistics::getAppointmentStatusCounts();
+    for (const auto& entry : summary.appointmentsByStatus) {
+        summary.totalAppointments += entry.second;
+    }
+    for (const auto& entry : Statistics::getRecordCountsByDoctor()) {
+        summary.totalRecords += entry.second;
+    }
+
+    stmt = prepare(db, (std::string(kAppointmentColumns) +
+                        "WHERE a.date = ? ORDER BY a.time, a.appointmentID LIMIT ?;").c_str());
+    sqlite3_bind_text(stmt, 1, summary.today.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, kMaxTodaysAppointments);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        summary.todaysAppointments.push_back(readAppointment(stmt));
+    }
+    sqlite3_finalize(stmt);
+
+    stmt = prepare(db, (std::string(kAppointmentColumns) +
+                        "WHERE a.date > ? AND a.status = 'scheduled' "
+                        "ORDER BY a.date, a.time, a.appointmentID LIMIT ?;").c_str());
+    sqlite3_bind_text(stmt, 1, summary.today.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, kUpcomingAppointments);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        summary.upcomingAppointments.push_back(readAppointment(stmt));
+    }
+    sqlite3_finalize(stmt);
+
+    // Only doctors with something booked this week appear in the load table.
+    stmt = prepare(db,
+        "SELECT s.doctorID, u.name, "
+        "       SUM(CASE WHEN s.date = ?1 THEN s.appointment_count ELSE 0 END), "
+        "       SUM(s.appointment_count) "
+        "FROM DoctorDailyAppointmentStats s "
+        "JOIN Doctors d ON s.doctorID = d.doctorID JOIN Users u ON d.userID = u.userID "
+        "WHERE s.date BETWEEN ?1 AND ?2 "
+        "GROUP BY s.doctorID ORDER BY SUM(s.appointment_count) DESC, s.doctorID;");
+    sqlite3_bind_text(stmt, 1, summary.today.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, weekEnd.c_str(), -1, SQLITE_TRANSIENT);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        DashboardDoctorLoad load;
+        load.doctorID = sqlite3_column_int(stmt, 0);
+        load.doctorName = columnText(stmt, 1);
+        load.today = sqlite3_column_int(stmt, 2);
+        load.nextSevenDays = sqlite3_column_int(stmt, 3);
+        summary.doctorLoad.push_back(load);
+    }
+    sqlite3_finalize(stmt);
+
+    stmt = prepare(db,
+        "SELECT m.recordID, m.patientID, pu.name, du.name, m.diagnosis, m.date "
+        "FROM MedicalRecords m "
+        "JOIN Patients p ON m.patientID = p.patientID JOIN Users pu ON p.userID = pu.userID "
+        "JOIN Doctors d ON m.doctorID = d.doctorID JOIN Users du ON d.userID = du.userID "
+        "ORDER BY m.recordID DESC LIMIT ?;");
+    sqlite3_bind_int(stmt, 1, kRecentRecords);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        DashboardRecord record;
+        record.recordID = sqlite3_column_int(stmt, 0);
+        record.patientID = sqlite3_column_int(stmt, 1);
+        record.patientName = columnText(stmt, 2);
+        record.doctorName = columnText(stmt, 3);
+        record.diagnosis = columnText(stmt, 4);
+        record.date = columnText(stmt, 5);
+        summary.recentRecords.push_back(record);
+    }
+    sqlite3_finalize(stmt);
+
+    return summary;
+}
@@ -0,0 +1,260 @@
+#include "data_exporter.h"
+#include "database_handler.h"
+#include "archive_manager.h"
+#include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+std::string DataExporter::exportDirectory = "exports";
+
+namespace {
+
+const size_t kWriteBufferSize = 1 << 20;
+const auto kSpoolLifetime = std::chrono::minutes(15);
+
+struct ExportQuery {
+    const char* columns;
+    const char* table;
+    const char* rest;
+};
+
+const ExportQuery* exportQuery(const std::string& table) {
+    static const ExportQuery appointments = {
+        "appointmentID AS id, patientID AS patient_id, doctorID AS doctor_id, date, time, status, notes",
+        "Appointments", " WHERE date BETWEEN ?1 AND ?2 ORDER BY appointmentID;"};
+    static const ExportQuery records = {
+        "recordID AS id, patientID AS patient_id, doctorID AS doctor_id, diagnosis, treatment, date",
+        "MedicalRecords", " WHERE date BETWEEN ?1 AND ?2 ORDER BY recordID;"};
+    static const ExportQuery prescriptions = {
+        "prescriptionID AS id, patientID AS patient_id, doctorID AS doctor_id, medicine, dosage, date",
+        "Prescriptions", " WHERE date BETWEEN ?1 AND ?2 ORDER BY prescriptionID;"};
+    static const ExportQuery patients = {
+        "p.patientID AS id, p.userID AS user_id, u.name, u.contact, p.age, p.gender",
+        "Patients", " p JOIN Users u ON p.userID = u.userID ORDER BY p.patientID;"};
+
+    if (table == "appointments") {
+        return &appointments;
+    } else if (table == "records") {
+        return &records;
+    } else if (table == "prescriptions") {
+        return &prescriptions;
+    } else if (table == "patients") {
+        return &patients;
+    }
+    return nullptr;
+}
+
+void writeCsvField(std::FILE* out, const unsigned char* text, int length) {
+    bool quote = false;
+    for (int i = 0; i < length && !quote; i++) {
+        char c = static_cast<char>(text[i]);
+        quote = c == ',' || c == '"' || c == '\n' || c == '\r';
+    }
+    if (!quote) {
+        std::fwrite(text, 1, length, out);
+        return;
+    }
+    std::fputc('"', out);
+    for (int i = 0; i < length; i++) {
+        if (text[i] == '"') std::fputc('"', out);
+        std::fputc(text[i], out);
+    }
+    std::fputc('"', out);
+}
+
+void writeJsonString(std::FILE* out, const unsigned char* text, int length) {
+    static const char hex[] = "0123456789abcdef";
+    std::fputc('"', out);
+    for (int i = 0; i < length; i++) {
+        unsigned char c = text[i];
+        switch (c) {
+            case '"': std::fputs("\\\"", out); break;
+            case '\\': std::fputs("\\\\", out); break;
+            case '\n': std::fputs("\\n", out); break;
+            case '\r': std::fputs("\\r", out); break;
+            case '\t': std::fputs("\\t", out); break;
+            default:
+                if (c < 0x20) {
+                    char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+                    std::fwrite(escaped, 1, sizeof(escaped), out);
+                } else {
+                    std::fputc(c, out);
+                }
+        }
+    }
+    std::fputc('"', out);
+}
+
+// Removes a spool file that was never handed out.
+class PartialFile {
+private:
+    std::string path;
+
+public:
+    explicit PartialFile(const std::string& path) : path(path) {}
+    ~PartialFile() {
+        if (!path.empty()) std::remove(path.c_str());
+    }
+    void release() { path.clear(); }
+};
+
+} // namespace
+
+ExportFile::ExportFile(const std::string& path) : path(path) {}
+
+ExportFile::~ExportFile() {
+    std::error_code ec;
+    fs::remove(path, ec);
+}
+
+const std::string& ExportFile::getPath() const { return path; }
+
+bool DataExporter::isExportableTable(const std::string& table) {
+    return exportQuery(table) != nullptr;
+}
+
+bool DataExporter::parseFormat(const std::string& name, Format& format) {
+    if (name.empty() || name == "csv") {
+        format = Format::CSV;
+    } else if (name == "ndjson") {
+        format = Format::NDJSON;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string DataExporter::contentType(Format format) {
+    return format == Format::CSV ? "text/csv; charset=utf-8" : "application/x-ndjson";
+}
+
+void DataExporter::setExportDirectory(const std::string& directory) {
+    exportDirectory = directory;
+}
+
+void DataExporter::removeStaleExports() {
+    std::error_code ec;
+    auto now = fs::file_time_type::clock::now();
+    for (const auto& entry : fs::directory_iterator(exportDirectory, ec)) {
+        if (entry.is_regular_file(ec) && now - entry.last_write_time(ec) > kSpoolLifetime) {
+            fs::remove(entry.path(), ec);
+        }
+    }
+}
+
+std::shared_ptr<ExportFile> DataExporter::exportTable(const std::string& table, Format format,
+                                                     const std::string& startDate, const std::string& endDate) {
+    const ExportQuery* query = exportQuery(table);
+    if (!query) {
+        throw std::invalid_argument("Invalid export table");
+    }
+
+    std::string from = startDate.empty() ? "0000-01-01" : startDate;
+    std::string to = endDate.empty() ? "9999-12-31" : endDate;
+
+    // a private read-only connection, with the archive years attached when
+    // the range reaches archived rows
+    std::unique_ptr<ArchiveScope> archive;
+    std::unique_ptr<sqlite3, int (*)(sqlite3*)> ownConnection(nullptr, sqlite3_close);
+    sqlite3* db;
+    std::string source = query->table;
+    if (ArchiveManager::isArchived(query->table)) {
+        archive = std::make_unique<ArchiveScope>(from, to);
+        if (!archive->complete()) {
+            throw std::invalid_argument("Export range spans too many archive years");
+        }
+        db = archive->connection();
+        source = archive->source(query->table);
+    } else {
+        ownConnection.reset(DatabaseHandler::getInstance().openReadOnlyConnection());
+        db = ownConnection.get();
+    }
+
+    std::string sql = std::string("SELECT ") + query->columns + " FROM " + source + query->rest;
+    sqlite3_stmt* raw;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &raw, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare export statement: " + std::string(sqlite3_errmsg(db)));
+    }
+    std::unique_ptr<sqlite3_stmt, int (*)(sqlite3_stmt*)> stmt(raw, sqlite3_finalize);
+
+    if (sqlite3_bind_parameter_count(stmt.get()) == 2) {
+        sqlite3_bind_text(stmt.get(), 1, from.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt.get(), 2, to.c_str(), -1, SQLITE_TRANSIENT);
+    }
+
+    std::error_code ec;
+    fs::create_directories(exportDirectory, ec);
+    removeStaleExports();
+
+    static std::atomic<unsigned long> sequence{0};
+    auto stamp = std::chrono::system_clock::now().time_since_epoch().count();
+    std::string path = exportDirectory + "/" + table + "-" + std::to_string(stamp) + "-" +
+                       std::to_string(sequence++) + (format == Format::CSV ? ".csv" : ".ndjson");
+
+    // declared before the FILE so the file is closed before it is removed,
+    // and the buffer must outlive the FILE, which flushes through it on close
+    PartialFile partial(path);
+    std::unique_ptr<char[]> buffer(new char[kWriteBufferSize]);
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> out(std::fopen(path.c_str(), "wb"), std::fclose);
+    if (!out) {
+        throw std::runtime_error("Failed to create export file " + path);
+    }
+    std::setvbuf(out.get(), buffer.get(), _IOFBF, kWriteBufferSize);
+
+    int columns = sqlite3_column_count(stmt.get());
+    if (format == Format::CSV) {
+        for (int c = 0; c < columns; c++) {
+            if (c > 0) std::fputc(',', out.get());
+            std::fputs(sqlite3_column_name(stmt.get(), c), out.get());
+        }
+        std::fputc('\n', out.get());
+    }
+
+    int rc;
+    while ((rc = sqlite3_step(stmt.get())) == SQLITE_ROW) {
+        if (format == Format::NDJSON) std::fputc('{', out.get());
+        for (int c = 0; c < columns; c++) {
+            if (format == Format::CSV) {
+                if (c > 0) std::fputc(',', out.get());
+            } else {
+                if (c > 0) std::fputc(',', out.get());
+                std::fprintf(out.get(), "\"%s\":", sqlite3_column_name(stmt.get(), c));
+            }
+
+            switch (sqlite3_column_type(stmt.get(), c)) {
+                case SQLITE_NULL:
+                    if (format == Format::NDJSON) std::fputs("null", out.get());
+                    break;
+                case SQLITE_INTEGER:
+                    std::fprintf(out.get(), "%lld", static_cast<long long>(sqlite3_column_int64(stmt.get(), c)));
+                    break;
+                default: {
+                    const unsigned char* text = sqlite3_column_text(stmt.get(), c);
+                    int length = sqlite3_column_bytes(stmt.get(), c);
+                    if (format == Format::CSV) {
+                        writeCsvField(out.get(), text, length);
+                    } else {
+                        writeJsonString(out.get(), text, length);
+                    }
+                }
+            }
+        }
+        std::fputs(format == Format::CSV ? "\n" : "}\n", out.get());
+    }
+
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error("Export of " + table + " failed: " + std::string(sqlite3_errmsg(db)));
+    }
+    if (std::fclose(out.release()) != 0) {
+        throw std::runtime_error("Failed to write export file " + path);
+    }
+    partial.release();
+    return std::make_shared<ExportFile>(path);
+}
@@ -1,15 +1,30 @@
 #include "database_handler.h"
+#include "query_budget.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
 #include <iostream>
 
 DatabaseHandler* DatabaseHandler::instance = nullptr;
 
-DatabaseHandler::DatabaseHandler(const std::string& dbName) {
+DatabaseHandler::DatabaseHandler(const std::string& dbName) : dbName(dbName) {
     if (sqlite3_open(dbName.c_str(), &db) != SQLITE_OK) {
         throw std::runtime_error("Failed to open database: " + std::string(sqlite3_errmsg(db)));
     }
+
+    // Readers on other connections (analytics, maintenance) no longer block
+    // the writer under WAL, but the writer can now meet the maintenance
+    // connection's checkpoints and vacuums, so it waits instead of failing.
+    sqlite3_busy_timeout(db, 5000);
+    QueryBudget::install(db);
+    // only takes effect on a database that has no tables yet
+    execute("PRAGMA auto_vacuum = INCREMENTAL;");
+    execute("PRAGMA journal_mode = WAL;");
 }
 
 DatabaseHandler::~DatabaseHandler() {
+    stopMaintenance();
     sqlite3_close(db);
 }
 
@@ -24,6 +39,200 @@ sqlite3* DatabaseHandler::getDatabase() const {
     return db;
 }
 
+const std::string& DatabaseHandler::getDatabaseName() const {
+    return dbName;
+}
+
+sqlite3* DatabaseHandler::openReadOnlyConnection() const {
+    sqlite3* conn = nullptr;
+    if (sqlite3_open_v2(dbName.c_str(), &conn, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+        std::string error = conn ? sqlite3_errmsg(conn) : "out of memory";
+        sqlite3_close(conn);
+        throw std::runtime_error("Failed to open read-only connection: " + error);
+    }
+    sqlite3_busy_timeout(conn, 5000);
+    QueryBudget::install(conn);
+    return conn;
+}
+
+sqlite3* DatabaseHandler::openWriteConnection() const {
+    sqlite3* conn = nullptr;
+    if (sqlite3_open_v2(dbName.c_str(), &conn, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+        std::string error = conn ? sqlite3_errmsg(conn) : "out of memory";
+        sqlite3_close(conn);
+        throw std::runtime_error("Failed to open write connection: " + error);
+    }
+    sqlite3_busy_timeout(conn, 5000);
+    QueryBudget::install(conn);
+    return conn;
+}
+
+namespace {
+
+int64_t fileSize(const std::string& path) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<int64_t>(size);
+}
+
+int pragmaValue(sqlite3* conn, const char* sql) {
+    sqlite3_stmt* stmt;
+    int value = 0;
+    if (sqlite3_prepare_v2(conn, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            value = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    return value;
+}
+
+} // namespace
+
+void DatabaseHandler::startMaintenance(const MaintenanceSettings& settings) {
+    std::lock_guard<std::mutex> lock(maintenanceMutex);
+    if (maintenanceRunning) return;
+    maintenanceSettings = settings;
+    maintenanceRunning = true;
+
+    // Commit-time checkpoints stay on only as a backstop past the truncate
+    // threshold, so writers no longer pay for routine checkpoints.
+    int pageSize = std::max(1, pragmaValue(db, "PRAGMA page_size;"));
+    int backstopPages = static_cast<int>(std::max<int64_t>(1000, settings.truncateCheckpointBytes / pageSize * 2));
+    execute("PRAGMA wal_autocheckpoint = " + std::to_string(backstopPages) + ";");
+
+    maintenanceWorker = std::thread(&DatabaseHandler::maintenanceLoop, this);
+}
+
+void DatabaseHandler::stopMaintenance() {
+    {
+        std::lock_guard<std::mutex> lock(maintenanceMutex);
+        if (!maintenanceRunning) return;
+        maintenanceRunning = false;
+    }
+    maintenanceSignal.notify_all();
+    if (maintenanceWorker.joinable()) {
+        maintenanceWorker.join();
+    }
+}
+
+MaintenanceMetrics DatabaseHandler::getMaintenanceMetrics() const {
+    std::lock_guard<std::mutex> lock(maintenanceMutex);
+    return maintenanceMetrics;
+}
+
+void DatabaseHandler::maintenanceLoop() {
+    using Clock = std::chrono::steady_clock;
+
+    sqlite3* conn = nullptr;
+    if (sqlite3_open_v2(dbName.c_str(), &conn, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+        std::cerr << "Database maintenance disabled: " << (conn ? sqlite3_errmsg(conn) : "out of memory")
+                  << std::endl;
+        sqlite3_close(conn);
+        return;
+    }
+    // how long a truncate checkpoint or vacuum waits for others before
+    // giving up until the next check
+    sqlite3_busy_timeout(conn, 200);
+
+    MaintenanceSettings settings;
+    {
+        std::lock_guard<std::mutex> lock(maintenanceMutex);
+        settings = maintenanceSettings;
+    }
+    const std::string walPath = dbName + "-wal";
+    const bool incrementalVacuum = pragmaValue(conn, "PRAGMA auto_vacuum;") == 2;
+
+    int64_t lastVersion = getDataVersion();
+    int64_t checkpointedVersion = -1;
+    Clock::time_point lastChange = Clock::now();
+    Clock::time_point lastOptimize = lastChange;
+    Clock::time_point lastVacuum = lastChange;
+
+    std::unique_lock<std::mutex> lock(maintenanceMutex);
+    while (maintenanceRunning) {
+        lock.unlock();
+
+        Clock::time_point now = Clock::now();
+        int64_t version = getDataVersion();
+        if (version != lastVersion) {
+            lastVersion = version;
+            lastChange = now;
+        }
+        bool idle = now - lastChange >= std::chrono::seconds(settings.idleSeconds);
+
+        // A passively checkpointed WAL keeps its size while its frames are
+        // reused, so passive checkpoints only run after new commits; a
+        // truncate checkpoint is what gives the space back.
+        int64_t walBytes = fileSize(walPath);
+        int mode = -1;
+        if (walBytes >= settings.truncateCheckpointBytes || (idle && walBytes > 0)) {
+            mode = SQLITE_CHECKPOINT_TRUNCATE;
+        } else if (walBytes >= settings.passiveCheckpointBytes && version != checkpointedVersion) {
+            mode = SQLITE_CHECKPOINT_PASSIVE;
+        }
+
+        if (mode >= 0) {
+            int logFrames = 0;
+            int checkpointed = 0;
+            auto start = Clock::now();
+            int rc = sqlite3_wal_checkpoint_v2(conn, nullptr, mode, &logFrames, &checkpointed);
+            std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+            if (rc != SQLITE_OK && rc != SQLITE_BUSY) {
+                std::cerr << "WAL checkpoint failed: " << sqlite3_errmsg(conn) << std::endl;
+            }
+            checkpointedVersion = version;
+
+            std::lock_guard<std::mutex> metricsLock(maintenanceMutex);
+            MaintenanceMetrics& m = maintenanceMetrics;
+            if (rc == SQLITE_BUSY || (rc == SQLITE_OK && checkpointed < logFrames)) {
+                m.busyCheckpoints++;
+            } else if (rc == SQLITE_OK) {
+                (mode == SQLITE_CHECKPOINT_TRUNCATE ? m.truncateCheckpoints : m.passiveCheckpoints)++;
+            }
+            m.walFrames = logFrames;
+            m.checkpointedFrames = checkpointed;
+            m.lastCheckpointMillis = elapsed.count();
+            m.lastCheckpointAt = static_cast<int64_t>(std::time(nullptr));
+        }
+
+        // optimize uses what the shared connection has queried, so it runs there
+        if (idle && now - lastOptimize >= std::chrono::minutes(settings.optimizeMinutes)) {
+            lastOptimize = now;
+            try {
+                execute("PRAGMA optimize;");
+                std::lock_guard<std::mutex> metricsLock(maintenanceMutex);
+                maintenanceMetrics.optimizeRuns++;
+            } catch (const std::exception& e) {
+                std::cerr << "PRAGMA optimize failed: " << e.what() << std::endl;
+            }
+        }
+
+        if (incrementalVacuum && idle && now - lastVacuum >= std::chrono::minutes(settings.vacuumMinutes)) {
+            lastVacuum = now;
+            std::string sql = "PRAGMA incremental_vacuum(" + std::to_string(settings.vacuumPages) + ");";
+            if (sqlite3_exec(conn, sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK) {
+                std::lock_guard<std::mutex> metricsLock(maintenanceMutex);
+                maintenanceMetrics.vacuumRuns++;
+            } else {
+                std::cerr << "Incremental vacuum failed: " << sqlite3_errmsg(conn) << std::endl;
+            }
+        }
+
+        int freelistPages = pragmaValue(conn, "PRAGMA freelist_count;");
+        walBytes = fileSize(walPath);
+
+        lock.lock();
+        maintenanceMetrics.walBytes = walBytes;
+        maintenanceMetrics.freelistPages = freelistPages;
+        maintenanceSignal.wait_for(lock, std::chrono::seconds(settings.checkSeconds),
+                                   [this]() { return !maintenanceRunning; });
+    }
+    lock.unlock();
+    sqlite3_close(conn);
+}
+
 void DatabaseHandler::execute(const std::string& sql) {
     char* errMsg = nullptr;
     if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
@@ -33,6 +242,51 @@ void DatabaseHandler::execute(const std::string& sql) {
     }
 }
 
+void DatabaseHandler::rollback() {
+    QueryBudget::Scope unlimited(QueryBudget::Clock::time_point::max());
+    if (!sqlite3_get_autocommit(db)) {
+        execute("ROLLBACK;");
+    }
+}
+
+void DatabaseHandler::recordExternalChanges(int64_t rows) {
+    externalChanges += rows;
+}
+
+int64_t DatabaseHandler::getDataVersion() const {
+    // both terms only grow, so the sum stays put only while neither moves
+    return sqlite3_total_changes64(db) + externalChanges.load();
+}
+
+bool DatabaseHandler::tableExists(const std::string& tableName) {
+    sqlite3_stmt* stmt;
+    std::string sql = "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?;";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
+    }
+
+    sqlite3_bind_text(stmt, 1, tableName.c_str(), -1, SQLITE_TRANSIENT);
+    bool exists = sqlite3_step(stmt) == SQLITE_ROW;
+
+    sqlite3_finalize(stmt);
+    return exists;
+}
+
+bool DatabaseHandler::tableIsEmpty(const std::string& tableName) {
+    sqlite3_stmt* stmt;
+    std::string sql = "SELECT 1 FROM \"" + tableName + "\" LIMIT 1;";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare statement: " + std::string(sqlite3_errmsg(db)));
+    }
+
+    bool empty = sqlite3_step(stmt) != SQLITE_ROW;
+
+    sqlite3_finalize(stmt);
+    return empty;
+}
+
 void DatabaseHandler::initializeDatabase() {
     // Create tables if they don't exist
     execute("BEGIN TRANSACTION;");
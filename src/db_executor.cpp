@@ -0,0 +1,95 @@
+#include "db_executor.h"
+#include "query_budget.h"
+#include <algorithm>
+#include <iostream>
+
+DbExecutor* DbExecutor::instance = nullptr;
+
+DbExecutor& DbExecutor::getInstance() {
+    if (!instance) {
+        instance = new DbExecutor();
+    }
+    return *instance;
+}
+
+DbExecutor::~DbExecutor() {
+    stop();
+}
+
+void DbExecutor::start(size_t threadCount) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return;
+    running = true;
+    for (size_t i = 0; i < std::max<size_t>(threadCount, 1); i++) {
+        workers.emplace_back(&DbExecutor::workerLoop, this);
+    }
+}
+
+void DbExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+    }
+    taskReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void DbExecutor::submit(std::function<void()> task) {
+    // the task runs under the submitting request's budget, including
+    // coroutine steps and whenAll branches that hop onto the pool
+    if (QueryBudget::BudgetPtr budget = QueryBudget::current()) {
+        task = [inner = std::move(task), budget = std::move(budget)]() {
+            QueryBudget::Scope scope(budget);
+            inner();
+        };
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running) {
+            tasks.push_back(std::move(task));
+            taskReady.notify_one();
+            return;
+        }
+    }
+    task();
+}
+
+void DbExecutor::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        taskReady.wait(lock, [this]{ return !running || !tasks.empty(); });
+        // Drain what is queued before exiting so no response is left open.
+        if (tasks.empty()) return;
+
+        auto task = std::move(tasks.front());
+        tasks.pop_front();
+        busyWorkers++;
+        lock.unlock();
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Database task failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+        busyWorkers--;
+    }
+}
+
+size_t DbExecutor::threadCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return workers.size();
+}
+
+size_t DbExecutor::queuedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+size_t DbExecutor::busyCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return busyWorkers;
+}
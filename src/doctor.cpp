@@ -1,9 +1,12 @@
 #include "doctor.h"
 #include "database_handler.h"
+#include "people_index.h"
+#include "tables.h"
 #include "patient.h"
 #include "appointment.h"
 #include "record.h"
 #include <sqlite3.h>
+#include <ctime>
 #include <iostream>
 #include <vector>
 
@@ -12,98 +15,71 @@ Doctor::Doctor(int userID, const std::string& name, const std::string& contact,
     : User(userID, name, contact, "doctor"), doctorID(doctorID), specialization(specialization) {}
 
 bool Doctor::saveToDatabase() {
-    // First save the User part
-    if (!User::saveToDatabase()) {
-        return false;
-    }
-
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
 
-    std::string sql = doctorID == 0 ?
-        "INSERT INTO Doctors (doctorID, userID, specialization) VALUES (?, ?, ?);" :
-        "UPDATE Doctors SET specialization = ? WHERE doctorID = ?;";
+    DatabaseHandler::getInstance().execute("BEGIN TRANSACTION;");
+
+    try {
+        // First save the User part
+        writeUserRow();
+
+        if (doctorID == 0) {
+            doctorID = userID; // Use userID as doctorID for consistency
+            DoctorsTable::insertWithKey(db, doctorID, userID, specialization);
+        } else {
+            DoctorsTable::update(db, doctorID, userID, specialization);
+        }
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        DatabaseHandler::getInstance().execute("COMMIT;");
+        PeopleIndex::getInstance().upsert(userID, doctorID, type, name, contact);
+        EntityCache<Doctor>::getInstance().invalidate(doctorID);
+        return true;
+    } catch (const std::exception& e) {
+        DatabaseHandler::getInstance().rollback();
+        std::cerr << "Error saving doctor: " << e.what() << std::endl;
         return false;
     }
+}
 
-    if (doctorID == 0) {
-        doctorID = userID; // Use userID as doctorID for consistency
-        sqlite3_bind_int(stmt, 1, doctorID);
-        sqlite3_bind_int(stmt, 2, userID);
-        sqlite3_bind_text(stmt, 3, specialization.c_str(), -1, SQLITE_TRANSIENT);
-    } else {
-        sqlite3_bind_text(stmt, 1, specialization.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 2, doctorID);
-    }
+// Doctors joined to their Users row: doctor columns first, then the user's
+static constexpr auto doctorSelectSql = table::concat(
+    table::FixedString("SELECT "), DoctorsTable::columns<"d.">, table::FixedString(", "),
+    UsersTable::valueColumns<"u.">, table::FixedString(" FROM Doctors d JOIN Users u ON d.userID = u.userID"));
 
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    sqlite3_finalize(stmt);
-    return success;
+static Doctor* decodeDoctor(sqlite3_stmt* stmt) {
+    auto [doctorID, userID, specialization] = DoctorsTable::decode(stmt);
+    auto [name, contact, type] = UsersTable::decodeValues(stmt, DoctorsTable::columnCount);
+    return new Doctor(userID, name, contact, doctorID, specialization);
 }
 
 Doctor* Doctor::getDoctorFromDatabase(int doctorID) {
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
+    static constexpr auto sql = table::concat(doctorSelectSql, table::FixedString(" WHERE d.doctorID = ?;"));
 
-    std::string sql = "SELECT d.userID, d.specialization, u.name, u.contact "
-                     "FROM Doctors d JOIN Users u ON d.userID = u.userID "
-                     "WHERE d.doctorID = ?;";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return nullptr;
-    }
-
-    sqlite3_bind_int(stmt, 1, doctorID);
-
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        int userID = sqlite3_column_int(stmt, 0);
-        std::string specialization = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string contact = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-
-        sqlite3_finalize(stmt);
-        return new Doctor(userID, name, contact, doctorID, specialization);
+    try {
+        table::Statement stmt(db, sql.c_str());
+        stmt.bind(1, doctorID);
+        if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            return decodeDoctor(stmt.get());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
     }
-
-    sqlite3_finalize(stmt);
     return nullptr;
 }
 
 void Doctor::prescribeMedicine(int patientID, const std::string& medicine, const std::string& dosage) {
-    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-
-    std::string sql = "INSERT INTO Prescriptions (doctorID, patientID, medicine, dosage, date) "
-                     "VALUES (?, ?, ?, ?, date('now'));";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        throw std::runtime_error("Failed to prescribe medicine");
-    }
+    // dated like SQLite's date('now'), in UTC
+    std::time_t now = std::time(nullptr);
+    char today[16];
+    std::strftime(today, sizeof(today), "%Y-%m-%d", std::gmtime(&now));
 
-    sqlite3_bind_int(stmt, 1, doctorID);
-    sqlite3_bind_int(stmt, 2, patientID);
-    sqlite3_bind_text(stmt, 3, medicine.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 4, dosage.c_str(), -1, SQLITE_TRANSIENT);
-
-    if (sqlite3_step(stmt) != SQLITE_DONE) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Failed to execute prescription");
-    }
-
-    sqlite3_finalize(stmt);
+    PrescriptionsTable::insert(DatabaseHandler::getInstance().getDatabase(), doctorID, patientID, medicine, dosage,
+                               std::string(today));
 }
 
 void Doctor::updatePatientRecords(int patientID, const std::string& diagnosis, const std::string& treatment) {
-    MedicalRecord* record = new MedicalRecord(0, 
-                                           Patient::getPatientFromDatabase(patientID),
-                                           this,
-                                           diagnosis,
-                                           treatment);
+    MedicalRecord* record = new MedicalRecord(0, patientID, doctorID, diagnosis, treatment);
     if (!record->saveToDatabase()) {
         delete record;
         throw std::runtime_error("Failed to update patient records");
@@ -112,63 +88,22 @@ void Doctor::updatePatientRecords(int patientID, const std::string& diagnosis, c
 }
 
 std::vector<Appointment*> Doctor::viewAppointments() {
-    std::vector<Appointment*> appointments;
-    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-
-    std::string sql = "SELECT appointmentID, patientID, date, time, status "
-                     "FROM Appointments WHERE doctorID = ? ORDER BY date, time;";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return appointments;
-    }
-
-    sqlite3_bind_int(stmt, 1, doctorID);
-
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int appointmentID = sqlite3_column_int(stmt, 0);
-        int patientID = sqlite3_column_int(stmt, 1);
-        std::string date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string time = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        std::string status = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-
-        Patient* patient = Patient::getPatientFromDatabase(patientID);
-        if (patient) {
-            appointments.push_back(new Appointment(appointmentID, patient, this, date, time));
-        }
-    }
-
-    sqlite3_finalize(stmt);
-    return appointments;
+    return Appointment::getAppointmentsForDoctor(doctorID);
 }
 
 std::vector<Doctor*> Doctor::getAllDoctorsFromDatabase() {
     std::vector<Doctor*> doctors;
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
+    static constexpr auto sql = table::concat(doctorSelectSql, table::FixedString(" WHERE u.type = 'doctor';"));
 
-    // Query to get all doctors with their user information
-    std::string sql = "SELECT d.doctorID, d.userID, d.specialization, u.name, u.contact "
-                     "FROM Doctors d JOIN Users u ON d.userID = u.userID "
-                     "WHERE u.type = 'doctor';";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return doctors;
-    }
-
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int doctorID = sqlite3_column_int(stmt, 0);
-        int userID = sqlite3_column_int(stmt, 1);
-        std::string specialization = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        std::string contact = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-
-        doctors.push_back(new Doctor(userID, name, contact, doctorID, specialization));
+    try {
+        table::Statement stmt(db, sql.c_str());
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            doctors.push_back(decodeDoctor(stmt.get()));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
     }
-
-    sqlite3_finalize(stmt);
     return doctors;
 }
 
@@ -0,0 +1,77 @@
+#include "drug_interactions.h"
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+DrugInteractions* DrugInteractions::instance = nullptr;
+
+DrugInteractions& DrugInteractions::getInstance() {
+    if (!instance) {
+        instance = new DrugInteractions();
+    }
+    return *instance;
+}
+
+std::string DrugInteractions::normalize(const std::string& medicine) {
+    size_t begin = 0;
+    size_t end = medicine.size();
+    while (begin < end && std::isspace(static_cast<unsigned char>(medicine[begin]))) begin++;
+    while (end > begin && std::isspace(static_cast<unsigned char>(medicine[end - 1]))) end--;
+
+    std::string result;
+    result.reserve(end - begin);
+    for (size_t i = begin; i < end; i++) {
+        result += static_cast<char>(std::tolower(static_cast<unsigned char>(medicine[i])));
+    }
+    return result;
+}
+
+std::string DrugInteractions::pairKey(const std::string& a, const std::string& b) {
+    return a < b ? a + '\n' + b : b + '\n' + a;
+}
+
+size_t DrugInteractions::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Drug interaction table " << path << " not found, checks disabled" << std::endl;
+        return 0;
+    }
+
+    std::unordered_map<std::string, DrugInteraction> loaded;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream fields(line);
+        std::string first, second, severity, description;
+        if (!std::getline(fields, first, ',') || !std::getline(fields, second, ',') ||
+            !std::getline(fields, severity, ',')) {
+            continue;
+        }
+        std::getline(fields, description);
+        loaded[pairKey(normalize(first), normalize(second))] = DrugInteraction{"", normalize(severity), description};
+    }
+
+    pairs.swap(loaded);
+    return pairs.size();
+}
+
+std::vector<DrugInteraction> DrugInteractions::check(const std::string& medicine,
+                                                     const std::vector<std::string>& activeMedicines) const {
+    std::vector<DrugInteraction> found;
+    if (pairs.empty()) {
+        return found;
+    }
+
+    std::string prescribed = normalize(medicine);
+    for (const auto& active : activeMedicines) {
+        auto it = pairs.find(pairKey(prescribed, normalize(active)));
+        if (it != pairs.end()) {
+            DrugInteraction interaction = it->second;
+            interaction.medicine = active;
+            found.push_back(interaction);
+        }
+    }
+    return found;
+}
@@ -0,0 +1,110 @@
+#include "encoding_benchmark.h"
+#include "crow.h"
+#include "binary_encoding.h"
+#include "response_body.h"
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+
+namespace {
+
+struct Row {
+    int id;
+    int patientID;
+    std::string patientName;
+    int doctorID;
+    std::string doctorName;
+    std::string date;
+    std::string time;
+};
+
+std::vector<Row> makeRows(int count) {
+    std::vector<Row> rows;
+    rows.reserve(count);
+    for (int i = 0; i < count; i++) {
+        rows.push_back({i + 1, 1000 + i % 2000, "Patient \"" + std::to_string(i % 2000) + "\"", 1 + i % 50,
+                        "Dr. Doctor " + std::to_string(i % 50), "2025-0" + std::to_string(1 + i % 9) + "-1" +
+                        std::to_string(i % 10), std::to_string(9 + i % 8) + ":30"});
+    }
+    return rows;
+}
+
+// The same fill code the routes use, for either document type.
+template <typename Document>
+void fill(Document& result, const std::vector<Row>& rows) {
+    for (size_t i = 0; i < rows.size(); i++) {
+        result[i]["id"] = rows[i].id;
+        result[i]["patient_id"] = rows[i].patientID;
+        result[i]["patient_name"] = rows[i].patientName;
+        result[i]["doctor_id"] = rows[i].doctorID;
+        result[i]["doctor_name"] = rows[i].doctorName;
+        result[i]["date"] = rows[i].date;
+        result[i]["time"] = rows[i].time;
+    }
+}
+
+template <typename Encode>
+EncodingPathResult timed(const std::string& path, int iterations, Encode encode) {
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        bytes = encode().size();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return {path, bytes, elapsed.count()};
+}
+
+} // namespace
+
+std::vector<EncodingPathResult> EncodingBenchmark::run(const EncodingWorkload& workload) {
+    std::vector<Row> rows = makeRows(workload.rows);
+    std::vector<EncodingPathResult> results;
+
+    results.push_back(timed("wvalue -> json", workload.iterations, [&] {
+        crow::json::wvalue result;
+        fill(result, rows);
+        return result.dump();
+    }));
+    for (BinaryFormat format : {BinaryFormat::MsgPack, BinaryFormat::Cbor}) {
+        std::string name = format == BinaryFormat::MsgPack ? "msgpack" : "cbor";
+        results.push_back(timed("wvalue -> json -> " + name, workload.iterations, [&] {
+            crow::json::wvalue result;
+            fill(result, rows);
+            std::string encoded;
+            if (!BinaryEncoding::fromJson(result.dump(), format, encoded)) {
+                throw std::runtime_error("transcoding failed");
+            }
+            return encoded;
+        }));
+    }
+
+    results.push_back(timed("ResponseBody -> json", workload.iterations, [&] {
+        ResponseBody result = ResponseBody::list();
+        fill(result, rows);
+        return result.dump();
+    }));
+    for (BinaryFormat format : {BinaryFormat::MsgPack, BinaryFormat::Cbor}) {
+        std::string name = format == BinaryFormat::MsgPack ? "msgpack" : "cbor";
+        results.push_back(timed("ResponseBody -> " + name, workload.iterations, [&] {
+            ResponseBody result = ResponseBody::list();
+            fill(result, rows);
+            std::string encoded;
+            result.encode(format, encoded);
+            return encoded;
+        }));
+    }
+    return results;
+}
+
+void EncodingBenchmark::print(std::ostream& out, const EncodingWorkload& workload,
+                              const std::vector<EncodingPathResult>& results) {
+    out << workload.rows << " rows, " << workload.iterations << " iterations\n";
+    out << std::left << std::setw(30) << "path" << std::right << std::setw(12) << "bodies/s" << std::setw(10)
+        << "MB/s" << std::setw(12) << "bytes" << '\n';
+    for (const auto& result : results) {
+        double rate = result.seconds > 0 ? workload.iterations / result.seconds : 0;
+        double megabytes = rate * result.bytes / (1024.0 * 1024.0);
+        out << std::left << std::setw(30) << result.path << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << rate << std::setw(10) << megabytes << std::setw(12) << result.bytes << '\n';
+    }
+}
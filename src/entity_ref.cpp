@@ -0,0 +1,83 @@
+#include "entity_ref.h"
+#include "patient.h"
+#include "doctor.h"
+
+template <typename T>
+EntityCache<T>* EntityCache<T>::instance = nullptr;
+
+template <typename T>
+EntityCache<T>& EntityCache<T>::getInstance() {
+    if (!instance) {
+        instance = new EntityCache<T>();
+    }
+    return *instance;
+}
+
+template <>
+Patient* EntityCache<Patient>::load(int id) {
+    return Patient::getPatientFromDatabase(id);
+}
+
+template <>
+Doctor* EntityCache<Doctor>::load(int id) {
+    return Doctor::getDoctorFromDatabase(id);
+}
+
+template <typename T>
+std::shared_ptr<const T> EntityCache<T>::get(int id) {
+    uint64_t seen;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(id);
+        if (it != entries.end()) {
+            hits++;
+            return it->second;
+        }
+        seen = generation;
+    }
+
+    // Load outside the lock; two threads missing on the same ID both load
+    // and the second insert is a no-op. A load that raced an invalidation
+    // is returned to its caller but not cached.
+    std::shared_ptr<const T> loaded(load(id));
+    if (!loaded) return nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    loads++;
+    if (generation != seen) {
+        return loaded;
+    }
+    if (entries.size() >= kMaxEntries) {
+        entries.clear();
+    }
+    return entries.emplace(id, loaded).first->second;
+}
+
+template <typename T>
+void EntityCache<T>::invalidate(int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.erase(id);
+    generation++;
+}
+
+template <typename T>
+void EntityCache<T>::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    generation++;
+}
+
+template <typename T>
+uint64_t EntityCache<T>::hitCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+template <typename T>
+uint64_t EntityCache<T>::loadCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return loads;
+}
+
+template class EntityCache<Patient>;
+template class EntityCache<Doctor>;
@@ -0,0 +1,189 @@
+#include "idempotency_store.h"
+#include "database_handler.h"
+#include <sqlite3.h>
+#include <functional>
+#include <iostream>
+
+IdempotencyStore* IdempotencyStore::instance = nullptr;
+
+IdempotencyStore& IdempotencyStore::getInstance() {
+    if (!instance) {
+        instance = new IdempotencyStore();
+    }
+    return *instance;
+}
+
+uint64_t IdempotencyStore::fingerprint(const std::string& method, const std::string& url, const std::string& body) {
+    // FNV-1a: stable across runs, unlike std::hash, so persisted rows still match
+    uint64_t hash = 1469598103934665603ULL;
+    for (const std::string* part : {&method, &url, &body}) {
+        for (unsigned char c : *part) {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        hash = (hash ^ 0xff) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+IdempotencyStore::Shard& IdempotencyStore::shardFor(const std::string& key) {
+    return shards[std::hash<std::string>{}(key) % kShards];
+}
+
+void IdempotencyStore::evict(Shard& shard, std::time_t now) {
+    // a key queued for a later run may have been abandoned and re-added since
+    auto current = [&shard](const std::pair<std::time_t, std::string>& queued) {
+        auto it = shard.entries.find(queued.second);
+        return it != shard.entries.end() && it->second.createdAt == queued.first ? it : shard.entries.end();
+    };
+
+    while (!shard.order.empty() && shard.order.front().first + kTtlSeconds <= now) {
+        auto it = current(shard.order.front());
+        if (it != shard.entries.end()) shard.entries.erase(it);
+        shard.order.pop_front();
+    }
+
+    // Over the cap, drop completed keys oldest first. A key still in flight
+    // stays: complete() would find nothing to record and a retry would run
+    // the request again.
+    for (auto queued = shard.order.begin();
+         queued != shard.order.end() && shard.entries.size() > kMaxEntriesPerShard;) {
+        auto it = current(*queued);
+        if (it != shard.entries.end() && !it->second.completed) {
+            ++queued;
+            continue;
+        }
+        if (it != shard.entries.end()) shard.entries.erase(it);
+        queued = shard.order.erase(queued);
+    }
+}
+
+IdempotencyStore::Outcome IdempotencyStore::begin(const std::string& key, uint64_t fingerprint,
+                                                  StoredResponse& replay) {
+    std::time_t now = std::time(nullptr);
+    Shard& shard = shardFor(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    evict(shard, now);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
+        if (it->second.fingerprint != fingerprint) return Outcome::Mismatch;
+        if (!it->second.completed) return Outcome::InProgress;
+        replay = it->second.response;
+        return Outcome::Replay;
+    }
+
+    shard.entries.emplace(key, Entry{fingerprint, false, {}, now});
+    shard.order.emplace_back(now, key);
+    return Outcome::Proceed;
+}
+
+void IdempotencyStore::complete(const std::string& key, const StoredResponse& response) {
+    Entry entry;
+    {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) return;
+        it->second.completed = true;
+        it->second.response = response;
+        entry = it->second;
+    }
+
+    persist(key, entry);
+    sweepPersisted(entry.createdAt);
+}
+
+void IdempotencyStore::abandon(const std::string& key) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end() && !it->second.completed) {
+        shard.entries.erase(it);
+    }
+}
+
+void IdempotencyStore::load() {
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+    std::time_t now = std::time(nullptr);
+
+    // oldest first, so each shard's order stays in creation order and the
+    // cap keeps the newest keys
+    std::string sql = "SELECT idempotency_key, fingerprint, status_code, content_type, body, created_at "
+                      "FROM IdempotencyKeys WHERE created_at > ? ORDER BY created_at;";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare idempotency load: " << sqlite3_errmsg(db) << std::endl;
+        return;
+    }
+
+    sqlite3_bind_int64(stmt, 1, now - kTtlSeconds);
+
+    size_t loaded = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        std::string key = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        Entry entry;
+        entry.fingerprint = static_cast<uint64_t>(sqlite3_column_int64(stmt, 1));
+        entry.completed = true;
+        entry.response.code = sqlite3_column_int(stmt, 2);
+        entry.response.contentType = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        const unsigned char* body = sqlite3_column_text(stmt, 4);
+        if (body) {
+            entry.response.body.assign(reinterpret_cast<const char*>(body), sqlite3_column_bytes(stmt, 4));
+        }
+        entry.createdAt = static_cast<std::time_t>(sqlite3_column_int64(stmt, 5));
+
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries[key] = entry;
+        shard.order.emplace_back(entry.createdAt, key);
+        evict(shard, now);
+        loaded++;
+    }
+
+    sqlite3_finalize(stmt);
+    std::cout << "Loaded " << loaded << " idempotency keys" << std::endl;
+}
+
+void IdempotencyStore::persist(const std::string& key, const Entry& entry) {
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+
+    std::string sql = "INSERT OR REPLACE INTO IdempotencyKeys "
+                      "(idempotency_key, fingerprint, status_code, content_type, body, created_at) "
+                      "VALUES (?, ?, ?, ?, ?, ?);";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "Failed to prepare idempotency insert: " << sqlite3_errmsg(db) << std::endl;
+        return;
+    }
+
+    sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(entry.fingerprint));
+    sqlite3_bind_int(stmt, 3, entry.response.code);
+    sqlite3_bind_text(stmt, 4, entry.response.contentType.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 5, entry.response.body.data(), static_cast<int>(entry.response.body.size()),
+                      SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 6, entry.createdAt);
+
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "Failed to persist idempotency key: " << sqlite3_errmsg(db) << std::endl;
+    }
+
+    sqlite3_finalize(stmt);
+}
+
+void IdempotencyStore::sweepPersisted(std::time_t now) {
+    {
+        std::lock_guard<std::mutex> lock(sweepMutex);
+        if (now - lastSweep < 60 * 60) return;
+        lastSweep = now;
+    }
+
+    try {
+        DatabaseHandler::getInstance().execute("DELETE FROM IdempotencyKeys WHERE created_at < " +
+                                               std::to_string(now - kTtlSeconds) + ";");
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to expire idempotency keys: " << e.what() << std::endl;
+    }
+}
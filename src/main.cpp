@@ -2,24 +2,192 @@
 #include "database_handler.h"
 #include "api_server.h"
 #include "db_seed.h"
+#include "analytics.h"
+#include "people_index.h"
+#include "idempotency_store.h"
+#include "drug_interactions.h"
+#include "change_feed.h"
+#include "db_executor.h"
+#include "admission_control.h"
+#include "response_compression.h"
+#include "static_files.h"
+#include "backup_manager.h"
+#include "archive_manager.h"
+#include "query_budget.h"
+#include "storage_benchmark.h"
+#include "encoding_benchmark.h"
+#include "parser_benchmark.h"
+#include "memory_storage_engine.h"
+#include "sqlite_storage_engine.h"
 #include <cstdlib> 
+#include <algorithm>
+#include <thread>
 
-int main() {
+// Thread counts come from the environment so HTTP and database concurrency
+// can be sized separately for the host.
+static unsigned threadCountFromEnv(const char* name, unsigned fallback) {
+    const char* value = std::getenv(name);
+    if (!value) return fallback;
+    int parsed = std::atoi(value);
+    return parsed > 0 ? static_cast<unsigned>(parsed) : fallback;
+}
+
+// Compression levels trade CPU for bytes on the wire; tune per deployment.
+static int settingFromEnv(const char* name, int fallback) {
+    const char* value = std::getenv(name);
+    if (!value) return fallback;
+    int parsed = std::atoi(value);
+    return parsed >= 0 ? parsed : fallback;
+}
+
+// `hospx --storage-benchmark [scratch.db]` runs one workload against the
+// in-memory and SQLite storage engines, prints both and exits. The scratch
+// file gets the full schema, triggers included, and is removed afterwards.
+static int runStorageBenchmark(const std::string& path) {
+    std::remove(path.c_str());
+    DatabaseHandler& dbHandler = DatabaseHandler::getInstance(path);
+    initializeDatabaseSchema(dbHandler);
+
+    StorageWorkload workload;
+    MemoryStorageEngine memory;
+    SqliteStorageEngine sqlite(dbHandler.getDatabase());
+
+    std::vector<StorageBenchmarkResult> results;
+    results.push_back(StorageBenchmark::run(memory, workload));
+    results.push_back(StorageBenchmark::run(sqlite, workload));
+    StorageBenchmark::print(std::cout, results);
+
+    std::remove(path.c_str());
+    return 0;
+}
+
+// `hospx --encoding-benchmark [rows]` times building and serializing a list
+// body through crow::json::wvalue (plus transcoding for binary clients) and
+// through ResponseBody, prints the table and exits.
+static int runEncodingBenchmark(int rows) {
+    EncodingWorkload workload;
+    if (rows > 0) workload.rows = rows;
+    EncodingBenchmark::print(std::cout, workload, EncodingBenchmark::run(workload));
+    return 0;
+}
+
+// `hospx --parser-benchmark [iterations]` decodes the write-endpoint bodies
+// with crow::json::load and with parseRequest, prints both rates and exits.
+static int runParserBenchmark(int iterations) {
+    ParserWorkload workload;
+    if (iterations > 0) workload.iterations = iterations;
+    ParserBenchmark::print(std::cout, workload, ParserBenchmark::run(workload));
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     try {
-        std::remove("hospital.db");
-        
+        if (argc > 1 && std::string(argv[1]) == "--storage-benchmark") {
+            return runStorageBenchmark(argc > 2 ? argv[2] : "storage_benchmark.db");
+        }
+        if (argc > 1 && std::string(argv[1]) == "--encoding-benchmark") {
+            return runEncodingBenchmark(argc > 2 ? std::atoi(argv[2]) : 0);
+        }
+        if (argc > 1 && std::string(argv[1]) == "--parser-benchmark") {
+            return runParserBenchmark(argc > 2 ? std::atoi(argv[2]) : 0);
+        }
+
+        // The database survives restarts; HOSPX_RESET_DB=1 starts over from
+        // the seed data
+        if (settingFromEnv("HOSPX_RESET_DB", 0) > 0) {
+            std::remove("hospital.db");
+        }
+
         // Initialize database
         DatabaseHandler& dbHandler = DatabaseHandler::getInstance("hospital.db");
-        
-        // Create schema and seed data in correct order
+
+        // Create schema and seed data in correct order; a database without
+        // users, new or with only the schema, gets the seed data
         initializeDatabaseSchema(dbHandler);
-        seedDatabase(dbHandler);
+        if (dbHandler.tableIsEmpty("Users")) {
+            seedDatabase(dbHandler);
+        }
+
+        // WAL checkpoints, PRAGMA optimize and incremental vacuum run off the request path
+        MaintenanceSettings maintenance;
+        maintenance.idleSeconds = settingFromEnv("HOSPX_MAINTENANCE_IDLE_SECONDS", maintenance.idleSeconds);
+        maintenance.passiveCheckpointBytes = settingFromEnv("HOSPX_WAL_CHECKPOINT_BYTES",
+                                                            static_cast<int>(maintenance.passiveCheckpointBytes));
+        maintenance.truncateCheckpointBytes = settingFromEnv("HOSPX_WAL_TRUNCATE_BYTES",
+                                                             static_cast<int>(maintenance.truncateCheckpointBytes));
+        dbHandler.startMaintenance(maintenance);
+
+        DrugInteractions::getInstance().load("config/drug_interactions.csv");
+
+        // Typeahead search is served from memory
+        PeopleIndex::getInstance().rebuild();
+
+        // Idempotency keys recorded before a restart are answered from memory
+        IdempotencyStore::getInstance().load();
+
+        // Admin reporting reads a columnar snapshot refreshed in the background
+        AnalyticsEngine::getInstance().start();
+
+        // Completes pending GET /events requests as changes are published
+        ChangeFeed::getInstance().start();
+
+        unsigned httpThreads = threadCountFromEnv("HOSPX_HTTP_THREADS", std::max(2u, std::thread::hardware_concurrency()));
+        unsigned dbThreads = threadCountFromEnv("HOSPX_DB_THREADS", 4);
+
+        // Route handlers run their queries here instead of on the HTTP threads
+        DbExecutor::getInstance().start(dbThreads);
+
+        // Turns away requests that waited too long for an admission slot
+        AdmissionController::getInstance().start();
+
+        // Statements running past their route class's budget are interrupted
+        QueryBudget& budgets = QueryBudget::getInstance();
+        budgets.setBudget(RouteClass::Read, settingFromEnv("HOSPX_READ_BUDGET_MS", budgets.getBudget(RouteClass::Read)));
+        budgets.setBudget(RouteClass::Write, settingFromEnv("HOSPX_WRITE_BUDGET_MS", budgets.getBudget(RouteClass::Write)));
+        budgets.setBudget(RouteClass::Bulk, settingFromEnv("HOSPX_BULK_BUDGET_MS", budgets.getBudget(RouteClass::Bulk)));
+        budgets.setExportBudget(settingFromEnv("HOSPX_EXPORT_BUDGET_MS", budgets.getExportBudget()));
+
+        // Online backups on request (POST /admin/backup) and optionally on a schedule
+        BackupSettings backup;
+        const char* backupDir = std::getenv("HOSPX_BACKUP_DIR");
+        if (backupDir) backup.directory = backupDir;
+        backup.intervalMinutes = settingFromEnv("HOSPX_BACKUP_INTERVAL_MINUTES", backup.intervalMinutes);
+        backup.pagesPerStep = settingFromEnv("HOSPX_BACKUP_PAGES_PER_STEP", backup.pagesPerStep);
+        backup.stepPauseMillis = settingFromEnv("HOSPX_BACKUP_STEP_PAUSE_MS", backup.stepPauseMillis);
+        backup.keep = settingFromEnv("HOSPX_BACKUP_KEEP", backup.keep);
+        BackupManager::getInstance().start(backup);
+
+        // Appointments and records older than the horizon move to per-year
+        // archive files; existing archives stay readable with the job off
+        ArchiveSettings archive;
+        const char* archiveDir = std::getenv("HOSPX_ARCHIVE_DIR");
+        if (archiveDir) archive.directory = archiveDir;
+        archive.horizonDays = settingFromEnv("HOSPX_ARCHIVE_HORIZON_DAYS", archive.horizonDays);
+        archive.intervalMinutes = settingFromEnv("HOSPX_ARCHIVE_INTERVAL_MINUTES", archive.intervalMinutes);
+        archive.batchRows = settingFromEnv("HOSPX_ARCHIVE_BATCH_ROWS", archive.batchRows);
+        ArchiveManager::getInstance().start(archive);
         
+        CompressionSettings compression;
+        compression.minBytes = settingFromEnv("HOSPX_COMPRESSION_MIN_BYTES", static_cast<int>(compression.minBytes));
+        compression.gzipLevel = std::clamp(settingFromEnv("HOSPX_GZIP_LEVEL", compression.gzipLevel), 1, 9);
+        compression.brotliQuality = std::clamp(settingFromEnv("HOSPX_BROTLI_QUALITY", compression.brotliQuality), 0, 11);
+        compression.threads = settingFromEnv("HOSPX_COMPRESSION_THREADS", static_cast<int>(compression.threads));
+        ResponseCompressor::getInstance().configure(compression);
+        // Large responses are compressed here rather than on the DB threads
+        ResponseCompressor::getInstance().start();
+
+        // The built client (npm run build) is served from the same origin
+        const char* clientDir = std::getenv("HOSPX_CLIENT_DIR");
+        const char* clientCacheDir = std::getenv("HOSPX_CLIENT_CACHE_DIR");
+        StaticFiles::getInstance().load(clientDir ? clientDir : "client/dist",
+                                        clientCacheDir ? clientCacheDir : "cache/client");
+
         // Create API server
         ApiServer server;
         
-        std::cout << "Starting hospital management system API server on port 8080..." << std::endl;
-        server.run(8080);
+        std::cout << "Starting hospital management system API server on port 8080 ("
+                  << httpThreads << " HTTP threads, " << dbThreads << " database threads)..." << std::endl;
+        server.run(8080, httpThreads);
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,349 @@
+#include "memory_storage_engine.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <climits>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t kStripes = 16;
+
+template <typename V, typename Row, size_t... I>
+const V* columnPointer(const Row& row, int column, std::index_sequence<I...>) {
+    const V* value = nullptr;
+    auto visit = [&]<size_t J>() {
+        if constexpr (std::is_same_v<std::tuple_element_t<J, Row>, V>) {
+            if (static_cast<int>(J) == column) value = &std::get<J>(row);
+        }
+    };
+    (visit.template operator()<I>(), ...);
+    return value;
+}
+
+// The column must have type V (see Table::columnHasType).
+template <typename V, typename Row>
+const V& columnOf(const Row& row, int column) {
+    return *columnPointer<V>(row, column, std::make_index_sequence<std::tuple_size_v<Row>>());
+}
+
+template <typename TableT>
+class MemoryRepository : public Repository<TableT> {
+public:
+    using Row = typename TableT::Row;
+
+private:
+    struct Stripe {
+        std::shared_mutex mutex;
+        std::unordered_map<int, Row> rows;
+    };
+
+    // integer column value -> keys of the rows holding it
+    struct HashIndex {
+        int column;
+        std::shared_mutex mutex;
+        std::unordered_map<int, std::set<int>> keys;
+    };
+
+    // text column, ordered by (value, key)
+    struct OrderedIndex {
+        int column;
+        std::shared_mutex mutex;
+        std::set<std::pair<std::string, int>> entries;
+    };
+
+    std::array<Stripe, kStripes> stripes;
+    std::vector<std::unique_ptr<HashIndex>> hashIndexes;
+    std::vector<std::unique_ptr<OrderedIndex>> orderedIndexes;
+    std::atomic<int> nextKey{1};
+
+    Stripe& stripeFor(int key) { return stripes[static_cast<unsigned>(key) % kStripes]; }
+
+    HashIndex* hashIndexOn(int column) {
+        for (auto& index : hashIndexes) {
+            if (index->column == column) return index.get();
+        }
+        return nullptr;
+    }
+
+    OrderedIndex* orderedIndexOn(int column) {
+        for (auto& index : orderedIndexes) {
+            if (index->column == column) return index.get();
+        }
+        return nullptr;
+    }
+
+    // Index maintenance runs under the row's stripe lock, so the changes to
+    // one key reach every index in order. Readers never hold an index lock
+    // and a stripe lock at the same time. Indexes whose column is unchanged
+    // are not touched, and a changed entry is moved under a single index
+    // lock, so concurrent lookups never miss a row that is being updated.
+    void reindex(const Row* before, const Row* after) {
+        int key = std::get<0>(before ? *before : *after);
+        for (auto& index : hashIndexes) {
+            const int* from = before ? &columnOf<int>(*before, index->column) : nullptr;
+            const int* to = after ? &columnOf<int>(*after, index->column) : nullptr;
+            if (from && to && *from == *to) continue;
+
+            std::unique_lock<std::shared_mutex> lock(index->mutex);
+            if (from) {
+                auto it = index->keys.find(*from);
+                if (it != index->keys.end()) {
+                    it->second.erase(key);
+                    if (it->second.empty()) index->keys.erase(it);
+                }
+            }
+            if (to) index->keys[*to].insert(key);
+        }
+        for (auto& index : orderedIndexes) {
+            const std::string* from = before ? &columnOf<std::string>(*before, index->column) : nullptr;
+            const std::string* to = after ? &columnOf<std::string>(*after, index->column) : nullptr;
+            if (from && to && *from == *to) continue;
+
+            std::unique_lock<std::shared_mutex> lock(index->mutex);
+            if (from) index->entries.erase({*from, key});
+            if (to) index->entries.emplace(*to, key);
+        }
+    }
+
+    // Rows for keys read from an index, in the given order, dropping any
+    // that were removed or no longer match since the index was read.
+    template <typename Matches>
+    std::vector<Row> fetch(const std::vector<int>& keys, Matches matches) {
+        std::vector<Row> rows;
+        rows.reserve(keys.size());
+        for (int key : keys) {
+            Stripe& stripe = stripeFor(key);
+            std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+            auto it = stripe.rows.find(key);
+            if (it != stripe.rows.end() && matches(it->second)) {
+                rows.push_back(it->second);
+            }
+        }
+        return rows;
+    }
+
+    // Unordered; callers sort.
+    template <typename Matches>
+    std::vector<Row> scan(Matches matches) {
+        std::vector<Row> rows;
+        for (auto& stripe : stripes) {
+            std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+            for (const auto& [key, row] : stripe.rows) {
+                if (matches(row)) rows.push_back(row);
+            }
+        }
+        return rows;
+    }
+
+    static void sortByKey(std::vector<Row>& rows) {
+        std::sort(rows.begin(), rows.end(),
+                  [](const Row& a, const Row& b) { return std::get<0>(a) < std::get<0>(b); });
+    }
+
+    void reserveKey(int key) {
+        int next = nextKey.load();
+        while (next <= key && !nextKey.compare_exchange_weak(next, key + 1)) {
+        }
+    }
+
+protected:
+    int insertRow(const Row& input) override {
+        Row row = input;
+        int key = std::get<0>(row);
+        if (key == 0) {
+            key = nextKey.fetch_add(1);
+            std::get<0>(row) = key;
+        } else {
+            reserveKey(key);
+        }
+
+        Stripe& stripe = stripeFor(key);
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        auto [it, inserted] = stripe.rows.emplace(key, std::move(row));
+        if (!inserted) {
+            throw std::runtime_error("Duplicate key " + std::to_string(key) + " in " +
+                                     std::string(TableT::name.view()));
+        }
+        reindex(nullptr, &it->second);
+        return key;
+    }
+
+public:
+    MemoryRepository(const std::vector<int>& hashed, const std::vector<int>& ordered) {
+        for (int column : hashed) {
+            if (!TableT::template columnHasType<int>(column)) {
+                throw std::invalid_argument("Hash indexes need an integer column");
+            }
+            hashIndexes.push_back(std::make_unique<HashIndex>());
+            hashIndexes.back()->column = column;
+        }
+        for (int column : ordered) {
+            if (!TableT::template columnHasType<std::string>(column)) {
+                throw std::invalid_argument("Ordered indexes need a text column");
+            }
+            orderedIndexes.push_back(std::make_unique<OrderedIndex>());
+            orderedIndexes.back()->column = column;
+        }
+    }
+
+    bool update(const Row& row) override {
+        int key = std::get<0>(row);
+        Stripe& stripe = stripeFor(key);
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.rows.find(key);
+        if (it == stripe.rows.end()) return false;
+
+        Row before = std::move(it->second);
+        it->second = row;
+        reindex(&before, &it->second);
+        return true;
+    }
+
+    bool remove(int key) override {
+        Stripe& stripe = stripeFor(key);
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.rows.find(key);
+        if (it == stripe.rows.end()) return false;
+
+        reindex(&it->second, nullptr);
+        stripe.rows.erase(it);
+        return true;
+    }
+
+    std::optional<Row> find(int key) override {
+        Stripe& stripe = stripeFor(key);
+        std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.rows.find(key);
+        if (it == stripe.rows.end()) return std::nullopt;
+        return it->second;
+    }
+
+    std::vector<Row> all() override {
+        std::vector<Row> rows = scan([](const Row&) { return true; });
+        sortByKey(rows);
+        return rows;
+    }
+
+    size_t count() override {
+        size_t total = 0;
+        for (auto& stripe : stripes) {
+            std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+            total += stripe.rows.size();
+        }
+        return total;
+    }
+
+    std::vector<Row> findEqual(int column, int value) override {
+        if (!TableT::template columnHasType<int>(column)) {
+            throw std::invalid_argument("Column type mismatch in " + std::string(TableT::name.view()));
+        }
+        if (column == 0) {
+            std::optional<Row> row = find(value);
+            return row ? std::vector<Row>{*row} : std::vector<Row>{};
+        }
+
+        auto matches = [&](const Row& row) { return columnOf<int>(row, column) == value; };
+        if (HashIndex* index = hashIndexOn(column)) {
+            std::vector<int> keys;
+            {
+                std::shared_lock<std::shared_mutex> lock(index->mutex);
+                auto it = index->keys.find(value);
+                if (it != index->keys.end()) keys.assign(it->second.begin(), it->second.end());
+            }
+            return fetch(keys, matches);
+        }
+
+        std::vector<Row> rows = scan(matches);
+        sortByKey(rows);
+        return rows;
+    }
+
+    std::vector<Row> findEqual(int column, const std::string& value) override {
+        if (!TableT::template columnHasType<std::string>(column)) {
+            throw std::invalid_argument("Column type mismatch in " + std::string(TableT::name.view()));
+        }
+        if (orderedIndexOn(column)) {
+            return findRange(column, value, value);
+        }
+
+        std::vector<Row> rows = scan([&](const Row& row) { return columnOf<std::string>(row, column) == value; });
+        sortByKey(rows);
+        return rows;
+    }
+
+    std::vector<Row> findRange(int column, const std::string& low, const std::string& high) override {
+        if (!TableT::template columnHasType<std::string>(column)) {
+            throw std::invalid_argument("Column type mismatch in " + std::string(TableT::name.view()));
+        }
+
+        auto matches = [&](const Row& row) {
+            const std::string& value = columnOf<std::string>(row, column);
+            return value >= low && value <= high;
+        };
+        if (OrderedIndex* index = orderedIndexOn(column)) {
+            std::vector<int> keys;
+            {
+                std::shared_lock<std::shared_mutex> lock(index->mutex);
+                for (auto it = index->entries.lower_bound({low, INT_MIN});
+                     it != index->entries.end() && it->first <= high; ++it) {
+                    keys.push_back(it->second);
+                }
+            }
+            return fetch(keys, matches);
+        }
+
+        std::vector<Row> rows = scan(matches);
+        std::sort(rows.begin(), rows.end(), [&](const Row& a, const Row& b) {
+            const std::string& left = columnOf<std::string>(a, column);
+            const std::string& right = columnOf<std::string>(b, column);
+            return left != right ? left < right : std::get<0>(a) < std::get<0>(b);
+        });
+        return rows;
+    }
+};
+
+template <typename TableT>
+std::unique_ptr<Repository<TableT>> memoryRepository(const std::vector<int>& hashed,
+                                                     const std::vector<int>& ordered) {
+    return std::make_unique<MemoryRepository<TableT>>(hashed, ordered);
+}
+
+} // namespace
+
+MemoryStorageEngine::MemoryStorageEngine()
+    : userRepository(memoryRepository<UsersTable>({}, {UsersTable::indexOf<"type">()})),
+      patientRepository(memoryRepository<PatientsTable>({PatientsTable::indexOf<"userID">()}, {})),
+      doctorRepository(memoryRepository<DoctorsTable>({DoctorsTable::indexOf<"userID">()},
+                                                      {DoctorsTable::indexOf<"specialization">()})),
+      appointmentRepository(memoryRepository<AppointmentsFullTable>(
+          {AppointmentsFullTable::indexOf<"patientID">(), AppointmentsFullTable::indexOf<"doctorID">()},
+          {AppointmentsFullTable::indexOf<"date">(), AppointmentsFullTable::indexOf<"status">()})),
+      recordRepository(memoryRepository<MedicalRecordsFullTable>(
+          {MedicalRecordsFullTable::indexOf<"patientID">(), MedicalRecordsFullTable::indexOf<"doctorID">()},
+          {MedicalRecordsFullTable::indexOf<"date">()})),
+      prescriptionRepository(memoryRepository<PrescriptionsTable>(
+          {PrescriptionsTable::indexOf<"patientID">(), PrescriptionsTable::indexOf<"doctorID">()},
+          {PrescriptionsTable::indexOf<"date">()})),
+      reportRepository(memoryRepository<ReportsFullTable>({ReportsFullTable::indexOf<"doctorID">()},
+                                                          {ReportsFullTable::indexOf<"created_at">()})) {}
+
+MemoryStorageEngine::~MemoryStorageEngine() = default;
+
+std::string MemoryStorageEngine::name() const { return "memory"; }
+
+UserRepository& MemoryStorageEngine::users() { return *userRepository; }
+PatientRepository& MemoryStorageEngine::patients() { return *patientRepository; }
+DoctorRepository& MemoryStorageEngine::doctors() { return *doctorRepository; }
+AppointmentRepository& MemoryStorageEngine::appointments() { return *appointmentRepository; }
+MedicalRecordRepository& MemoryStorageEngine::records() { return *recordRepository; }
+PrescriptionRepository& MemoryStorageEngine::prescriptions() { return *prescriptionRepository; }
+ReportRepository& MemoryStorageEngine::reports() { return *reportRepository; }
+
+void MemoryStorageEngine::transaction(const std::function<void()>& work) {
+    work();
+}
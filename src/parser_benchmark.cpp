@@ -0,0 +1,106 @@
+#include "parser_benchmark.h"
+#include "crow.h"
+#include "request_parser.h"
+#include <chrono>
+#include <iomanip>
+#include <stdexcept>
+
+namespace {
+
+const std::string kAppointment = R"({"patient_id":1042,"doctor_id":17,"date":"2025-03-14","time":"09:30"})";
+const std::string kPatient = R"({"name":"Ada Lovelace","contact":"555-0100","age":36,"gender":"F"})";
+const std::string kRecord =
+    R"({"patient_id":1042,"doctor_id":17,"diagnosis":"Acute bronchitis with \"persistent\" cough\nno fever",)"
+    R"("treatment":"Rest, fluids; review in 7 days — sooner if worse","source":{"form":"intake","rev":3}})";
+
+bool isString(const crow::json::rvalue& body, const char* field) {
+    return body.has(field) && body[field].t() == crow::json::type::String;
+}
+
+bool isNumber(const crow::json::rvalue& body, const char* field) {
+    return body.has(field) && body[field].t() == crow::json::type::Number;
+}
+
+// What the handlers did per body before parseRequest existed.
+bool crowAppointment(const std::string& text, AppointmentRequest& out) {
+    auto body = crow::json::load(text);
+    if (!body || !isNumber(body, "patient_id") || !isNumber(body, "doctor_id") || !isString(body, "date") ||
+        !isString(body, "time")) {
+        return false;
+    }
+    out.patientID = static_cast<int>(body["patient_id"].i());
+    out.doctorID = static_cast<int>(body["doctor_id"].i());
+    out.date = body["date"].s();
+    out.time = body["time"].s();
+    return true;
+}
+
+bool crowPatient(const std::string& text, PatientRequest& out) {
+    auto body = crow::json::load(text);
+    if (!body || !isString(body, "name") || !isString(body, "contact") || !isNumber(body, "age") ||
+        !isString(body, "gender")) {
+        return false;
+    }
+    out.name = body["name"].s();
+    out.contact = body["contact"].s();
+    out.age = static_cast<int>(body["age"].i());
+    out.gender = body["gender"].s();
+    return true;
+}
+
+bool crowRecord(const std::string& text, RecordRequest& out) {
+    auto body = crow::json::load(text);
+    if (!body || !isNumber(body, "patient_id") || !isNumber(body, "doctor_id") || !isString(body, "diagnosis") ||
+        !isString(body, "treatment")) {
+        return false;
+    }
+    out.patientID = static_cast<int>(body["patient_id"].i());
+    out.doctorID = static_cast<int>(body["doctor_id"].i());
+    out.diagnosis = body["diagnosis"].s();
+    out.treatment = body["treatment"].s();
+    return true;
+}
+
+template <typename Decode>
+double timed(int iterations, Decode decode) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        if (!decode()) throw std::runtime_error("benchmark body failed to decode");
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+template <typename Request, typename CrowDecode>
+ParserBodyResult measure(const std::string& name, const std::string& text, int iterations, CrowDecode crowDecode) {
+    Request request;
+    std::string error;
+    ParserBodyResult result{name, text.size(), 0, 0};
+    result.crowSeconds = timed(iterations, [&] { return crowDecode(text, request); });
+    result.cursorSeconds = timed(iterations, [&] { return parseRequest(text, request, error); });
+    return result;
+}
+
+} // namespace
+
+std::vector<ParserBodyResult> ParserBenchmark::run(const ParserWorkload& workload) {
+    std::vector<ParserBodyResult> results;
+    results.push_back(measure<AppointmentRequest>("appointment", kAppointment, workload.iterations, crowAppointment));
+    results.push_back(measure<PatientRequest>("patient", kPatient, workload.iterations, crowPatient));
+    results.push_back(measure<RecordRequest>("record (escapes, extra field)", kRecord, workload.iterations, crowRecord));
+    return results;
+}
+
+void ParserBenchmark::print(std::ostream& out, const ParserWorkload& workload,
+                            const std::vector<ParserBodyResult>& results) {
+    out << workload.iterations << " decodes per body\n";
+    out << std::left << std::setw(32) << "body" << std::right << std::setw(8) << "bytes" << std::setw(16)
+        << "crow::json/s" << std::setw(16) << "parseRequest/s" << std::setw(10) << "speedup" << '\n';
+    for (const auto& result : results) {
+        double crowRate = result.crowSeconds > 0 ? workload.iterations / result.crowSeconds : 0;
+        double cursorRate = result.cursorSeconds > 0 ? workload.iterations / result.cursorSeconds : 0;
+        out << std::left << std::setw(32) << result.body << std::right << std::setw(8) << result.bytes << std::fixed
+            << std::setprecision(0) << std::setw(16) << crowRate << std::setw(16) << cursorRate
+            << std::setprecision(2) << std::setw(9) << (crowRate > 0 ? cursorRate / crowRate : 0) << "x\n";
+    }
+}
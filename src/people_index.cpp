@@ -0,0 +1,174 @@
+#include "people_index.h"
+#include "database_handler.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+
+PeopleIndex* PeopleIndex::instance = nullptr;
+
+namespace {
+
+std::string normalize(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text) {
+        result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+} // namespace
+
+PeopleIndex& PeopleIndex::getInstance() {
+    if (!instance) {
+        instance = new PeopleIndex();
+    }
+    return *instance;
+}
+
+bool PeopleIndex::isIndexedType(const std::string& type) {
+    return type == "patient" || type == "doctor";
+}
+
+std::vector<std::string> PeopleIndex::keysFor(const PersonEntry& person) {
+    std::vector<std::string> result;
+    std::string name = normalize(person.name);
+
+    // the full name plus the tail starting at each later word
+    for (size_t i = 0; i < name.size(); i++) {
+        bool wordStart = (i == 0 || name[i - 1] == ' ') && name[i] != ' ';
+        if (wordStart) {
+            result.push_back(name.substr(i));
+        }
+    }
+    if (!person.contact.empty()) {
+        result.push_back(normalize(person.contact));
+    }
+    return result;
+}
+
+void PeopleIndex::insertLocked(const PersonEntry& person) {
+    for (const auto& key : keysFor(person)) {
+        keys.emplace(key, person.userID);
+    }
+    people[person.userID] = person;
+}
+
+void PeopleIndex::eraseLocked(int userID) {
+    auto it = people.find(userID);
+    if (it == people.end()) return;
+    for (const auto& key : keysFor(it->second)) {
+        keys.erase({key, userID});
+    }
+    people.erase(it);
+}
+
+void PeopleIndex::rebuild() {
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+
+    std::string sql = "SELECT u.userID, COALESCE(p.patientID, d.doctorID, 0), u.type, u.name, u.contact "
+                     "FROM Users u "
+                     "LEFT JOIN Patients p ON p.userID = u.userID "
+                     "LEFT JOIN Doctors d ON d.userID = u.userID "
+                     "WHERE u.type IN ('patient', 'doctor');";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare people index statement: " +
+                               std::string(sqlite3_errmsg(db)));
+    }
+
+    std::unordered_map<int, PersonEntry> loadedPeople;
+    std::set<std::pair<std::string, int>> loadedKeys;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        PersonEntry person;
+        person.userID = sqlite3_column_int(stmt, 0);
+        person.roleID = sqlite3_column_int(stmt, 1);
+        person.type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        person.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        person.contact = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+        for (const auto& key : keysFor(person)) {
+            loadedKeys.emplace(key, person.userID);
+        }
+        loadedPeople[person.userID] = std::move(person);
+    }
+    sqlite3_finalize(stmt);
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    people.swap(loadedPeople);
+    keys.swap(loadedKeys);
+}
+
+void PeopleIndex::upsert(int userID, int roleID, const std::string& type,
+                         const std::string& name, const std::string& contact) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (!isIndexedType(type)) {
+        eraseLocked(userID);
+        return;
+    }
+    if (roleID == 0) {
+        auto it = people.find(userID);
+        if (it != people.end()) {
+            roleID = it->second.roleID;
+        }
+    }
+    eraseLocked(userID);
+    insertLocked(PersonEntry{userID, roleID, type, name, contact});
+}
+
+void PeopleIndex::updateName(int userID, const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = people.find(userID);
+    if (it == people.end()) return;
+    PersonEntry person = it->second;
+    person.name = name;
+    eraseLocked(userID);
+    insertLocked(person);
+}
+
+void PeopleIndex::updateContact(int userID, const std::string& contact) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = people.find(userID);
+    if (it == people.end()) return;
+    PersonEntry person = it->second;
+    person.contact = contact;
+    eraseLocked(userID);
+    insertLocked(person);
+}
+
+void PeopleIndex::remove(int userID) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    eraseLocked(userID);
+}
+
+std::vector<PersonEntry> PeopleIndex::search(const std::string& prefix, const std::string& type,
+                                             size_t limit) const {
+    std::vector<PersonEntry> results;
+    std::string key = normalize(prefix);
+    if (key.empty() || limit == 0) {
+        return results;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::unordered_set<int> seen;
+    for (auto it = keys.lower_bound({key, INT_MIN}); it != keys.end(); ++it) {
+        if (it->first.compare(0, key.size(), key) != 0) break;
+        if (!seen.insert(it->second).second) continue;
+
+        const PersonEntry& person = people.at(it->second);
+        if (!type.empty() && person.type != type) continue;
+
+        results.push_back(person);
+        if (results.size() >= limit) break;
+    }
+    return results;
+}
+
+size_t PeopleIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return people.size();
+}
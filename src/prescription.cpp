@@ -0,0 +1,59 @@
+#include "prescription.h"
+#include "database_handler.h"
+#include "tables.h"
+#include <sqlite3.h>
+#include <iostream>
+#include <stdexcept>
+
+Prescription::Prescription(int prescriptionID, int doctorID, int patientID, const std::string& medicine,
+                           const std::string& dosage, const std::string& date)
+    : prescriptionID(prescriptionID), doctorID(doctorID), patientID(patientID),
+      medicine(medicine), dosage(dosage), date(date) {}
+
+namespace {
+
+std::vector<Prescription*> loadPrescriptions(const char* sql, int id) {
+    std::vector<Prescription*> prescriptions;
+    table::Statement stmt(DatabaseHandler::getInstance().getDatabase(), sql);
+    stmt.bind(1, id);
+
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        auto [prescriptionID, doctorID, patientID, medicine, dosage, date] = PrescriptionsTable::decode(stmt.get());
+        prescriptions.push_back(new Prescription(prescriptionID, doctorID, patientID, medicine, dosage, date));
+    }
+    return prescriptions;
+}
+
+} // namespace
+
+std::vector<Prescription*> Prescription::getPrescriptionsForPatient(int patientID) {
+    static constexpr auto sql =
+        PrescriptionsTable::select<" WHERE patientID = ? ORDER BY date DESC, prescriptionID DESC;">;
+    return loadPrescriptions(sql.c_str(), patientID);
+}
+
+std::vector<Prescription*> Prescription::getPrescriptionsForDoctor(int doctorID) {
+    static constexpr auto sql =
+        PrescriptionsTable::select<" WHERE doctorID = ? ORDER BY date DESC, prescriptionID DESC;">;
+    return loadPrescriptions(sql.c_str(), doctorID);
+}
+
+std::vector<std::string> Prescription::getActiveMedicinesForPatient(int patientID, int activeDays) {
+    std::vector<std::string> medicines;
+    table::Statement stmt(DatabaseHandler::getInstance().getDatabase(),
+                          "SELECT DISTINCT medicine FROM Prescriptions WHERE patientID = ? AND date >= date('now', ?);");
+    stmt.bind(1, patientID, "-" + std::to_string(activeDays) + " days");
+
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        medicines.push_back(table::readColumn<std::string>(stmt.get(), 0));
+    }
+    return medicines;
+}
+
+// Getters
+int Prescription::getPrescriptionID() const { return prescriptionID; }
+int Prescription::getDoctorID() const { return doctorID; }
+int Prescription::getPatientID() const { return patientID; }
+std::string Prescription::getMedicine() const { return medicine; }
+std::string Prescription::getDosage() const { return dosage; }
+std::string Prescription::getDate() const { return date; }
@@ -0,0 +1,135 @@
+#include "query_budget.h"
+#include <algorithm>
+
+QueryBudget* QueryBudget::instance = nullptr;
+
+namespace {
+
+// VM instructions between deadline checks; well under a millisecond of work
+constexpr int kCheckInterval = 1000;
+
+thread_local QueryBudget::BudgetPtr threadBudget;
+
+int checkDeadline(void*) {
+    // threads without a budget (analytics, maintenance, backups) pay one compare
+    QueryBudget::Budget* budget = threadBudget.get();
+    if (!budget || budget->deadline == QueryBudget::Clock::time_point::max()) return 0;
+    if (QueryBudget::Clock::now() < budget->deadline) return 0;
+    budget->interrupted = true;
+    return 1;
+}
+
+} // namespace
+
+bool QueryBudget::Budget::expired() const {
+    return deadline != Clock::time_point::max() && Clock::now() >= deadline;
+}
+
+QueryBudget::Scope::Scope(BudgetPtr budget) : previous(std::move(threadBudget)) {
+    threadBudget = std::move(budget);
+}
+
+QueryBudget::Scope::Scope(Clock::time_point deadline) : Scope(std::make_shared<Budget>(deadline)) {}
+
+QueryBudget::Scope::~Scope() {
+    threadBudget = std::move(previous);
+}
+
+QueryBudget::QueryBudget() {
+    // Admission already bounds how long a request waits for a slot; these
+    // bound how long it may then spend in the database.
+    state(RouteClass::Read).budgetMillis = 2000;
+    state(RouteClass::Write).budgetMillis = 5000;
+    state(RouteClass::Bulk).budgetMillis = 30000;
+    exports.budgetMillis = 600000;
+}
+
+QueryBudget& QueryBudget::getInstance() {
+    if (!instance) {
+        instance = new QueryBudget();
+    }
+    return *instance;
+}
+
+QueryBudget::ClassState& QueryBudget::state(RouteClass routeClass) {
+    return states[static_cast<int>(routeClass)];
+}
+
+void QueryBudget::install(sqlite3* conn) {
+    sqlite3_progress_handler(conn, kCheckInterval, checkDeadline, nullptr);
+}
+
+QueryBudget::BudgetPtr QueryBudget::current() {
+    return threadBudget;
+}
+
+bool QueryBudget::expired() {
+    return threadBudget && threadBudget->expired();
+}
+
+bool QueryBudget::interrupted() {
+    return threadBudget && threadBudget->interrupted;
+}
+
+void QueryBudget::setBudget(RouteClass routeClass, int millis) {
+    if (routeClass == RouteClass::Exempt) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    state(routeClass).budgetMillis = std::max(0, millis);
+}
+
+int QueryBudget::getBudget(RouteClass routeClass) {
+    if (routeClass == RouteClass::Exempt) return 0;
+    std::lock_guard<std::mutex> lock(mutex);
+    return state(routeClass).budgetMillis;
+}
+
+QueryBudget::Clock::time_point QueryBudget::deadlineFor(RouteClass routeClass) {
+    int millis = getBudget(routeClass);
+    if (millis <= 0) return Clock::time_point::max();
+    return Clock::now() + std::chrono::milliseconds(millis);
+}
+
+QueryBudget::BudgetPtr QueryBudget::budgetFor(RouteClass routeClass) {
+    return std::make_shared<Budget>(deadlineFor(routeClass));
+}
+
+void QueryBudget::setExportBudget(int millis) {
+    std::lock_guard<std::mutex> lock(mutex);
+    exports.budgetMillis = std::max(0, millis);
+}
+
+int QueryBudget::getExportBudget() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return exports.budgetMillis;
+}
+
+QueryBudget::BudgetPtr QueryBudget::exportBudget() {
+    int millis = getExportBudget();
+    return std::make_shared<Budget>(millis <= 0 ? Clock::time_point::max()
+                                                : Clock::now() + std::chrono::milliseconds(millis));
+}
+
+void QueryBudget::recordExportInterrupted() {
+    exports.interrupted++;
+}
+
+void QueryBudget::recordExpiredInQueue(RouteClass routeClass) {
+    if (routeClass == RouteClass::Exempt) return;
+    state(routeClass).expiredInQueue++;
+}
+
+void QueryBudget::recordInterrupted(RouteClass routeClass) {
+    if (routeClass == RouteClass::Exempt) return;
+    state(routeClass).interrupted++;
+}
+
+std::vector<QueryBudgetMetrics> QueryBudget::metrics() {
+    std::vector<QueryBudgetMetrics> result;
+    for (RouteClass routeClass : {RouteClass::Read, RouteClass::Write, RouteClass::Bulk}) {
+        ClassState& s = state(routeClass);
+        result.push_back({AdmissionController::className(routeClass), getBudget(routeClass),
+                          s.expiredInQueue.load(), s.interrupted.load()});
+    }
+    result.push_back({"export", getExportBudget(), 0, exports.interrupted.load()});
+    return result;
+}
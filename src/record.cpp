@@ -1,16 +1,22 @@
 #include "record.h"
+#include "archive_manager.h"
 #include "database_handler.h"
+#include "change_feed.h"
+#include "tables.h"
 #include <sqlite3.h>
 #include <iostream>
+#include <algorithm>
 #include <stdexcept>
+#include <unordered_set>
 #include <vector>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
+#include <cctype>
 
-MedicalRecord::MedicalRecord(int recordID, Patient* patient, Doctor* doctor,
+MedicalRecord::MedicalRecord(int recordID, int patientID, int doctorID,
                             const std::string& diagnosis, const std::string& treatment)
-    : recordID(recordID), patient(patient), doctor(doctor),
+    : recordID(recordID), patient(patientID), doctor(doctorID),
       diagnosis(diagnosis), treatment(treatment) 
 {
     // Set current date if not provided
@@ -21,226 +27,272 @@ MedicalRecord::MedicalRecord(int recordID, Patient* patient, Doctor* doctor,
     date = oss.str();
 }
 
+MedicalRecord::MedicalRecord(int recordID, int patientID, int doctorID, const std::string& diagnosis,
+                             const std::string& treatment, const std::string& date)
+    : recordID(recordID), patient(patientID), doctor(doctorID),
+      diagnosis(diagnosis), treatment(treatment), date(date) {}
+
 bool MedicalRecord::saveToDatabase() {
-    if (!patient || !doctor) {
+    if (patient.getID() == 0 || doctor.getID() == 0) {
         throw std::invalid_argument("Patient and Doctor must be valid");
     }
 
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-
-    std::string sql = recordID == 0 ?
-        "INSERT INTO MedicalRecords (patientID, doctorID, diagnosis, treatment, date) VALUES (?, ?, ?, ?, ?);" :
-        "UPDATE MedicalRecords SET diagnosis = ?, treatment = ?, date = ? WHERE recordID = ?;";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare medical record statement: " + 
-                               std::string(sqlite3_errmsg(db)));
-    }
-
-    if (recordID == 0) {
-        sqlite3_bind_int(stmt, 1, patient->getPatientID());
-        sqlite3_bind_int(stmt, 2, doctor->getDoctorID());
-        sqlite3_bind_text(stmt, 3, diagnosis.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 4, treatment.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 5, date.c_str(), -1, SQLITE_TRANSIENT);
-    } else {
-        sqlite3_bind_text(stmt, 1, diagnosis.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 2, treatment.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt, 3, date.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_int(stmt, 4, recordID);
+    bool created = recordID == 0;
+    bool changed = true;
+
+    try {
+        if (created) {
+            recordID = static_cast<int>(MedicalRecordsTable::insert(db, patient.getID(), doctor.getID(),
+                                                                    diagnosis, treatment, date));
+        } else {
+            changed = MedicalRecordsTable::update(db, recordID, patient.getID(), doctor.getID(),
+                                                  diagnosis, treatment, date);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error saving medical record: " << e.what() << std::endl;
+        return false;
     }
 
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    if (success && recordID == 0) {
-        recordID = sqlite3_last_insert_rowid(db);
+    // an update that matched no row (already deleted) has nothing to announce
+    if (changed) {
+        ChangeFeed::getInstance().publish("record", created ? "created" : "updated", recordID,
+                                          patient.getID(), doctor.getID(), date);
     }
-
-    sqlite3_finalize(stmt);
-    return success;
+    return true;
 }
 
 bool MedicalRecord::deleteFromDatabase() {
     if (recordID == 0) return false;
 
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-
-    std::string sql = "DELETE FROM MedicalRecords WHERE recordID = ?;";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare delete statement: " + 
-                               std::string(sqlite3_errmsg(db)));
+    bool deleted;
+    try {
+        deleted = MedicalRecordsTable::remove(db, recordID);
+    } catch (const std::exception& e) {
+        std::cerr << "Error deleting medical record: " << e.what() << std::endl;
+        return false;
     }
 
-    sqlite3_bind_int(stmt, 1, recordID);
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
+    if (deleted) {
+        ChangeFeed::getInstance().publish("record", "deleted", recordID,
+                                          patient.getID(), doctor.getID(), date);
+    }
+    return true;
+}
 
-    sqlite3_finalize(stmt);
-    return success;
+static MedicalRecord* decodeRecord(sqlite3_stmt* stmt) {
+    auto [id, patientID, doctorID, diagnosis, treatment, date] = MedicalRecordsTable::decode(stmt);
+    return new MedicalRecord(id, patientID, doctorID, diagnosis, treatment, date);
 }
 
-MedicalRecord* MedicalRecord::getRecordFromDatabase(int recordID) {
+MedicalRecord* MedicalRecord::getRecordFromDatabase(int recordID, bool includeArchived) {
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-
-    std::string sql = "SELECT recordID, patientID, doctorID, diagnosis, treatment, date "
-                     "FROM MedicalRecords WHERE recordID = ?;";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare select statement: " + 
-                               std::string(sqlite3_errmsg(db)));
+    auto row = MedicalRecordsTable::findByKey(db, recordID);
+    if (row) {
+        auto& [id, patientID, doctorID, diagnosis, treatment, date] = *row;
+        return new MedicalRecord(id, patientID, doctorID, diagnosis, treatment, date);
     }
-
-    sqlite3_bind_int(stmt, 1, recordID);
-
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        int patientID = sqlite3_column_int(stmt, 1);
-        int doctorID = sqlite3_column_int(stmt, 2);
-        std::string diagnosis = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        std::string treatment = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        std::string date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-
-        Patient* patient = Patient::getPatientFromDatabase(patientID);
-        Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
-
-        if (!patient || !doctor) {
-            sqlite3_finalize(stmt);
-            throw std::runtime_error("Failed to load patient or doctor data");
-        }
-
-        MedicalRecord* record = new MedicalRecord(id, patient, doctor, diagnosis, treatment);
-        record->date = date;
-        sqlite3_finalize(stmt);
-        return record;
+    if (!includeArchived) {
+        return nullptr;
     }
 
-    sqlite3_finalize(stmt);
-    return nullptr;
+    // the key does not tell which year the row was archived under, so every
+    // year is searched, a connection's worth at a time
+    MedicalRecord* record = nullptr;
+    ArchiveManager& archive = ArchiveManager::getInstance();
+    archive.readArchived("MedicalRecords", archive.allYears(), [&](sqlite3* conn, const std::string& source) {
+        std::string sql = MedicalRecordsTable::selectFrom(source) + " WHERE recordID = ?;";
+        table::Statement stmt(conn, sql.c_str());
+        stmt.bind(1, recordID);
+        if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            record = decodeRecord(stmt.get());
+        }
+        return record == nullptr;
+    });
+    return record;
 }
 
-std::vector<MedicalRecord*> MedicalRecord::getRecordsForPatient(int patientID) {
+// Records newest first, archived ones included. The hot rows come from the
+// shared connection and the prebuilt SELECT; archived ones are read a
+// connection's worth of years at a time and merged in.
+template <table::FixedString Suffix>
+static std::vector<MedicalRecord*> loadRecords(int filterID) {
     std::vector<MedicalRecord*> records;
-    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-
-    std::string sql = "SELECT recordID, doctorID, diagnosis, treatment, date "
-                     "FROM MedicalRecords WHERE patientID = ? "
-                     "ORDER BY date DESC;";
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare patient records statement: " + 
-                               std::string(sqlite3_errmsg(db)));
-    }
-
-    sqlite3_bind_int(stmt, 1, patientID);
+    std::unordered_set<int> seen;
+    auto read = [&](table::Statement& stmt) {
+        if (filterID != 0) {
+            stmt.bind(1, filterID);
+        }
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            // a row moved while the batches were read is in both
+            if (seen.insert(sqlite3_column_int(stmt.get(), 0)).second) {
+                records.push_back(decodeRecord(stmt.get()));
+            }
+        }
+    };
 
-    Patient* patient = Patient::getPatientFromDatabase(patientID);
-    if (!patient) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Invalid patient ID");
-    }
+    try {
+        table::Statement hot(DatabaseHandler::getInstance().getDatabase(), MedicalRecordsTable::select<Suffix>.c_str());
+        read(hot);
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        int doctorID = sqlite3_column_int(stmt, 1);
-        std::string diagnosis = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string treatment = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        std::string date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-
-        Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
-        if (doctor) {
-            MedicalRecord* record = new MedicalRecord(id, patient, doctor, diagnosis, treatment);
-            record->date = date;
-            records.push_back(record);
+        ArchiveManager& archive = ArchiveManager::getInstance();
+        std::vector<int> years = archive.allYears();
+        if (years.empty()) {
+            return records;
         }
+        archive.readArchived("MedicalRecords", years, [&](sqlite3* conn, const std::string& source) {
+            std::string sql = MedicalRecordsTable::selectFrom(source) + Suffix.c_str();
+            table::Statement stmt(conn, sql.c_str());
+            read(stmt);
+            return true;
+        });
+    } catch (...) {
+        for (MedicalRecord* record : records) delete record;
+        throw;
     }
 
-    sqlite3_finalize(stmt);
+    std::stable_sort(records.begin(), records.end(), [](const MedicalRecord* a, const MedicalRecord* b) {
+        return a->getDate() > b->getDate();
+    });
     return records;
 }
 
-std::vector<MedicalRecord*> MedicalRecord::getRecordsByDoctor(int doctorID) {
-    std::vector<MedicalRecord*> records;
-    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-
-    std::string sql = "SELECT recordID, patientID, diagnosis, treatment, date "
-                     "FROM MedicalRecords WHERE doctorID = ? "
-                     "ORDER BY date DESC;";
+std::vector<MedicalRecord*> MedicalRecord::getRecordsForPatient(int patientID) {
+    return loadRecords<" WHERE patientID = ? ORDER BY date DESC;">(patientID);
+}
 
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare doctor records statement: " + 
-                               std::string(sqlite3_errmsg(db)));
-    }
+std::vector<MedicalRecord*> MedicalRecord::getRecordsByDoctor(int doctorID) {
+    return loadRecords<" WHERE doctorID = ? ORDER BY date DESC;">(doctorID);
+}
 
-    sqlite3_bind_int(stmt, 1, doctorID);
+std::vector<MedicalRecord*> MedicalRecord::getAllRecordsFromDatabase() {
+    return loadRecords<" ORDER BY date DESC;">(0);
+}
 
-    Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
-    if (!doctor) {
-        sqlite3_finalize(stmt);
-        throw std::runtime_error("Invalid doctor ID");
+namespace {
+
+// Turns free text into an FTS5 query: every word becomes a quoted phrase so
+// user input can never be parsed as query syntax, and the last word matches
+// as a prefix so results update while the user is still typing.
+std::string toMatchExpression(const std::string& query) {
+    std::string expression;
+    std::string word;
+    auto flush = [&](bool last) {
+        if (word.empty()) return;
+        if (!expression.empty()) expression += ' ';
+        expression += '"';
+        for (char c : word) {
+            if (c == '"') expression += '"';
+            expression += c;
+        }
+        expression += last ? "\"*" : "\"";
+        word.clear();
+    };
+    for (char c : query) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            flush(false);
+        } else {
+            word += c;
+        }
     }
+    flush(true);
+    return expression;
+}
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        int patientID = sqlite3_column_int(stmt, 1);
-        std::string diagnosis = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string treatment = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        std::string date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-
-        Patient* patient = Patient::getPatientFromDatabase(patientID);
-        if (patient) {
-            MedicalRecord* record = new MedicalRecord(id, patient, doctor, diagnosis, treatment);
-            record->date = date;
-            records.push_back(record);
+// snippet() wraps matches in these; neither occurs in clinical text
+const char kMatchStart = '\x02';
+const char kMatchEnd = '\x03';
+
+// The snippet is stored text, so it is HTML-escaped before the match
+// markers become <b> tags; clients may render it as markup.
+std::string highlightSnippet(const char* text) {
+    std::string html;
+    for (const char* c = text; *c; c++) {
+        switch (*c) {
+            case kMatchStart: html += "<b>"; break;
+            case kMatchEnd: html += "</b>"; break;
+            case '&': html += "&amp;"; break;
+            case '<': html += "&lt;"; break;
+            case '>': html += "&gt;"; break;
+            case '"': html += "&quot;"; break;
+            case '\'': html += "&#39;"; break;
+            default: html += *c;
         }
     }
-
-    sqlite3_finalize(stmt);
-    return records;
+    return html;
 }
 
-std::vector<MedicalRecord*> MedicalRecord::getAllRecordsFromDatabase() {
-    std::vector<MedicalRecord*> records;
+} // namespace
+
+std::vector<RecordSearchHit> MedicalRecord::searchRecords(const std::string& query, int patientID, int doctorID,
+                                                          int limit, int offset) {
+    std::vector<RecordSearchHit> hits;
+    std::string expression = toMatchExpression(query);
+    if (expression.empty()) {
+        return hits;
+    }
+
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
     sqlite3_stmt* stmt;
 
-    std::string sql = "SELECT recordID, patientID, doctorID, diagnosis, treatment, date "
-                     "FROM MedicalRecords ORDER BY date DESC;";
+    // diagnosis matches weigh twice as much as treatment matches
+    std::string sql = "SELECT m.recordID, m.patientID, pu.name, m.doctorID, du.name, "
+                     "m.diagnosis, m.treatment, m.date, "
+                     "snippet(MedicalRecordsSearch, -1, char(2), char(3), '...', 12), "
+                     "bm25(MedicalRecordsSearch, 2.0, 1.0) AS score "
+                     "FROM MedicalRecordsSearch "
+                     "JOIN MedicalRecords m ON m.recordID = MedicalRecordsSearch.rowid "
+                     "JOIN Patients p ON m.patientID = p.patientID JOIN Users pu ON p.userID = pu.userID "
+                     "JOIN Doctors d ON m.doctorID = d.doctorID JOIN Users du ON d.userID = du.userID "
+                     "WHERE MedicalRecordsSearch MATCH ?1 "
+                     "AND (?2 = 0 OR m.patientID = ?2) AND (?3 = 0 OR m.doctorID = ?3) "
+                     "ORDER BY score LIMIT ?4 OFFSET ?5;";
 
     if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        throw std::runtime_error("Failed to prepare select all records statement: " + 
+        throw std::runtime_error("Failed to prepare record search statement: " +
                                std::string(sqlite3_errmsg(db)));
     }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        int patientID = sqlite3_column_int(stmt, 1);
-        int doctorID = sqlite3_column_int(stmt, 2);
-        std::string diagnosis = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        std::string treatment = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        std::string date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
-
-        Patient* patient = Patient::getPatientFromDatabase(patientID);
-        Doctor* doctor = Doctor::getDoctorFromDatabase(doctorID);
-
-        if (patient && doctor) {
-            MedicalRecord* record = new MedicalRecord(id, patient, doctor, diagnosis, treatment);
-            record->date = date;
-            records.push_back(record);
-        }
+    sqlite3_bind_text(stmt, 1, expression.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 2, patientID);
+    sqlite3_bind_int(stmt, 3, doctorID);
+    sqlite3_bind_int(stmt, 4, limit + 1);
+    sqlite3_bind_int(stmt, 5, offset);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        RecordSearchHit hit;
+        hit.recordID = sqlite3_column_int(stmt, 0);
+        hit.patientID = sqlite3_column_int(stmt, 1);
+        hit.patientName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        hit.doctorID = sqlite3_column_int(stmt, 3);
+        hit.doctorName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+        hit.diagnosis = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+        hit.treatment = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6));
+        hit.date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 7));
+        hit.snippet = highlightSnippet(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 8)));
+        // bm25 is lower-is-better; flip it so clients can sort descending
+        hit.score = -sqlite3_column_double(stmt, 9);
+        hits.push_back(hit);
+    }
+
+    if (rc != SQLITE_DONE) {
+        std::string error = sqlite3_errmsg(db);
+        sqlite3_finalize(stmt);
+        throw std::runtime_error("Record search failed: " + error);
     }
 
     sqlite3_finalize(stmt);
-    return records;
+    return hits;
 }
 
 // Getters
 int MedicalRecord::getRecordID() const { return recordID; }
-Patient* MedicalRecord::getPatient() const { return patient; }
-Doctor* MedicalRecord::getDoctor() const { return doctor; }
+int MedicalRecord::getPatientID() const { return patient.getID(); }
+int MedicalRecord::getDoctorID() const { return doctor.getID(); }
+const EntityRef<Patient>& MedicalRecord::getPatient() const { return patient; }
+const EntityRef<Doctor>& MedicalRecord::getDoctor() const { return doctor; }
 std::string MedicalRecord::getDiagnosis() const { return diagnosis; }
 std::string MedicalRecord::getTreatment() const { return treatment; }
 std::string MedicalRecord::getDate() const {
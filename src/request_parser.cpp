@@ -0,0 +1,328 @@
+#include "request_parser.h"
+#include <cstdint>
+
+JsonCursor::JsonCursor(const std::string& text)
+    : begin(text.data()), p(text.data()), end(text.data() + text.size()) {}
+
+void JsonCursor::skipSpace() {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) p++;
+}
+
+const std::string& JsonCursor::getError() const {
+    return error;
+}
+
+bool JsonCursor::syntaxError(const std::string& message) {
+    error = "Invalid JSON: " + message + " at offset " + std::to_string(p - begin);
+    return false;
+}
+
+bool JsonCursor::fieldError(const std::string& message) {
+    error = message;
+    return false;
+}
+
+bool JsonCursor::require(bool seen, const char* field) {
+    return seen || fieldError(std::string("Missing required field '") + field + "'");
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static void appendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out.push_back(static_cast<char>(codepoint));
+    } else if (codepoint < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (codepoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+    } else if (codepoint < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (codepoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+    } else {
+        out.push_back(static_cast<char>(0xf0 | (codepoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (codepoint & 0x3f)));
+    }
+}
+
+bool JsonCursor::readString(std::string& out) {
+    p++;  // opening quote
+    const char* start = p;
+    while (p < end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) p++;
+    out.assign(start, p - start);
+
+    while (p < end && *p != '"') {
+        if (static_cast<unsigned char>(*p) < 0x20) return syntaxError("Control character in string");
+        if (*p != '\\') { out.push_back(*p++); continue; }
+        if (++p >= end) break;
+        char escape = *p++;
+        switch (escape) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                uint32_t codepoint = 0;
+                for (int i = 0; i < 4; i++) {
+                    int digit = p < end ? hexValue(*p++) : -1;
+                    if (digit < 0) return syntaxError("Bad \\u escape");
+                    codepoint = codepoint << 4 | digit;
+                }
+                // a surrogate is only valid as the high half of a pair; on its
+                // own it would be stored as invalid UTF-8
+                if (codepoint >= 0xdc00 && codepoint < 0xe000) {
+                    return syntaxError("Unpaired surrogate in \\u escape");
+                }
+                if (codepoint >= 0xd800 && codepoint < 0xdc00) {
+                    uint32_t low = 0;
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u') {
+                        return syntaxError("Unpaired surrogate in \\u escape");
+                    }
+                    for (int i = 2; i < 6; i++) {
+                        int digit = hexValue(p[i]);
+                        if (digit < 0) return syntaxError("Bad \\u escape");
+                        low = low << 4 | digit;
+                    }
+                    if (low < 0xdc00 || low >= 0xe000) return syntaxError("Unpaired surrogate in \\u escape");
+                    p += 6;
+                    codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                }
+                appendUtf8(out, codepoint);
+                break;
+            }
+            default:
+                p--;
+                return syntaxError("Bad escape in string");
+        }
+    }
+    if (p >= end) return syntaxError("Unterminated string");
+    p++;
+    return true;
+}
+
+bool JsonCursor::string(std::string& out, const char* field) {
+    if (p >= end || *p != '"') return fieldError(std::string("Field '") + field + "' must be a string");
+    return readString(out);
+}
+
+bool JsonCursor::integer(int& out, const char* field) {
+    const char* start = p;
+    bool negative = p < end && *p == '-';
+    if (negative) p++;
+    if (p >= end || *p < '0' || *p > '9') {
+        p = start;
+        return fieldError(std::string("Field '") + field + "' must be an integer");
+    }
+
+    int64_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        if (value > 2147483648LL) return fieldError(std::string("Field '") + field + "' is out of range");
+    }
+    if (p < end && (*p == '.' || *p == 'e' || *p == 'E')) {
+        return fieldError(std::string("Field '") + field + "' must be an integer");
+    }
+    if (negative) value = -value;
+    if (value > INT32_MAX) return fieldError(std::string("Field '") + field + "' is out of range");
+    out = static_cast<int>(value);
+    return true;
+}
+
+bool JsonCursor::boolean(bool& out, const char* field) {
+    if (end - p >= 4 && std::string_view(p, 4) == "true") {
+        p += 4;
+        out = true;
+        return true;
+    }
+    if (end - p >= 5 && std::string_view(p, 5) == "false") {
+        p += 5;
+        out = false;
+        return true;
+    }
+    return fieldError(std::string("Field '") + field + "' must be true or false");
+}
+
+bool JsonCursor::skip() {
+    return skipValue(0);
+}
+
+bool JsonCursor::skipValue(int depth) {
+    if (depth > 64) return syntaxError("Nesting is too deep");
+    skipSpace();
+    if (p >= end) return syntaxError("Expected a value");
+
+    char c = *p;
+    if (c == '"') {
+        std::string ignored;
+        return readString(ignored);
+    }
+    if (c == '{' || c == '[') {
+        char close = c == '{' ? '}' : ']';
+        p++;
+        skipSpace();
+        if (p < end && *p == close) { p++; return true; }
+        while (true) {
+            skipSpace();
+            if (c == '{') {
+                std::string ignored;
+                if (p >= end || *p != '"') return syntaxError("Expected a field name");
+                if (!readString(ignored)) return false;
+                skipSpace();
+                if (p >= end || *p != ':') return syntaxError("Expected ':'");
+                p++;
+            }
+            if (!skipValue(depth + 1)) return false;
+            skipSpace();
+            if (p < end && *p == ',') { p++; continue; }
+            if (p < end && *p == close) { p++; return true; }
+            return syntaxError(std::string("Expected ',' or '") + close + "'");
+        }
+    }
+    for (const char* literal : {"true", "false", "null"}) {
+        std::string_view word(literal);
+        if (static_cast<size_t>(end - p) >= word.size() && std::string_view(p, word.size()) == word) {
+            p += word.size();
+            return true;
+        }
+    }
+    const char* start = p;
+    while (p < end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E')) {
+        p++;
+    }
+    if (p == start) return syntaxError("Unexpected character");
+    return true;
+}
+
+bool parseRequest(const std::string& body, PatientRequest& out, std::string& error) {
+    JsonCursor cursor(body);
+    bool name = false, contact = false, age = false, gender = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        if (key == "name") return name = cursor.string(out.name, "name");
+        if (key == "contact") return contact = cursor.string(out.contact, "contact");
+        if (key == "age") return age = cursor.integer(out.age, "age");
+        if (key == "gender") return gender = cursor.string(out.gender, "gender");
+        return cursor.skip();
+    }) && cursor.require(name, "name") && cursor.require(contact, "contact") &&
+         cursor.require(age, "age") && cursor.require(gender, "gender");
+    if (!ok) error = cursor.getError();
+    return ok;
+}
+
+bool parseRequest(const std::string& body, DoctorRequest& out, std::string& error) {
+    JsonCursor cursor(body);
+    bool name = false, contact = false, specialization = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        if (key == "name") return name = cursor.string(out.name, "name");
+        if (key == "contact") return contact = cursor.string(out.contact, "contact");
+        if (key == "specialization") return specialization = cursor.string(out.specialization, "specialization");
+        return cursor.skip();
+    }) && cursor.require(name, "name") && cursor.require(contact, "contact") &&
+         cursor.require(specialization, "specialization");
+    if (!ok) error = cursor.getError();
+    return ok;
+}
+
+bool parseRequest(const std::string& body, UserRequest& out, std::string& error) {
+    JsonCursor cursor(body);
+    bool name = false, contact = false, type = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        if (key == "name") return name = cursor.string(out.name, "name");
+        if (key == "contact") return contact = cursor.string(out.contact, "contact");
+        if (key == "type") return type = cursor.string(out.type, "type");
+        return cursor.skip();
+    }) && cursor.require(name, "name") && cursor.require(contact, "contact") && cursor.require(type, "type");
+    if (!ok) error = cursor.getError();
+    return ok;
+}
+
+bool parseRequest(const std::string& body, AppointmentRequest& out, std::string& error) {
+    JsonCursor cursor(body);
+    bool patient = false, doctor = false, date = false, time = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        if (key == "patient_id") return patient = cursor.integer(out.patientID, "patient_id");
+        if (key == "doctor_id") return doctor = cursor.integer(out.doctorID, "doctor_id");
+        if (key == "date") return date = cursor.string(out.date, "date");
+        if (key == "time") return time = cursor.string(out.time, "time");
+        return cursor.skip();
+    }) && cursor.require(patient, "patient_id") && cursor.require(doctor, "doctor_id") &&
+         cursor.require(date, "date") && cursor.require(time, "time");
+    if (!ok) error = cursor.getError();
+    return ok;
+}
+
+bool parseRequest(const std::string& body, AppointmentUpdate& out, std::string& error) {
+    JsonCursor cursor(body);
+    bool ok = cursor.object([&](std::string_view key) {
+        if (key == "date") return cursor.string(out.date.emplace(), "date");
+        if (key == "time") return cursor.string(out.time.emplace(), "time");
+        return cursor.skip();
+    });
+    if (!ok) error = cursor.getError();
+    return ok;
+}
+
+bool parseRequest(const std::string& body, RecordRequest& out, std::string& error) {
+    JsonCursor cursor(body);
+    bool patient = false, doctor = false, diagnosis = false, treatment = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        if (key == "patient_id") return patient = cursor.integer(out.patientID, "patient_id");
+        if (key == "doctor_id") return doctor = cursor.integer(out.doctorID, "doctor_id");
+        if (key == "diagnosis") return diagnosis = cursor.string(out.diagnosis, "diagnosis");
+        if (key == "treatment") return treatment = cursor.string(out.treatment, "treatment");
+        return cursor.skip();
+    }) && cursor.require(patient, "patient_id") && cursor.require(doctor, "doctor_id") &&
+         cursor.require(diagnosis, "diagnosis") && cursor.require(treatment, "treatment");
+    if (!ok) error = cursor.getError();
+    return ok;
+}
+
+bool parseRequest(const std::string& body, PrescriptionRequest& out, std::string& error) {
+    JsonCursor cursor(body);
+    bool patient = false, medicine = false, dosage = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        if (key == "patient_id") return patient = cursor.integer(out.patientID, "patient_id");
+        if (key == "medicine") return medicine = cursor.string(out.medicine, "medicine");
+        if (key == "dosage") return dosage = cursor.string(out.dosage, "dosage");
+        if (key == "override_interactions") return cursor.boolean(out.overrideInteractions, "override_interactions");
+        return cursor.skip();
+    }) && cursor.require(patient, "patient_id") && cursor.require(medicine, "medicine") &&
+         cursor.require(dosage, "dosage");
+    if (!ok) error = cursor.getError();
+    return ok;
+}
+
+bool parseRequest(const std::string& body, ReportRequest& out, std::string& error) {
+    JsonCursor cursor(body);
+    bool doctor = false, details = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        if (key == "doctor_id") return doctor = cursor.integer(out.doctorID, "doctor_id");
+        if (key == "details") return details = cursor.string(out.details, "details");
+        return cursor.skip();
+    }) && cursor.require(doctor, "doctor_id") && cursor.require(details, "details");
+    if (!ok) error = cursor.getError();
+    return ok;
+}
+
+bool parseRequest(const std::string& body, ReportGenerationRequest& out, std::string& error) {
+    JsonCursor cursor(body);
+    bool type = false, start = false, endDate = false;
+    bool ok = cursor.object([&](std::string_view key) {
+        if (key == "report_type") return type = cursor.string(out.reportType, "report_type");
+        if (key == "start_date") return start = cursor.string(out.startDate, "start_date");
+        if (key == "end_date") return endDate = cursor.string(out.endDate, "end_date");
+        return cursor.skip();
+    }) && cursor.require(type, "report_type") && cursor.require(start, "start_date") &&
+         cursor.require(endDate, "end_date");
+    if (!ok) error = cursor.getError();
+    return ok;
+}
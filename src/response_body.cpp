@@ -0,0 +1,139 @@
+#include "response_body.h"
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+void appendEscaped(std::string& out, const std::string& value) {
+    out.push_back('"');
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+                    out += buffer;
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+} // namespace
+
+ResponseBody ResponseBody::list() {
+    ResponseBody value;
+    value.type = Type::List;
+    return value;
+}
+
+ResponseBody ResponseBody::object() {
+    ResponseBody value;
+    value.type = Type::Object;
+    return value;
+}
+
+void ResponseBody::reset(Type to) {
+    if (type == Type::List || type == Type::Object) {
+        keys.clear();
+        items.clear();
+    }
+    if (type == Type::Text) text.clear();
+    type = to;
+}
+
+ResponseBody& ResponseBody::operator=(std::nullptr_t) {
+    reset(Type::Null);
+    return *this;
+}
+
+ResponseBody& ResponseBody::operator=(bool value) {
+    reset(Type::Boolean);
+    boolean = value;
+    return *this;
+}
+
+ResponseBody& ResponseBody::operator=(const char* value) {
+    reset(Type::Text);
+    text = value;
+    return *this;
+}
+
+ResponseBody& ResponseBody::operator=(std::string value) {
+    reset(Type::Text);
+    text = std::move(value);
+    return *this;
+}
+
+ResponseBody& ResponseBody::operator[](const std::string& key) {
+    if (type != Type::Object) reset(Type::Object);
+    // Routes set a handful of members per object, so a scan beats hashing
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] == key) return items[i];
+    }
+    keys.push_back(key);
+    items.emplace_back();
+    return items.back();
+}
+
+ResponseBody& ResponseBody::operator[](size_t index) {
+    if (type != Type::List) reset(Type::List);
+    if (index >= items.size()) items.resize(index + 1);
+    return items[index];
+}
+
+std::string ResponseBody::dump() const {
+    std::string out;
+    dump(out);
+    return out;
+}
+
+void ResponseBody::dump(std::string& out) const {
+    switch (type) {
+        case Type::Null: out += "null"; break;
+        case Type::Boolean: out += boolean ? "true" : "false"; break;
+        case Type::Integer: out += std::to_string(integer); break;
+        case Type::Real: {
+            if (!std::isfinite(real)) {
+                out += "null";
+                break;
+            }
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.17g", real);
+            out += buffer;
+            break;
+        }
+        case Type::Text: appendEscaped(out, text); break;
+        case Type::List:
+            out.push_back('[');
+            for (size_t i = 0; i < items.size(); i++) {
+                if (i) out.push_back(',');
+                items[i].dump(out);
+            }
+            out.push_back(']');
+            break;
+        case Type::Object:
+            out.push_back('{');
+            for (size_t i = 0; i < items.size(); i++) {
+                if (i) out.push_back(',');
+                appendEscaped(out, keys[i]);
+                out.push_back(':');
+                items[i].dump(out);
+            }
+            out.push_back('}');
+            break;
+    }
+}
+
+void ResponseBody::encode(BinaryFormat format, std::string& out) const {
+    BinaryEncoding::encode(*this, format, out);
+}
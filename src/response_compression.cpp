@@ -0,0 +1,293 @@
+#include "response_compression.h"
+#include <brotli/encode.h>
+#include <zlib.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+ResponseCompressor* ResponseCompressor::instance = nullptr;
+
+ResponseCompressor& ResponseCompressor::getInstance() {
+    if (!instance) {
+        instance = new ResponseCompressor();
+    }
+    return *instance;
+}
+
+static std::string trim(const std::string& value) {
+    size_t start = value.find_first_not_of(" \t");
+    if (start == std::string::npos) return "";
+    size_t end = value.find_last_not_of(" \t");
+    return value.substr(start, end - start + 1);
+}
+
+// q-values the header gives gzip and brotli, after the wildcard fills in
+// whichever it did not name.
+static void codingQualities(const std::string& acceptEncoding, double& gzipQ, double& brotliQ) {
+    // -1 until the header mentions the coding, so an explicit q=0 is a refusal
+    // the wildcard cannot override
+    double wildcardQ = -1;
+    gzipQ = -1;
+    brotliQ = -1;
+    size_t start = 0;
+    while (start <= acceptEncoding.size()) {
+        size_t comma = acceptEncoding.find(',', start);
+        if (comma == std::string::npos) comma = acceptEncoding.size();
+        std::string item = acceptEncoding.substr(start, comma - start);
+        start = comma + 1;
+
+        double q = 1;
+        size_t semicolon = item.find(';');
+        if (semicolon != std::string::npos) {
+            size_t qAt = item.find("q=", semicolon);
+            if (qAt != std::string::npos) q = std::atof(item.c_str() + qAt + 2);
+            item = item.substr(0, semicolon);
+        }
+        item = trim(item);
+        if (item == "gzip" || item == "x-gzip") gzipQ = q;
+        else if (item == "br") brotliQ = q;
+        else if (item == "*") wildcardQ = q;
+    }
+    if (gzipQ < 0) gzipQ = wildcardQ;
+    if (brotliQ < 0) brotliQ = wildcardQ;
+}
+
+ContentCoding ResponseCompressor::negotiate(const std::string& acceptEncoding) {
+    double gzipQ, brotliQ;
+    codingQualities(acceptEncoding, gzipQ, brotliQ);
+    if (brotliQ > 0 && brotliQ >= gzipQ) return ContentCoding::Brotli;
+    if (gzipQ > 0) return ContentCoding::Gzip;
+    return ContentCoding::Identity;
+}
+
+bool ResponseCompressor::accepts(const std::string& acceptEncoding, ContentCoding coding) {
+    if (coding == ContentCoding::Identity) return true;
+    double gzipQ, brotliQ;
+    codingQualities(acceptEncoding, gzipQ, brotliQ);
+    return (coding == ContentCoding::Gzip ? gzipQ : brotliQ) > 0;
+}
+
+const char* ResponseCompressor::codingName(ContentCoding coding) {
+    switch (coding) {
+        case ContentCoding::Gzip: return "gzip";
+        case ContentCoding::Brotli: return "br";
+        default: return "identity";
+    }
+}
+
+bool ResponseCompressor::isCompressible(const std::string& contentType) {
+    if (contentType.rfind("text/event-stream", 0) == 0) return false;
+    return contentType.rfind("text/", 0) == 0 ||
+           contentType.rfind("application/json", 0) == 0 ||
+           contentType.rfind("application/msgpack", 0) == 0 ||
+           contentType.rfind("application/cbor", 0) == 0 ||
+           contentType.rfind("application/javascript", 0) == 0 ||
+           contentType.rfind("image/svg+xml", 0) == 0;
+}
+
+std::string ResponseCompressor::etag(const std::string& contentType, const std::string& body) {
+    // FNV-1a, so the tag survives restarts while the data stays the same
+    uint64_t hash = 1469598103934665603ULL;
+    for (const std::string* part : {&contentType, &body}) {
+        for (unsigned char c : *part) {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        hash = (hash ^ 0xff) * 1099511628211ULL;
+    }
+    char tag[24];
+    std::snprintf(tag, sizeof(tag), "\"%016llx\"", static_cast<unsigned long long>(hash));
+    return tag;
+}
+
+bool ResponseCompressor::etagMatches(const std::string& ifNoneMatch, const std::string& etag) {
+    if (ifNoneMatch.empty()) return false;
+    if (trim(ifNoneMatch) == "*") return true;
+
+    // "<hash>" matches "<hash>", W/"<hash>" and the coded "<hash>-gzip" / "<hash>-br"
+    std::string bare = etag.substr(1, etag.size() - 2);
+    size_t start = 0;
+    while (start < ifNoneMatch.size()) {
+        size_t comma = ifNoneMatch.find(',', start);
+        if (comma == std::string::npos) comma = ifNoneMatch.size();
+        std::string candidate = trim(ifNoneMatch.substr(start, comma - start));
+        start = comma + 1;
+
+        if (candidate.rfind("W/", 0) == 0) candidate = candidate.substr(2);
+        if (candidate.size() < 2 || candidate.front() != '"' || candidate.back() != '"') continue;
+        candidate = candidate.substr(1, candidate.size() - 2);
+        if (candidate == bare || candidate == bare + "-gzip" || candidate == bare + "-br") return true;
+    }
+    return false;
+}
+
+void ResponseCompressor::configure(const CompressionSettings& newSettings) {
+    std::lock_guard<std::mutex> lock(mutex);
+    settings = newSettings;
+    // cached bytes were produced at the old levels
+    lru.clear();
+    cache.clear();
+    cachedBytes = 0;
+}
+
+CompressionSettings ResponseCompressor::getSettings() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return settings;
+}
+
+void ResponseCompressor::start() {
+    size_t threadCount = getSettings().threads;
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (running || threadCount == 0) return;
+    running = true;
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ResponseCompressor::workerLoop, this);
+    }
+}
+
+void ResponseCompressor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (!running) return;
+        running = false;
+    }
+    taskReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+bool ResponseCompressor::willCompress(const std::string& acceptEncoding, const std::string& contentType,
+                                      size_t bytes) {
+    return bytes >= getSettings().minBytes && isCompressible(contentType) &&
+           negotiate(acceptEncoding) != ContentCoding::Identity;
+}
+
+void ResponseCompressor::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (running) {
+            tasks.push_back(std::move(task));
+            taskReady.notify_one();
+            return;
+        }
+    }
+    task();
+}
+
+void ResponseCompressor::workerLoop() {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    while (true) {
+        taskReady.wait(lock, [this]{ return !running || !tasks.empty(); });
+        // Drain what is queued before exiting so no response is left open.
+        if (tasks.empty()) return;
+
+        auto task = std::move(tasks.front());
+        tasks.pop_front();
+        lock.unlock();
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Compression task failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
+
+std::shared_ptr<const std::string> ResponseCompressor::cached(const std::string& key) {
+    auto it = cache.find(key);
+    if (it == cache.end()) return nullptr;
+    lru.splice(lru.begin(), lru, it->second);
+    return it->second->bytes;
+}
+
+void ResponseCompressor::remember(const std::string& key, const std::shared_ptr<const std::string>& bytes) {
+    if (bytes->size() > settings.cacheBytes || cache.count(key)) return;
+    lru.push_front({key, bytes});
+    cache[key] = lru.begin();
+    cachedBytes += bytes->size();
+    while (cachedBytes > settings.cacheBytes) {
+        cachedBytes -= lru.back().bytes->size();
+        cache.erase(lru.back().key);
+        lru.pop_back();
+    }
+}
+
+static bool gzipCompress(const std::string& body, int level, std::string& out) {
+    z_stream stream{};
+    // 15 window bits + 16 asks zlib for a gzip header and trailer
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    out.resize(deflateBound(&stream, body.size()));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+    stream.avail_in = static_cast<uInt>(body.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    stream.avail_out = static_cast<uInt>(out.size());
+    int result = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END;
+}
+
+static bool brotliCompress(const std::string& body, int quality, std::string& out) {
+    size_t size = BrotliEncoderMaxCompressedSize(body.size());
+    if (size == 0) return false;
+    out.resize(size);
+    if (!BrotliEncoderCompress(quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, body.size(),
+                               reinterpret_cast<const uint8_t*>(body.data()), &size,
+                               reinterpret_cast<uint8_t*>(&out[0]))) {
+        return false;
+    }
+    out.resize(size);
+    return true;
+}
+
+std::shared_ptr<const std::string> ResponseCompressor::compress(const std::string& body, ContentCoding coding,
+                                                                const std::string& etag) {
+    if (coding == ContentCoding::Identity) return nullptr;
+
+    std::string key = etag.empty() ? "" : etag + codingName(coding);
+    CompressionSettings current;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!key.empty()) {
+            if (auto hit = cached(key)) {
+                cacheHits++;
+                bytesIn += body.size();
+                bytesOut += hit->size();
+                return hit;
+            }
+        }
+        current = settings;
+    }
+
+    // compression runs outside the lock; two requests racing on the same
+    // ETag both compress and the second insert is dropped
+    auto out = std::make_shared<std::string>();
+    bool ok = coding == ContentCoding::Gzip ? gzipCompress(body, current.gzipLevel, *out)
+                                            : brotliCompress(body, current.brotliQuality, *out);
+    if (!ok) {
+        std::cerr << "Failed to " << codingName(coding) << "-compress a " << body.size() << " byte response" << std::endl;
+        return nullptr;
+    }
+    if (out->size() >= body.size()) return nullptr;
+
+    std::shared_ptr<const std::string> result = std::move(out);
+    std::lock_guard<std::mutex> lock(mutex);
+    compressedCount++;
+    bytesIn += body.size();
+    bytesOut += result->size();
+    if (!key.empty()) remember(key, result);
+    return result;
+}
+
+CompressionMetrics ResponseCompressor::metrics() {
+    size_t queued;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        queued = tasks.size();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    return {compressedCount, cacheHits, bytesIn, bytesOut, cache.size(), cachedBytes, queued};
+}
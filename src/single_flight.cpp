@@ -0,0 +1,73 @@
+#include "single_flight.h"
+
+SingleFlight* SingleFlight::instance = nullptr;
+
+SingleFlight& SingleFlight::getInstance() {
+    if (!instance) {
+        instance = new SingleFlight();
+    }
+    return *instance;
+}
+
+std::shared_ptr<const std::string> SingleFlight::run(const std::string& key,
+                                                     const std::function<std::string()>& compute) {
+    std::shared_ptr<Call> call;
+    bool leader = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = calls.find(key);
+        if (it == calls.end()) {
+            call = std::make_shared<Call>();
+            calls.emplace(key, call);
+            leader = true;
+            executed++;
+        } else {
+            call = it->second;
+            coalesced++;
+        }
+    }
+
+    if (!leader) {
+        std::unique_lock<std::mutex> lock(call->mutex);
+        call->landed.wait(lock, [&call]{ return call->done; });
+        if (call->error) {
+            std::rethrow_exception(call->error);
+        }
+        return call->result;
+    }
+
+    std::shared_ptr<const std::string> result;
+    std::exception_ptr error;
+    try {
+        result = std::make_shared<const std::string>(compute());
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls.erase(key);
+    }
+    {
+        std::lock_guard<std::mutex> lock(call->mutex);
+        call->result = result;
+        call->error = error;
+        call->done = true;
+    }
+    call->landed.notify_all();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return result;
+}
+
+uint64_t SingleFlight::executedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return executed;
+}
+
+uint64_t SingleFlight::coalescedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return coalesced;
+}
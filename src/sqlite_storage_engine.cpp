@@ -0,0 +1,168 @@
+#include "sqlite_storage_engine.h"
+#include <array>
+#include <stdexcept>
+
+namespace {
+
+using table::concat;
+using table::FixedString;
+
+// Every call runs one descriptor statement on the borrowed connection. The
+// per-column lookups are generated at compile time like the entity queries,
+// one statement text per column, and picked by column position.
+template <typename TableT>
+class SqliteRepository : public Repository<TableT> {
+public:
+    using Row = typename TableT::Row;
+
+private:
+    sqlite3* db;
+
+    static constexpr auto keyName = TableT::template ColumnAt<0>::name;
+
+    static constexpr auto allSql = TableT::template select<concat(FixedString(" ORDER BY "), keyName,
+                                                                  FixedString(";"))>;
+    static constexpr auto countSql = concat(FixedString("SELECT COUNT(*) FROM "), TableT::name, FixedString(";"));
+
+    template <size_t I>
+    static constexpr auto equalSql = TableT::template select<concat(
+        FixedString(" WHERE "), TableT::template ColumnAt<I>::name, FixedString(" = ? ORDER BY "), keyName,
+        FixedString(";"))>;
+    template <size_t I>
+    static constexpr auto rangeSql = TableT::template select<concat(
+        FixedString(" WHERE "), TableT::template ColumnAt<I>::name, FixedString(" BETWEEN ? AND ? ORDER BY "),
+        TableT::template ColumnAt<I>::name, FixedString(", "), keyName, FixedString(";"))>;
+
+    template <size_t... I>
+    static constexpr std::array<const char*, TableT::columnCount> equalSqlByColumn(std::index_sequence<I...>) {
+        return {equalSql<I>.c_str()...};
+    }
+    template <size_t... I>
+    static constexpr std::array<const char*, TableT::columnCount> rangeSqlByColumn(std::index_sequence<I...>) {
+        return {rangeSql<I>.c_str()...};
+    }
+    static constexpr auto equalSqlFor = equalSqlByColumn(std::make_index_sequence<TableT::columnCount>());
+    static constexpr auto rangeSqlFor = rangeSqlByColumn(std::make_index_sequence<TableT::columnCount>());
+
+    template <typename V>
+    static void checkType(int column) {
+        if (!TableT::template columnHasType<V>(column)) {
+            throw std::invalid_argument("Column type mismatch in " + std::string(TableT::name.view()));
+        }
+    }
+
+    template <typename... V>
+    std::vector<Row> query(const char* sql, const V&... values) {
+        table::Statement stmt(db, sql);
+        stmt.bind(1, values...);
+
+        std::vector<Row> rows;
+        int rc;
+        while ((rc = sqlite3_step(stmt.get())) == SQLITE_ROW) {
+            rows.push_back(TableT::decode(stmt.get()));
+        }
+        if (rc != SQLITE_DONE) {
+            throw std::runtime_error("Failed to read " + std::string(TableT::name.view()) + ": " +
+                                     sqlite3_errmsg(db));
+        }
+        return rows;
+    }
+
+protected:
+    int insertRow(const Row& row) override {
+        if (std::get<0>(row) == 0) {
+            return std::apply([this](int, const auto&... values) {
+                return static_cast<int>(TableT::insert(db, values...));
+            }, row);
+        }
+        std::apply([this](const auto&... values) { TableT::insertWithKey(db, values...); }, row);
+        return std::get<0>(row);
+    }
+
+public:
+    explicit SqliteRepository(sqlite3* db) : db(db) {}
+
+    bool update(const Row& row) override {
+        return std::apply([this](const auto&... values) { return TableT::update(db, values...); }, row);
+    }
+
+    bool remove(int key) override {
+        return TableT::remove(db, key);
+    }
+
+    std::optional<Row> find(int key) override {
+        return TableT::findByKey(db, key);
+    }
+
+    std::vector<Row> all() override {
+        return query(allSql.c_str());
+    }
+
+    size_t count() override {
+        table::Statement stmt(db, countSql.c_str());
+        if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+            throw std::runtime_error("Failed to count " + std::string(TableT::name.view()));
+        }
+        return static_cast<size_t>(sqlite3_column_int64(stmt.get(), 0));
+    }
+
+    std::vector<Row> findEqual(int column, int value) override {
+        checkType<int>(column);
+        return query(equalSqlFor[column], value);
+    }
+
+    std::vector<Row> findEqual(int column, const std::string& value) override {
+        checkType<std::string>(column);
+        return query(equalSqlFor[column], value);
+    }
+
+    std::vector<Row> findRange(int column, const std::string& low, const std::string& high) override {
+        checkType<std::string>(column);
+        return query(rangeSqlFor[column], low, high);
+    }
+};
+
+} // namespace
+
+SqliteStorageEngine::SqliteStorageEngine(sqlite3* db)
+    : db(db),
+      userRepository(std::make_unique<SqliteRepository<UsersTable>>(db)),
+      patientRepository(std::make_unique<SqliteRepository<PatientsTable>>(db)),
+      doctorRepository(std::make_unique<SqliteRepository<DoctorsTable>>(db)),
+      appointmentRepository(std::make_unique<SqliteRepository<AppointmentsFullTable>>(db)),
+      recordRepository(std::make_unique<SqliteRepository<MedicalRecordsFullTable>>(db)),
+      prescriptionRepository(std::make_unique<SqliteRepository<PrescriptionsTable>>(db)),
+      reportRepository(std::make_unique<SqliteRepository<ReportsFullTable>>(db)) {}
+
+SqliteStorageEngine::~SqliteStorageEngine() = default;
+
+std::string SqliteStorageEngine::name() const { return "sqlite"; }
+
+UserRepository& SqliteStorageEngine::users() { return *userRepository; }
+PatientRepository& SqliteStorageEngine::patients() { return *patientRepository; }
+DoctorRepository& SqliteStorageEngine::doctors() { return *doctorRepository; }
+AppointmentRepository& SqliteStorageEngine::appointments() { return *appointmentRepository; }
+MedicalRecordRepository& SqliteStorageEngine::records() { return *recordRepository; }
+PrescriptionRepository& SqliteStorageEngine::prescriptions() { return *prescriptionRepository; }
+ReportRepository& SqliteStorageEngine::reports() { return *reportRepository; }
+
+void SqliteStorageEngine::transaction(const std::function<void()>& work) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db, "BEGIN TRANSACTION;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::string error = errMsg ? errMsg : "unknown error";
+        sqlite3_free(errMsg);
+        throw std::runtime_error("Failed to begin transaction: " + error);
+    }
+    try {
+        work();
+    } catch (...) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::string error = errMsg ? errMsg : "unknown error";
+        sqlite3_free(errMsg);
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw std::runtime_error("Failed to commit transaction: " + error);
+    }
+}
@@ -0,0 +1,213 @@
+#include "static_files.h"
+#include "response_compression.h"
+#include <brotli/encode.h>
+#include <zlib.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+StaticFiles* StaticFiles::instance = nullptr;
+
+StaticFiles& StaticFiles::getInstance() {
+    if (!instance) {
+        instance = new StaticFiles();
+    }
+    return *instance;
+}
+
+static std::string contentTypeFor(const std::string& extension) {
+    static const std::unordered_map<std::string, std::string> types = {
+        {".html", "text/html; charset=utf-8"},
+        {".js", "application/javascript"},
+        {".mjs", "application/javascript"},
+        {".css", "text/css"},
+        {".json", "application/json"},
+        {".map", "application/json"},
+        {".svg", "image/svg+xml"},
+        {".png", "image/png"},
+        {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},
+        {".gif", "image/gif"},
+        {".webp", "image/webp"},
+        {".ico", "image/x-icon"},
+        {".woff", "font/woff"},
+        {".woff2", "font/woff2"},
+        {".txt", "text/plain; charset=utf-8"},
+    };
+    auto it = types.find(extension);
+    return it == types.end() ? "application/octet-stream" : it->second;
+}
+
+static bool readFile(const fs::path& path, std::string& contents) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+static bool gzipOnce(const std::string& body, std::string& out) {
+    out.assign(compressBound(body.size()) + 32, '\0');
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+    stream.avail_in = static_cast<uInt>(body.size());
+    stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    stream.avail_out = static_cast<uInt>(out.size());
+    int result = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END && out.size() < body.size();
+}
+
+static bool brotliOnce(const std::string& body, std::string& out) {
+    size_t size = BrotliEncoderMaxCompressedSize(body.size());
+    if (size == 0) return false;
+    out.assign(size, '\0');
+    // the result is cached on disk, so the slow top quality is paid once per build
+    if (!BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, body.size(),
+                               reinterpret_cast<const uint8_t*>(body.data()), &size,
+                               reinterpret_cast<uint8_t*>(&out[0])) ||
+        size >= body.size()) {
+        return false;
+    }
+    out.resize(size);
+    return true;
+}
+
+// Written under a temporary name and renamed, so a crash never leaves a
+// truncated variant behind for the next start to serve.
+static bool writeFile(const fs::path& path, const std::string& contents) {
+    std::error_code error;
+    fs::create_directories(path.parent_path(), error);
+    fs::path partial = path;
+    partial += ".tmp";
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        if (!out || !out.write(contents.data(), contents.size())) return false;
+    }
+    fs::rename(partial, path, error);
+    if (error) {
+        fs::remove(partial, error);
+        return false;
+    }
+    return true;
+}
+
+// The cached variant of a file at its current size and mtime, compressing it
+// into the cache first if an earlier start has not already done so.
+static std::string cachedVariant(const fs::path& cacheFile, const std::string& contents,
+                                 bool (*compress)(const std::string&, std::string&)) {
+    std::error_code error;
+    if (fs::exists(cacheFile, error)) return cacheFile.string();
+
+    std::string compressed;
+    if (!compress(contents, compressed)) return "";
+    if (!writeFile(cacheFile, compressed)) {
+        std::cerr << "Failed to write " << cacheFile.string() << "; serving it uncompressed" << std::endl;
+        return "";
+    }
+    return cacheFile.string();
+}
+
+bool StaticFiles::load(const std::string& directory, const std::string& cache) {
+    files.clear();
+    std::error_code error;
+    if (!fs::is_directory(directory, error)) {
+        std::cerr << "Client bundle not found at " << directory << "; static files are disabled" << std::endl;
+        return false;
+    }
+    root = fs::canonical(directory, error).string();
+    fs::create_directories(cache, error);
+    cacheDirectory = fs::absolute(cache, error).string();
+    std::unordered_set<std::string> cacheFiles;
+
+    // Vite writes build output to assets/ with a content hash in the name
+    // (index-B3f9a1c2.js); those files never change under the same name.
+    static const std::regex hashed(R"(.+-[A-Za-z0-9_-]{8,}\.[a-z0-9]+$)");
+
+    for (auto it = fs::recursive_directory_iterator(root, error); it != fs::recursive_directory_iterator();
+         it.increment(error)) {
+        if (error) break;
+        if (!it->is_regular_file(error)) continue;
+
+        fs::path path = it->path();
+        std::string extension = path.extension().string();
+        if (extension == ".gz" || extension == ".br") continue;  // picked up as variants below
+
+        StaticFile file;
+        file.path = path.string();
+        file.contentType = contentTypeFor(extension);
+        file.size = it->file_size(error);
+        auto modified = it->last_write_time(error).time_since_epoch().count();
+        char tag[48];
+        std::snprintf(tag, sizeof(tag), "\"%jx-%llx\"", file.size, static_cast<unsigned long long>(modified));
+        file.etag = tag;
+        std::string url = "/" + fs::relative(path, root, error).generic_string();
+        file.immutable = url.rfind("/assets/", 0) == 0 && std::regex_match(path.filename().string(), hashed);
+
+        if (fs::exists(file.path + ".gz", error)) file.gzipPath = file.path + ".gz";
+        if (fs::exists(file.path + ".br", error)) file.brotliPath = file.path + ".br";
+
+        if (ResponseCompressor::isCompressible(file.contentType) && file.size >= 1024 &&
+            (file.gzipPath.empty() || file.brotliPath.empty())) {
+            // e.g. <cache>/assets/index-B3f9a1c2.js.1f2a-18c3e5d2a.gz
+            std::string stamp = url.substr(1) + "." + std::string(tag + 1, std::strlen(tag) - 2);
+            fs::path gzipFile = fs::path(cacheDirectory) / (stamp + ".gz");
+            fs::path brotliFile = fs::path(cacheDirectory) / (stamp + ".br");
+            cacheFiles.insert(gzipFile.string());
+            cacheFiles.insert(brotliFile.string());
+
+            std::string contents;
+            bool cached = (!file.gzipPath.empty() || fs::exists(gzipFile, error)) &&
+                          (!file.brotliPath.empty() || fs::exists(brotliFile, error));
+            if (cached || readFile(path, contents)) {
+                if (file.gzipPath.empty()) file.gzipPath = cachedVariant(gzipFile, contents, gzipOnce);
+                if (file.brotliPath.empty()) file.brotliPath = cachedVariant(brotliFile, contents, brotliOnce);
+            }
+        }
+
+        files[url] = std::move(file);
+    }
+
+    // variants of files that were rebuilt or removed since they were written
+    for (auto it = fs::recursive_directory_iterator(cacheDirectory, error); it != fs::recursive_directory_iterator();
+         it.increment(error)) {
+        if (error) break;
+        if (it->is_regular_file(error) && !cacheFiles.count(it->path().string())) {
+            fs::remove(it->path(), error);
+        }
+    }
+
+    std::cout << "Indexed " << files.size() << " client files from " << root << std::endl;
+    return true;
+}
+
+const StaticFile* StaticFiles::find(const std::string& urlPath) const {
+    auto it = files.find(urlPath);
+    return it == files.end() ? nullptr : &it->second;
+}
+
+const StaticFile* StaticFiles::appShell() const {
+    return find("/index.html");
+}
+
+size_t StaticFiles::fileCount() const {
+    return files.size();
+}
+
+uintmax_t StaticFiles::totalBytes() const {
+    uintmax_t total = 0;
+    for (const auto& entry : files) total += entry.second.size;
+    return total;
+}
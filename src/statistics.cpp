@@ -0,0 +1,256 @@
+#include "statistics.h"
+#include "database_handler.h"
+#include "archive_manager.h"
+#include "table_descriptor.h"
+#include <sqlite3.h>
+#include <iostream>
+#include <stdexcept>
+
+int Statistics::getAppointmentCountForPatient(int patientID) {
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+
+    std::string sql = "SELECT appointment_count FROM PatientAppointmentStats WHERE patientID = ?;";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare patient statistics statement: " +
+                               std::string(sqlite3_errmsg(db)));
+    }
+
+    sqlite3_bind_int(stmt, 1, patientID);
+
+    int count = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+std::map<int, int> Statistics::getAppointmentCountsByPatient() {
+    std::map<int, int> counts;
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+
+    std::string sql = "SELECT patientID, appointment_count FROM PatientAppointmentStats;";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare patient statistics statement: " +
+                               std::string(sqlite3_errmsg(db)));
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        counts[sqlite3_column_int(stmt, 0)] = sqlite3_column_int(stmt, 1);
+    }
+
+    sqlite3_finalize(stmt);
+    return counts;
+}
+
+std::vector<DoctorDailyCount> Statistics::getDoctorDailyCounts(int doctorID, const std::string& startDate,
+                                                               const std::string& endDate) {
+    std::vector<DoctorDailyCount> counts;
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+
+    // doctorID 0 means every doctor
+    std::string sql = doctorID == 0 ?
+        "SELECT doctorID, date, appointment_count FROM DoctorDailyAppointmentStats "
+        "WHERE date BETWEEN ? AND ? ORDER BY date, doctorID;" :
+        "SELECT doctorID, date, appointment_count FROM DoctorDailyAppointmentStats "
+        "WHERE date BETWEEN ? AND ? AND doctorID = ? ORDER BY date;";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare doctor statistics statement: " +
+                               std::string(sqlite3_errmsg(db)));
+    }
+
+    sqlite3_bind_text(stmt, 1, startDate.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, endDate.c_str(), -1, SQLITE_TRANSIENT);
+    if (doctorID != 0) {
+        sqlite3_bind_int(stmt, 3, doctorID);
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        DoctorDailyCount count;
+        count.doctorID = sqlite3_column_int(stmt, 0);
+        count.date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        count.appointmentCount = sqlite3_column_int(stmt, 2);
+        counts.push_back(count);
+    }
+
+    sqlite3_finalize(stmt);
+    return counts;
+}
+
+std::map<std::string, int> Statistics::getAppointmentStatusCounts() {
+    std::map<std::string, int> counts;
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+
+    std::string sql = "SELECT status, appointment_count FROM AppointmentStatusStats;";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare status statistics statement: " +
+                               std::string(sqlite3_errmsg(db)));
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        std::string status = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        counts[status] = sqlite3_column_int(stmt, 1);
+    }
+
+    sqlite3_finalize(stmt);
+    return counts;
+}
+
+std::map<int, int> Statistics::getRecordCountsByDoctor() {
+    std::map<int, int> counts;
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+
+    std::string sql = "SELECT doctorID, record_count FROM DoctorRecordStats WHERE record_count > 0;";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare record statistics statement: " +
+                               std::string(sqlite3_errmsg(db)));
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        counts[sqlite3_column_int(stmt, 0)] = sqlite3_column_int(stmt, 1);
+    }
+
+    sqlite3_finalize(stmt);
+    return counts;
+}
+
+int Statistics::getEntityCount(const std::string& entity) {
+    sqlite3* db = DatabaseHandler::getInstance().getDatabase();
+    sqlite3_stmt* stmt;
+
+    std::string sql = "SELECT total FROM EntityCounts WHERE entity = ?;";
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare entity count statement: " +
+                               std::string(sqlite3_errmsg(db)));
+    }
+
+    sqlite3_bind_text(stmt, 1, entity.c_str(), -1, SQLITE_TRANSIENT);
+
+    int count = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
+    }
+
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+namespace {
+
+struct ArchivedCount {
+    const char* table;
+    const char* select;     // followed by the archived rows as a FROM source
+    const char* groupBy;
+    const char* upsert;     // adds the archived count to the hot one
+};
+
+const ArchivedCount kArchivedCounts[] = {
+    {"Appointments", "SELECT patientID, COUNT(*) FROM ", " GROUP BY patientID;",
+     "INSERT INTO PatientAppointmentStats (patientID, appointment_count) VALUES (?, ?) "
+     "ON CONFLICT(patientID) DO UPDATE SET appointment_count = appointment_count + excluded.appointment_count;"},
+    {"Appointments", "SELECT doctorID, date, COUNT(*) FROM ", " GROUP BY doctorID, date;",
+     "INSERT INTO DoctorDailyAppointmentStats (doctorID, date, appointment_count) VALUES (?, ?, ?) "
+     "ON CONFLICT(doctorID, date) DO UPDATE SET appointment_count = appointment_count + excluded.appointment_count;"},
+    {"Appointments", "SELECT status, COUNT(*) FROM ", " GROUP BY status;",
+     "INSERT INTO AppointmentStatusStats (status, appointment_count) VALUES (?, ?) "
+     "ON CONFLICT(status) DO UPDATE SET appointment_count = appointment_count + excluded.appointment_count;"},
+    {"MedicalRecords", "SELECT doctorID, COUNT(*) FROM ", " GROUP BY doctorID;",
+     "INSERT INTO DoctorRecordStats (doctorID, record_count) VALUES (?, ?) "
+     "ON CONFLICT(doctorID) DO UPDATE SET record_count = record_count + excluded.record_count;"},
+};
+
+// Adds the archived rows to the aggregates written on conn, which must hold
+// the write lock so no rows move while the archive years are read. They are
+// read through separate connections, a connection's worth of attached years
+// at a time, since nothing can be attached inside a transaction.
+void addArchivedCounts(sqlite3* conn) {
+    ArchiveManager& archive = ArchiveManager::getInstance();
+    std::vector<int> years = archive.allYears();
+
+    while (!years.empty()) {
+        sqlite3* reader = DatabaseHandler::getInstance().openReadOnlyConnection();
+        try {
+            std::vector<int> attached = archive.attach(reader, years);
+            for (const auto& count : kArchivedCounts) {
+                std::string sql = count.select + ArchiveManager::archivedSource(count.table, attached) + count.groupBy;
+                table::Statement read(reader, sql.c_str());
+                table::Statement upsert(conn, count.upsert);
+                while (sqlite3_step(read.get()) == SQLITE_ROW) {
+                    for (int i = 0; i < sqlite3_column_count(read.get()); i++) {
+                        sqlite3_bind_value(upsert.get(), i + 1, sqlite3_column_value(read.get(), i));
+                    }
+                    upsert.run(conn);
+                    sqlite3_reset(upsert.get());
+                }
+            }
+            years.erase(years.begin(), years.begin() + attached.size());
+        } catch (...) {
+            sqlite3_close(reader);
+            throw;
+        }
+        sqlite3_close(reader);
+    }
+}
+
+} // namespace
+
+void Statistics::rebuild() {
+    // Runs on a connection of its own so the archive years can be read
+    // alongside; BEGIN IMMEDIATE keeps rows from moving meanwhile.
+    sqlite3* conn = DatabaseHandler::getInstance().openWriteConnection();
+    auto run = [conn](const std::string& sql) {
+        char* errMsg = nullptr;
+        if (sqlite3_exec(conn, sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+            std::string error = "SQL error: " + std::string(errMsg ? errMsg : sqlite3_errmsg(conn));
+            sqlite3_free(errMsg);
+            throw std::runtime_error(error);
+        }
+    };
+
+    try {
+        run("BEGIN IMMEDIATE;");
+        run("DELETE FROM PatientAppointmentStats;");
+        run("DELETE FROM DoctorDailyAppointmentStats;");
+        run("DELETE FROM AppointmentStatusStats;");
+        run("DELETE FROM DoctorRecordStats;");
+        run("DELETE FROM EntityCounts;");
+
+        run("INSERT INTO PatientAppointmentStats (patientID, appointment_count) "
+            "SELECT patientID, COUNT(*) FROM Appointments GROUP BY patientID;");
+        run("INSERT INTO DoctorDailyAppointmentStats (doctorID, date, appointment_count) "
+            "SELECT doctorID, date, COUNT(*) FROM Appointments GROUP BY doctorID, date;");
+        run("INSERT INTO AppointmentStatusStats (status, appointment_count) "
+            "SELECT status, COUNT(*) FROM Appointments GROUP BY status;");
+        run("INSERT INTO DoctorRecordStats (doctorID, record_count) "
+            "SELECT doctorID, COUNT(*) FROM MedicalRecords GROUP BY doctorID;");
+        run("INSERT INTO EntityCounts (entity, total) "
+            "SELECT 'patients', COUNT(*) FROM Patients "
+            "UNION ALL SELECT 'doctors', COUNT(*) FROM Doctors;");
+
+        // archived rows still count
+        addArchivedCounts(conn);
+
+        run("COMMIT;");
+        DatabaseHandler::getInstance().recordExternalChanges(sqlite3_total_changes64(conn));
+    } catch (const std::exception& e) {
+        if (!sqlite3_get_autocommit(conn)) {
+            sqlite3_exec(conn, "ROLLBACK;", nullptr, nullptr, nullptr);
+        }
+        sqlite3_close(conn);
+        std::cerr << "Error rebuilding statistics: " << e.what() << std::endl;
+        throw;
+    }
+    sqlite3_close(conn);
+}
@@ -0,0 +1,206 @@
+#include "storage_benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+namespace {
+
+constexpr int kDays = 336;
+const char* const kSpecializations[] = {"Cardiology", "Neurology", "Pediatrics", "Orthopedics", "Dermatology"};
+const char* const kMedicines[] = {"Amoxicillin", "Ibuprofen", "Metformin", "Lisinopril", "Atorvastatin"};
+const char* const kStatuses[] = {"scheduled", "completed", "cancelled"};
+
+// Day 0 is 2025-01-01; months are cut to 28 days so every date is valid.
+std::string dateFor(int day) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "2025-%02d-%02d", (day / 28) % 12 + 1, day % 28 + 1);
+    return buffer;
+}
+
+std::string timeFor(int slot) {
+    char buffer[8];
+    std::snprintf(buffer, sizeof(buffer), "%02d:%02d", 9 + (slot % 16) / 2, (slot % 2) * 30);
+    return buffer;
+}
+
+template <typename Work>
+StoragePhaseResult timed(const std::string& phase, int operations, Work work) {
+    auto start = std::chrono::steady_clock::now();
+    size_t rows = work();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return {phase, operations, rows, elapsed.count()};
+}
+
+} // namespace
+
+StorageBenchmarkResult StorageBenchmark::run(StorageEngine& engine, const StorageWorkload& workload) {
+    StorageBenchmarkResult result;
+    result.engine = engine.name();
+
+    std::mt19937 rng(workload.seed);
+    auto pick = [&rng](const std::vector<int>& ids) {
+        return ids[std::uniform_int_distribution<size_t>(0, ids.size() - 1)(rng)];
+    };
+    auto anyDay = [&rng] { return std::uniform_int_distribution<int>(0, kDays - 1)(rng); };
+
+    std::vector<int> doctorIDs;
+    std::vector<int> patientIDs;
+    std::vector<int> appointmentIDs;
+
+    int loadRows = 2 * (workload.doctors + workload.patients) + workload.appointments + workload.records +
+                   workload.prescriptions;
+    result.phases.push_back(timed("bulk load", loadRows, [&] {
+        engine.transaction([&] {
+            // patient and doctor IDs are their user IDs, as in the entity classes
+            for (int i = 0; i < workload.doctors; i++) {
+                int userID = engine.users().insert({0, "Doctor " + std::to_string(i), "555-01" + std::to_string(i),
+                                                    "doctor"});
+                engine.doctors().insert({userID, userID, kSpecializations[i % 5]});
+                doctorIDs.push_back(userID);
+            }
+            for (int i = 0; i < workload.patients; i++) {
+                int userID = engine.users().insert({0, "Patient " + std::to_string(i),
+                                                    "555-02" + std::to_string(i), "patient"});
+                engine.patients().insert({userID, userID, 18 + i % 70, i % 2 ? "F" : "M"});
+                patientIDs.push_back(userID);
+            }
+            for (int i = 0; i < workload.appointments; i++) {
+                appointmentIDs.push_back(engine.appointments().insert(
+                    {0, pick(patientIDs), pick(doctorIDs), dateFor(anyDay()), timeFor(i), kStatuses[i % 3],
+                     "Visit " + std::to_string(i), ""}));
+            }
+            for (int i = 0; i < workload.records; i++) {
+                engine.records().insert({0, pick(patientIDs), pick(doctorIDs), "Diagnosis " + std::to_string(i),
+                                         "Treatment " + std::to_string(i), dateFor(anyDay()), ""});
+            }
+            for (int i = 0; i < workload.prescriptions; i++) {
+                engine.prescriptions().insert({0, pick(doctorIDs), pick(patientIDs), kMedicines[i % 5],
+                                               "1 tablet daily", dateFor(anyDay())});
+            }
+        });
+        return static_cast<size_t>(loadRows);
+    }));
+
+    result.phases.push_back(timed("appointment by key", workload.lookups, [&] {
+        size_t rows = 0;
+        for (int i = 0; i < workload.lookups; i++) {
+            rows += engine.appointments().find(pick(appointmentIDs)).has_value();
+        }
+        return rows;
+    }));
+
+    result.phases.push_back(timed("appointments by patient", workload.lookups, [&] {
+        size_t rows = 0;
+        for (int i = 0; i < workload.lookups; i++) {
+            rows += engine.appointments().where<"patientID">(pick(patientIDs)).size();
+        }
+        return rows;
+    }));
+
+    result.phases.push_back(timed("records by doctor", workload.lookups / 10, [&] {
+        size_t rows = 0;
+        for (int i = 0; i < workload.lookups / 10; i++) {
+            rows += engine.records().where<"doctorID">(pick(doctorIDs)).size();
+        }
+        return rows;
+    }));
+
+    result.phases.push_back(timed("appointments in a week", workload.lookups / 10, [&] {
+        size_t rows = 0;
+        for (int i = 0; i < workload.lookups / 10; i++) {
+            int day = anyDay();
+            rows += engine.appointments().between<"date">(dateFor(day), dateFor(day + 6)).size();
+        }
+        return rows;
+    }));
+
+    std::vector<int> inserted;
+    result.phases.push_back(timed("insert appointment", workload.writes, [&] {
+        for (int i = 0; i < workload.writes; i++) {
+            inserted.push_back(engine.appointments().insert(
+                {0, pick(patientIDs), pick(doctorIDs), dateFor(anyDay()), timeFor(i), "", "", ""}));
+        }
+        return inserted.size();
+    }));
+
+    result.phases.push_back(timed("reschedule appointment", workload.writes, [&] {
+        size_t rows = 0;
+        for (int i = 0; i < workload.writes; i++) {
+            auto row = engine.appointments().find(pick(appointmentIDs));
+            if (!row) continue;
+            std::get<3>(*row) = dateFor(anyDay());
+            rows += engine.appointments().update(*row);
+        }
+        return rows;
+    }));
+
+    result.phases.push_back(timed("cancelled appointments", workload.lookups / 100, [&] {
+        size_t rows = 0;
+        for (int i = 0; i < workload.lookups / 100; i++) {
+            rows += engine.appointments().where<"status">(std::string("cancelled")).size();
+        }
+        return rows;
+    }));
+
+    result.phases.push_back(timed("remove appointment", static_cast<int>(inserted.size()), [&] {
+        size_t rows = 0;
+        for (int id : inserted) {
+            rows += engine.appointments().remove(id);
+        }
+        return rows;
+    }));
+
+    int threads = std::max(1, workload.readerThreads);
+    int perThread = workload.lookups / threads;
+    result.phases.push_back(timed("concurrent reads (" + std::to_string(threads) + " threads)",
+                                  perThread * threads, [&] {
+        std::vector<size_t> rows(threads, 0);
+        std::vector<std::thread> readers;
+        for (int t = 0; t < threads; t++) {
+            readers.emplace_back([&, t] {
+                std::mt19937 local(workload.seed + 1 + t);
+                auto localPick = [&local](const std::vector<int>& ids) {
+                    return ids[std::uniform_int_distribution<size_t>(0, ids.size() - 1)(local)];
+                };
+                for (int i = 0; i < perThread; i++) {
+                    if (i % 2) {
+                        rows[t] += engine.appointments().where<"patientID">(localPick(patientIDs)).size();
+                    } else {
+                        rows[t] += engine.appointments().find(localPick(appointmentIDs)).has_value();
+                    }
+                }
+            });
+        }
+        for (auto& reader : readers) reader.join();
+
+        size_t total = 0;
+        for (size_t count : rows) total += count;
+        return total;
+    }));
+
+    return result;
+}
+
+void StorageBenchmark::print(std::ostream& out, const std::vector<StorageBenchmarkResult>& results) {
+    if (results.empty()) return;
+
+    out << std::left << std::setw(34) << "phase" << std::right << std::setw(8) << "ops";
+    for (const auto& result : results) {
+        out << std::setw(16) << (result.engine + " ops/s") << std::setw(10) << "rows";
+    }
+    out << '\n';
+
+    for (size_t i = 0; i < results[0].phases.size(); i++) {
+        const StoragePhaseResult& phase = results[0].phases[i];
+        out << std::left << std::setw(34) << phase.phase << std::right << std::setw(8) << phase.operations;
+        for (const auto& result : results) {
+            const StoragePhaseResult& measured = result.phases[i];
+            double rate = measured.seconds > 0 ? measured.operations / measured.seconds : 0;
+            out << std::setw(16) << std::fixed << std::setprecision(0) << rate << std::setw(10) << measured.rows;
+        }
+        out << '\n';
+    }
+}
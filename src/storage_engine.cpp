@@ -0,0 +1,30 @@
+#include "storage_engine.h"
+#include <ctime>
+
+std::string currentTimestamp() {
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    gmtime_r(&now, &utc);
+    char buffer[20];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &utc);
+    return buffer;
+}
+
+template <typename TableT>
+static void copyRows(Repository<TableT>& from, Repository<TableT>& to) {
+    for (const auto& row : from.all()) {
+        to.insert(row);
+    }
+}
+
+void StorageEngine::copyFrom(StorageEngine& source) {
+    transaction([&] {
+        copyRows(source.users(), users());
+        copyRows(source.patients(), patients());
+        copyRows(source.doctors(), doctors());
+        copyRows(source.appointments(), appointments());
+        copyRows(source.records(), records());
+        copyRows(source.prescriptions(), prescriptions());
+        copyRows(source.reports(), reports());
+    });
+}
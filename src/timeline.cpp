@@ -0,0 +1,222 @@
+#include "timeline.h"
+#include "database_handler.h"
+#include "archive_manager.h"
+#include <sqlite3.h>
+#include <climits>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+
+struct TimelineSource {
+    const char* type;
+    int rank;
+    const char* select;
+    const char* table;      // read together with its archive years when the page reaches them
+    const char* rest;
+};
+
+// ?1 patient, ?2 cursor date, ?3 id bound on the cursor date, ?4 row limit
+const TimelineSource kSources[] = {
+    {"appointment", 0,
+     "SELECT a.appointmentID, a.date, a.doctorID, u.name, a.time, a.status FROM ", "Appointments",
+     " a JOIN Doctors d ON a.doctorID = d.doctorID JOIN Users u ON d.userID = u.userID "
+     "WHERE a.patientID = ?1 AND (a.date < ?2 OR (a.date = ?2 AND a.appointmentID < ?3)) "
+     "ORDER BY a.date DESC, a.appointmentID DESC LIMIT ?4;"},
+    {"record", 1,
+     "SELECT m.recordID, m.date, m.doctorID, u.name, m.diagnosis, m.treatment FROM ", "MedicalRecords",
+     " m JOIN Doctors d ON m.doctorID = d.doctorID JOIN Users u ON d.userID = u.userID "
+     "WHERE m.patientID = ?1 AND (m.date < ?2 OR (m.date = ?2 AND m.recordID < ?3)) "
+     "ORDER BY m.date DESC, m.recordID DESC LIMIT ?4;"},
+    {"prescription", 2,
+     "SELECT r.prescriptionID, r.date, r.doctorID, u.name, r.medicine, r.dosage FROM ", "Prescriptions",
+     " r JOIN Doctors d ON r.doctorID = d.doctorID JOIN Users u ON d.userID = u.userID "
+     "WHERE r.patientID = ?1 AND (r.date < ?2 OR (r.date = ?2 AND r.prescriptionID < ?3)) "
+     "ORDER BY r.date DESC, r.prescriptionID DESC LIMIT ?4;"},
+};
+
+struct Stream {
+    const TimelineSource* source;
+    sqlite3_stmt* stmt;
+    TimelineEvent head;
+    bool valid;
+
+    void advance() {
+        valid = sqlite3_step(stmt) == SQLITE_ROW;
+        if (!valid) return;
+        head.type = source->type;
+        head.id = sqlite3_column_int(stmt, 0);
+        head.date = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        head.doctorID = sqlite3_column_int(stmt, 2);
+        head.doctorName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        head.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+        const unsigned char* detail = sqlite3_column_text(stmt, 5);
+        head.detail = detail ? reinterpret_cast<const char*>(detail) : "";
+    }
+};
+
+// true when a sorts after b in timeline order
+struct LaterInTimeline {
+    bool operator()(const Stream* a, const Stream* b) const {
+        if (a->head.date != b->head.date) return a->head.date < b->head.date;
+        if (a->source->rank != b->source->rank) return a->source->rank > b->source->rank;
+        return a->head.id < b->head.id;
+    }
+};
+
+// Closes the private read connection, ending its read transaction.
+struct ConnectionCloser {
+    void operator()(sqlite3* conn) const {
+        sqlite3_exec(conn, "COMMIT;", nullptr, nullptr, nullptr);
+        sqlite3_close(conn);
+    }
+};
+
+} // namespace
+
+std::string TimelineCursor::encode() const {
+    return date + "|" + std::to_string(typeRank) + "|" + std::to_string(id);
+}
+
+bool TimelineCursor::decode(const std::string& text, TimelineCursor& cursor) {
+    size_t first = text.find('|');
+    size_t second = text.find('|', first == std::string::npos ? first : first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+        return false;
+    }
+    try {
+        cursor.date = text.substr(0, first);
+        cursor.typeRank = std::stoi(text.substr(first + 1, second - first - 1));
+        cursor.id = std::stoi(text.substr(second + 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return cursor.typeRank >= 0 && cursor.typeRank <= 2;
+}
+
+namespace {
+
+// Merges one page of the three sources on conn, reading the archived tables
+// through archive when given. Returns true when rows remain after the page.
+bool mergePage(sqlite3* conn, const ArchiveScope* archive, int patientID, const TimelineCursor* after, int limit,
+               std::vector<TimelineEvent>& events) {
+    events.clear();
+
+    std::vector<Stream> streams;
+    streams.reserve(sizeof(kSources) / sizeof(kSources[0]));
+    auto finalizeAll = [&streams]() {
+        for (auto& stream : streams) sqlite3_finalize(stream.stmt);
+    };
+
+    for (const auto& source : kSources) {
+        std::string sql = std::string(source.select) + (archive ? archive->source(source.table) : source.table) +
+                          source.rest;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::string error = sqlite3_errmsg(conn);
+            finalizeAll();
+            throw std::runtime_error("Failed to prepare timeline statement: " + error);
+        }
+
+        // On the cursor's own date, sources ranked after the cursor's type
+        // still have every row ahead of them, sources ranked before it have
+        // none, and the cursor's own source resumes below the cursor id.
+        std::string date = after ? after->date : "9999-12-31~";
+        int idBound = INT_MAX;
+        if (after && source.rank == after->typeRank) idBound = after->id;
+        if (after && source.rank < after->typeRank) idBound = INT_MIN;
+
+        sqlite3_bind_int(stmt, 1, patientID);
+        sqlite3_bind_text(stmt, 2, date.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, idBound);
+        sqlite3_bind_int(stmt, 4, limit + 1);
+        streams.push_back(Stream{&source, stmt, TimelineEvent(), false});
+    }
+
+    std::priority_queue<Stream*, std::vector<Stream*>, LaterInTimeline> heads;
+    for (auto& stream : streams) {
+        stream.advance();
+        if (stream.valid) heads.push(&stream);
+    }
+
+    while (!heads.empty() && static_cast<int>(events.size()) < limit) {
+        Stream* stream = heads.top();
+        heads.pop();
+        events.push_back(stream->head);
+        stream->advance();
+        if (stream->valid) heads.push(stream);
+    }
+
+    bool more = !heads.empty();
+    finalizeAll();
+    return more;
+}
+
+TimelineCursor cursorAfter(const TimelineEvent& last) {
+    int rank = last.type == "appointment" ? 0 : last.type == "record" ? 1 : 2;
+    return TimelineCursor{last.date, rank, last.id};
+}
+
+} // namespace
+
+bool PatientTimeline::getPage(int patientID, const TimelineCursor* after, int limit,
+                              std::vector<TimelineEvent>& events, std::string& nextCursor) {
+    events.clear();
+    nextCursor.clear();
+
+    std::unique_ptr<sqlite3, ConnectionCloser> conn(DatabaseHandler::getInstance().openReadOnlyConnection());
+    if (sqlite3_exec(conn.get(), "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to begin timeline transaction: " + std::string(sqlite3_errmsg(conn.get())));
+    }
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(conn.get(), "SELECT 1 FROM Patients WHERE patientID = ?;", -1, &stmt, nullptr) != SQLITE_OK) {
+        throw std::runtime_error("Failed to prepare patient lookup: " + std::string(sqlite3_errmsg(conn.get())));
+    }
+    sqlite3_bind_int(stmt, 1, patientID);
+    bool exists = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+    if (!exists) {
+        return false;
+    }
+
+    // Pages are read from the hot tables first; the archive is only
+    // attached when a page starts before the archive horizon or runs past it.
+    std::string startDate = after ? after->date : "9999-12-31~";
+    ArchiveManager& archives = ArchiveManager::getInstance();
+    std::string horizon = archives.archivedBefore();
+    std::vector<int> years = archives.yearsFor("0000-01-01", startDate);
+
+    bool more = false;
+    bool hotOnly = years.empty() || startDate >= horizon;
+    if (hotOnly) {
+        more = mergePage(conn.get(), nullptr, patientID, after, limit, events);
+        hotOnly = years.empty() ||
+                  (static_cast<int>(events.size()) == limit && more && events.back().date >= horizon);
+    }
+    conn.reset();
+
+    if (!hotOnly) {
+        ArchiveScope archive("0000-01-01", startDate);
+        if (sqlite3_exec(archive.connection(), "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            throw std::runtime_error("Failed to begin timeline transaction: " +
+                                     std::string(sqlite3_errmsg(archive.connection())));
+        }
+        more = mergePage(archive.connection(), &archive, patientID, after, limit, events);
+        sqlite3_exec(archive.connection(), "COMMIT;", nullptr, nullptr, nullptr);
+
+        // older years than one connection can attach are left to later pages
+        if (!more && !archive.complete()) {
+            nextCursor = events.empty()
+                ? TimelineCursor{std::to_string(archive.oldestYear()) + "-01-01", 2, INT_MIN}.encode()
+                : cursorAfter(events.back()).encode();
+            return true;
+        }
+    }
+
+    if (more && !events.empty()) {
+        nextCursor = cursorAfter(events.back()).encode();
+    }
+    return true;
+}
@@ -1,5 +1,7 @@
 #include "user.h"
 #include "database_handler.h"
+#include "people_index.h"
+#include "tables.h"
 #include <sqlite3.h>
 #include <iostream>
 #include <vector>
@@ -7,63 +9,42 @@
 User::User(int id, const std::string& name, const std::string& contact, const std::string& type)
     : userID(id), name(name), contact(contact), type(type) {}
 
-bool User::saveToDatabase() {
+void User::writeUserRow() {
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-    
-    std::string sql = userID == 0 ?
-        "INSERT INTO Users (name, contact, type) VALUES (?, ?, ?);" :
-        "UPDATE Users SET name = ?, contact = ?, type = ? WHERE userID = ?;";
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return false;
+    if (userID == 0) {
+        userID = static_cast<int>(UsersTable::insert(db, name, contact, type));
+    } else {
+        UsersTable::update(db, userID, name, contact, type);
     }
-    
-    sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, contact.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, type.c_str(), -1, SQLITE_TRANSIENT);
-    
-    if (userID != 0) {
-        sqlite3_bind_int(stmt, 4, userID);
-    }
-    
-    bool success = sqlite3_step(stmt) == SQLITE_DONE;
-    if (success && userID == 0) {
-        userID = sqlite3_last_insert_rowid(db);
+}
+
+bool User::saveToDatabase() {
+    try {
+        writeUserRow();
+    } catch (const std::exception& e) {
+        std::cerr << "Error saving user: " << e.what() << std::endl;
+        return false;
     }
-    
-    sqlite3_finalize(stmt);
-    return success;
+
+    PeopleIndex::getInstance().upsert(userID, 0, type, name, contact);
+    return true;
 }
 
 User* User::getUserFromDatabase(int userID) {
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
-    sqlite3_stmt* stmt;
-    
-    std::string sql = "SELECT userID, name, contact, type FROM Users WHERE userID = ?;";
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return nullptr;
-    }
-    
-    sqlite3_bind_int(stmt, 1, userID);
-    
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        std::string contact = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        
-        sqlite3_finalize(stmt);
-        
+
+    try {
+        auto row = UsersTable::findByKey(db, userID);
+        if (!row) {
+            return nullptr;
+        }
+        auto& [id, name, contact, type] = *row;
         // Return a new User object (note: in practice you'd want to return derived classes)
         return new User(id, name, contact, type);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return nullptr;
     }
-    
-    sqlite3_finalize(stmt);
-    return nullptr;
 }
 
 std::vector<User*> User::getAllUsersFromDatabase() {
@@ -71,19 +52,13 @@ std::vector<User*> User::getAllUsersFromDatabase() {
     sqlite3* db = DatabaseHandler::getInstance().getDatabase();
     sqlite3_stmt* stmt;
     
-    std::string sql = "SELECT userID, name, contact, type FROM Users;";
-    
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, UsersTable::selectSql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
         return users;
     }
     
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        int id = sqlite3_column_int(stmt, 0);
-        std::string name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        std::string contact = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        std::string type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        
+        auto [id, name, contact, type] = UsersTable::decode(stmt);
         users.push_back(new User(id, name, contact, type));
     }
     
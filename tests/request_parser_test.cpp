@@ -0,0 +1,207 @@
+// Unit tests for JsonCursor and parseRequest. Self-contained so the target
+// builds without Crow: each CHECK prints the failing expression and the test
+// binary exits non-zero if any failed.
+#include "request_parser.h"
+#include <iostream>
+#include <string>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            failures++;                                                                   \
+        }                                                                                 \
+    } while (0)
+
+template <typename Request>
+static std::string errorFor(const std::string& body) {
+    Request out;
+    std::string error;
+    if (parseRequest(body, out, error)) return "";
+    return error;
+}
+
+static bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+static void testValidRequests() {
+    PatientRequest patient;
+    std::string error;
+    CHECK(parseRequest(R"({"name":"Ada","contact":"555-0100","age":36,"gender":"F"})", patient, error));
+    CHECK(patient.name == "Ada");
+    CHECK(patient.contact == "555-0100");
+    CHECK(patient.age == 36);
+    CHECK(patient.gender == "F");
+
+    // whitespace everywhere it is allowed, unknown fields of every type skipped
+    AppointmentRequest appointment;
+    CHECK(parseRequest(" {\n\t\"patient_id\" : 1 , \"extra\" : {\"a\":[1,2.5e3,{\"b\":null}],\"c\":true},"
+                       " \"doctor_id\":2,\"date\":\"2025-03-01\",\"time\":\"09:30\", \"note\": \"x\" }\r\n",
+                       appointment, error));
+    CHECK(appointment.patientID == 1);
+    CHECK(appointment.doctorID == 2);
+    CHECK(appointment.date == "2025-03-01");
+    CHECK(appointment.time == "09:30");
+
+    PrescriptionRequest prescription;
+    CHECK(parseRequest(R"({"patient_id":3,"medicine":"Ibuprofen","dosage":"200mg","override_interactions":true})",
+                       prescription, error));
+    CHECK(prescription.overrideInteractions);
+
+    // every field optional; only the ones present are set
+    AppointmentUpdate update;
+    CHECK(parseRequest(R"({"time":"10:00"})", update, error));
+    CHECK(!update.date);
+    CHECK(update.time && *update.time == "10:00");
+    AppointmentUpdate empty;
+    CHECK(parseRequest("{}", empty, error));
+    CHECK(!empty.date && !empty.time);
+}
+
+static void testMissingFields() {
+    CHECK(errorFor<PatientRequest>(R"({"name":"Ada","contact":"1","gender":"F"})") == "Missing required field 'age'");
+    CHECK(errorFor<RecordRequest>(R"({"patient_id":1,"doctor_id":2,"diagnosis":"x"})") ==
+          "Missing required field 'treatment'");
+    CHECK(errorFor<ReportRequest>("{}") == "Missing required field 'doctor_id'");
+    // a field that only appears nested in another value does not count
+    CHECK(errorFor<ReportRequest>(R"({"doctor_id":1,"other":{"details":"x"}})") ==
+          "Missing required field 'details'");
+    // override_interactions is optional
+    CHECK(errorFor<PrescriptionRequest>(R"({"patient_id":1,"medicine":"m","dosage":"d"})").empty());
+}
+
+static void testWrongTypes() {
+    CHECK(errorFor<PatientRequest>(R"({"name":"Ada","contact":"1","age":"36","gender":"F"})") ==
+          "Field 'age' must be an integer");
+    CHECK(errorFor<PatientRequest>(R"({"name":7,"contact":"1","age":36,"gender":"F"})") ==
+          "Field 'name' must be a string");
+    CHECK(errorFor<AppointmentRequest>(R"({"patient_id":1.5,"doctor_id":2,"date":"d","time":"t"})") ==
+          "Field 'patient_id' must be an integer");
+    CHECK(errorFor<AppointmentRequest>(R"({"patient_id":1e2,"doctor_id":2,"date":"d","time":"t"})") ==
+          "Field 'patient_id' must be an integer");
+    CHECK(errorFor<AppointmentRequest>(R"({"patient_id":null,"doctor_id":2,"date":"d","time":"t"})") ==
+          "Field 'patient_id' must be an integer");
+    CHECK(errorFor<PrescriptionRequest>(R"({"patient_id":1,"medicine":"m","dosage":"d","override_interactions":1})") ==
+          "Field 'override_interactions' must be true or false");
+    CHECK(errorFor<AppointmentUpdate>(R"({"date":["2025-03-01"]})") == "Field 'date' must be a string");
+    CHECK(contains(errorFor<PatientRequest>(R"(["Ada"])"), "Request body must be a JSON object"));
+}
+
+static void testIntegerRange() {
+    ReportRequest report;
+    std::string error;
+    CHECK(parseRequest(R"({"doctor_id":2147483647,"details":"x"})", report, error));
+    CHECK(report.doctorID == 2147483647);
+    CHECK(parseRequest(R"({"doctor_id":-2147483648,"details":"x"})", report, error));
+    CHECK(report.doctorID == -2147483647 - 1);
+    CHECK(parseRequest(R"({"doctor_id":-0,"details":"x"})", report, error));
+    CHECK(report.doctorID == 0);
+
+    CHECK(errorFor<ReportRequest>(R"({"doctor_id":2147483648,"details":"x"})") == "Field 'doctor_id' is out of range");
+    CHECK(errorFor<ReportRequest>(R"({"doctor_id":-2147483649,"details":"x"})") == "Field 'doctor_id' is out of range");
+    CHECK(errorFor<ReportRequest>(R"({"doctor_id":99999999999999999999999,"details":"x"})") ==
+          "Field 'doctor_id' is out of range");
+    CHECK(errorFor<ReportRequest>(R"({"doctor_id":-,"details":"x"})") == "Field 'doctor_id' must be an integer");
+}
+
+static void testEscapes() {
+    DoctorRequest doctor;
+    std::string error;
+    CHECK(parseRequest(R"({"name":"a\"b\\c\/d\b\f\n\r\t","contact":"A\u00e9\u20AC","specialization":"x"})",
+                       doctor, error));
+    CHECK(doctor.name == "a\"b\\c/d\b\f\n\r\t");
+    CHECK(doctor.contact == "A\xc3\xa9\xe2\x82\xac");
+
+    // surrogate pair -> one 4-byte UTF-8 sequence (U+1F600), either hex case
+    CHECK(parseRequest(R"({"name":"\ud83d\ude00","contact":"\uD83D\uDE00!","specialization":"x"})", doctor, error));
+    CHECK(doctor.name == "\xf0\x9f\x98\x80");
+    CHECK(doctor.contact == "\xf0\x9f\x98\x80!");
+
+    // raw UTF-8 passes through untouched
+    CHECK(parseRequest("{\"name\":\"Zo\xc3\xab\",\"contact\":\"c\",\"specialization\":\"x\"}", doctor, error));
+    CHECK(doctor.name == "Zo\xc3\xab");
+
+    CHECK(contains(errorFor<DoctorRequest>(R"({"name":"\ud83d","contact":"c","specialization":"x"})"),
+                   "Unpaired surrogate"));
+    CHECK(contains(errorFor<DoctorRequest>(R"({"name":"\ud83dx","contact":"c","specialization":"x"})"),
+                   "Unpaired surrogate"));
+    CHECK(contains(errorFor<DoctorRequest>(R"({"name":"\ud83d\u0041","contact":"c","specialization":"x"})"),
+                   "Unpaired surrogate"));
+    CHECK(contains(errorFor<DoctorRequest>(R"({"name":"\ude00","contact":"c","specialization":"x"})"),
+                   "Unpaired surrogate"));
+    CHECK(contains(errorFor<DoctorRequest>(R"({"name":"\u12G4","contact":"c","specialization":"x"})"),
+                   "Bad \\u escape"));
+    CHECK(contains(errorFor<DoctorRequest>(R"({"name":"\x","contact":"c","specialization":"x"})"),
+                   "Bad escape in string"));
+    CHECK(contains(errorFor<DoctorRequest>("{\"name\":\"a\nb\",\"contact\":\"c\",\"specialization\":\"x\"}"),
+                   "Control character in string"));
+    CHECK(contains(errorFor<DoctorRequest>(R"({"name":"abc)"), "Unterminated string"));
+}
+
+static void testSyntaxAndTrailingData() {
+    const std::string valid = R"({"doctor_id":1,"details":"x"})";
+    CHECK(errorFor<ReportRequest>(valid).empty());
+    CHECK(errorFor<ReportRequest>(valid + " \n").empty());
+
+    CHECK(errorFor<ReportRequest>(valid + "x") == "Invalid JSON: Unexpected data after the JSON object at offset 29");
+    CHECK(contains(errorFor<ReportRequest>(valid + valid), "Unexpected data after the JSON object"));
+    CHECK(contains(errorFor<ReportRequest>(valid + ","), "Unexpected data after the JSON object"));
+    CHECK(contains(errorFor<ReportRequest>(""), "Request body must be a JSON object"));
+    CHECK(contains(errorFor<ReportRequest>(R"({"doctor_id":1,"details":"x")"), "Expected ',' or '}'"));
+    CHECK(contains(errorFor<ReportRequest>(R"({"doctor_id":1,})"), "Expected a field name"));
+    CHECK(contains(errorFor<ReportRequest>(R"({"doctor_id" 1})"), "Expected ':'"));
+    CHECK(contains(errorFor<ReportRequest>(R"({"doctor_id":1x,"details":"x"})"), "Expected ',' or '}'"));
+    CHECK(contains(errorFor<ReportRequest>(R"({"doctor_id":1,"skip":[1,2})"), "Expected ',' or ']'"));
+    CHECK(contains(errorFor<ReportRequest>(R"({"doctor_id":1,"skip":nul})"), "Unexpected character"));
+
+    std::string deep = R"({"doctor_id":1,"details":"x","skip":)" + std::string(100, '[') + std::string(100, ']') + "}";
+    CHECK(contains(errorFor<ReportRequest>(deep), "Nesting is too deep"));
+}
+
+static void testCursorDirectly() {
+    // fields arrive in document order and the callback can stop the walk
+    std::string body = R"({"a":"1","b":2,"c":false})";
+    JsonCursor cursor(body);
+    std::string seen;
+    std::string text;
+    int number = 0;
+    bool flag = true;
+    CHECK(cursor.object([&](std::string_view key) {
+        seen += std::string(key);
+        if (key == "a") return cursor.string(text, "a");
+        if (key == "b") return cursor.integer(number, "b");
+        return cursor.boolean(flag, "c");
+    }));
+    CHECK(seen == "abc");
+    CHECK(text == "1" && number == 2 && !flag);
+
+    std::string twoFields = R"({"a":1,"b":2})";
+    JsonCursor stopping(twoFields);
+    int calls = 0;
+    CHECK(!stopping.object([&](std::string_view) {
+        calls++;
+        return stopping.fieldError("stop");
+    }));
+    CHECK(calls == 1);
+    CHECK(stopping.getError() == "stop");
+}
+
+int main() {
+    testValidRequests();
+    testMissingFields();
+    testWrongTypes();
+    testIntegerRange();
+    testEscapes();
+    testSyntaxAndTrailingData();
+    testCursorDirectly();
+
+    if (failures) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "request_parser_test: all checks passed" << std::endl;
+    return 0;
+}
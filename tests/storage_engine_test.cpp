@@ -0,0 +1,203 @@
+// Runs the same checks and the same benchmark workload against the SQLite
+// and in-memory storage engines. The SQLite engine uses a scratch file with
+// the full schema from db_seed.h; each CHECK prints the failing expression
+// and the test binary exits non-zero if any failed.
+#include "db_seed.h"
+#include "memory_storage_engine.h"
+#include "sqlite_storage_engine.h"
+#include "storage_benchmark.h"
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            failures++;                                                                   \
+        }                                                                                 \
+    } while (0)
+
+static const std::string kPath = "storage_engine_test.db";
+
+static void removeScratch() {
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((kPath + suffix).c_str());
+    }
+}
+
+// Children first, so the foreign keys allow it.
+static void clear(DatabaseHandler& dbHandler) {
+    for (const char* name : {"Reports", "Prescriptions", "MedicalRecords", "Appointments", "Doctors", "Patients",
+                             "Users"}) {
+        dbHandler.execute(std::string("DELETE FROM ") + name + ";");
+    }
+}
+
+template <typename Repo, typename Work>
+static bool throwsInvalidArgument(Repo& repository, Work work) {
+    try {
+        work(repository);
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+static void testRepositories(StorageEngine& engine) {
+    std::cerr << "repositories: " << engine.name() << '\n';
+
+    int doctorUser = engine.users().insert({0, "Dr. Grey", "grey@hospital.com", "doctor"});
+    int patientUser = engine.users().insert({0, "Ada", "ada@example.com", "patient"});
+    int otherUser = engine.users().insert({0, "Bob", "bob@example.com", "patient"});
+    CHECK(doctorUser > 0 && patientUser > doctorUser && otherUser > patientUser);
+
+    int doctorID = engine.doctors().insert({0, doctorUser, "Cardiology"});
+    int patientID = engine.patients().insert({0, patientUser, 36, "F"});
+    int otherID = engine.patients().insert({0, otherUser, 52, "M"});
+    CHECK(engine.doctors().where<"specialization">(std::string("Cardiology")).size() == 1);
+    CHECK(engine.users().where<"type">(std::string("patient")).size() == 2);
+
+    // empty status and created_at get the schema defaults
+    int first = engine.appointments().insert({0, patientID, doctorID, "2025-03-02", "09:00", "", "Checkup", ""});
+    int second = engine.appointments().insert({0, patientID, doctorID, "2025-03-01", "10:30", "completed", "", ""});
+    int third = engine.appointments().insert({0, otherID, doctorID, "2025-03-09", "11:00", "", "", ""});
+    auto stored = engine.appointments().find(first);
+    CHECK(stored.has_value());
+    CHECK(std::get<5>(*stored) == "scheduled");
+    CHECK(std::get<6>(*stored) == "Checkup");
+    CHECK(std::get<7>(*stored).size() == 19);
+    CHECK(std::get<5>(*engine.appointments().find(second)) == "completed");
+
+    auto byPatient = engine.appointments().where<"patientID">(patientID);
+    CHECK(byPatient.size() == 2);
+    CHECK(!byPatient.empty() && std::get<0>(byPatient.front()) == first);
+
+    auto week = engine.appointments().between<"date">("2025-03-01", "2025-03-07");
+    CHECK(week.size() == 2);
+    CHECK(week.size() == 2 && std::get<0>(week[0]) == second && std::get<0>(week[1]) == first);
+    CHECK(engine.appointments().where<"status">(std::string("scheduled")).size() == 2);
+
+    // an update moves the row between index entries
+    auto moved = *engine.appointments().find(third);
+    std::get<1>(moved) = patientID;
+    std::get<3>(moved) = "2025-03-03";
+    std::get<5>(moved) = "cancelled";
+    CHECK(engine.appointments().update(moved));
+    CHECK(engine.appointments().where<"patientID">(otherID).empty());
+    CHECK(engine.appointments().where<"patientID">(patientID).size() == 3);
+    CHECK(engine.appointments().between<"date">("2025-03-08", "2025-03-31").empty());
+    CHECK(engine.appointments().where<"status">(std::string("cancelled")).size() == 1);
+
+    auto missing = moved;
+    std::get<0>(missing) = third + 1000;
+    CHECK(!engine.appointments().update(missing));
+    CHECK(engine.appointments().remove(third));
+    CHECK(!engine.appointments().remove(third));
+    CHECK(!engine.appointments().find(third).has_value());
+    CHECK(engine.appointments().count() == 2);
+
+    CHECK(throwsInvalidArgument(engine.appointments(), [](AppointmentRepository& repository) {
+        repository.findEqual(AppointmentsFullTable::indexOf<"date">(), 7);
+    }));
+    CHECK(throwsInvalidArgument(engine.appointments(), [](AppointmentRepository& repository) {
+        repository.findRange(AppointmentsFullTable::indexOf<"patientID">(), "1", "2");
+    }));
+
+    bool duplicateRejected = false;
+    try {
+        engine.users().insert({doctorUser, "Someone", "x", "admin"});
+    } catch (const std::runtime_error&) {
+        duplicateRejected = true;
+    }
+    CHECK(duplicateRejected);
+
+    int record = engine.records().insert({0, patientID, doctorID, "Hypertension", "Diet", "2025-03-02", ""});
+    engine.prescriptions().insert({0, doctorID, patientID, "Lisinopril", "10mg daily", "2025-03-02"});
+    engine.reports().insert({0, doctorID, "Monthly report", ""});
+    CHECK(engine.records().where<"doctorID">(doctorID).size() == 1);
+    CHECK(std::get<6>(*engine.records().find(record)).size() == 19);
+    CHECK(engine.prescriptions().where<"patientID">(patientID).size() == 1);
+    CHECK(engine.reports().where<"doctorID">(doctorID).size() == 1);
+}
+
+template <typename TableT>
+static bool sameRows(Repository<TableT>& left, Repository<TableT>& right) {
+    return left.all() == right.all();
+}
+
+static bool sameContents(StorageEngine& left, StorageEngine& right) {
+    return sameRows(left.users(), right.users()) && sameRows(left.patients(), right.patients()) &&
+           sameRows(left.doctors(), right.doctors()) && sameRows(left.appointments(), right.appointments()) &&
+           sameRows(left.records(), right.records()) && sameRows(left.prescriptions(), right.prescriptions()) &&
+           sameRows(left.reports(), right.reports());
+}
+
+// memory -> database file -> memory keeps every column, keys included
+static void testSnapshot(DatabaseHandler& dbHandler) {
+    MemoryStorageEngine original;
+    testRepositories(original);
+
+    SqliteStorageEngine snapshot(dbHandler.getDatabase());
+    snapshot.copyFrom(original);
+    CHECK(sameContents(original, snapshot));
+
+    MemoryStorageEngine restored;
+    restored.copyFrom(snapshot);
+    CHECK(sameContents(original, restored));
+}
+
+static void testBenchmarkWorkload(DatabaseHandler& dbHandler) {
+    StorageWorkload workload;
+    workload.patients = 100;
+    workload.doctors = 10;
+    workload.appointments = 1000;
+    workload.records = 500;
+    workload.prescriptions = 500;
+    workload.lookups = 400;
+    workload.writes = 100;
+    workload.readerThreads = 2;
+
+    MemoryStorageEngine memory;
+    SqliteStorageEngine sqlite(dbHandler.getDatabase());
+    StorageBenchmarkResult inMemory = StorageBenchmark::run(memory, workload);
+    StorageBenchmarkResult onDisk = StorageBenchmark::run(sqlite, workload);
+
+    CHECK(inMemory.phases.size() == onDisk.phases.size());
+    for (size_t i = 0; i < inMemory.phases.size() && i < onDisk.phases.size(); i++) {
+        if (inMemory.phases[i].rows != onDisk.phases[i].rows) {
+            std::cerr << "phase " << inMemory.phases[i].phase << ": " << inMemory.phases[i].rows << " vs "
+                      << onDisk.phases[i].rows << " rows\n";
+            failures++;
+        }
+    }
+    CHECK(memory.appointments().count() == sqlite.appointments().count());
+}
+
+int main() {
+    removeScratch();
+    DatabaseHandler& dbHandler = DatabaseHandler::getInstance(kPath);
+    initializeDatabaseSchema(dbHandler);
+
+    MemoryStorageEngine memory;
+    testRepositories(memory);
+    SqliteStorageEngine sqlite(dbHandler.getDatabase());
+    testRepositories(sqlite);
+
+    clear(dbHandler);
+    testSnapshot(dbHandler);
+
+    clear(dbHandler);
+    testBenchmarkWorkload(dbHandler);
+
+    removeScratch();
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "storage_engine_test: all checks passed\n";
+    return 0;
+}